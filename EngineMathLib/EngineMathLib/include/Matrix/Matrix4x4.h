@@ -27,26 +27,24 @@
  * SOFTWARE.
 */
 #pragma once
+#include <cstddef>
+#include "Matrix4x4Kernels.h"
+#include "Utilities/EngineMath.h"
+
 namespace EngineUtilities {
   /**
  * @brief A 4x4 matrix class.
  *
  * This class represents a 4x4 matrix and provides basic matrix operations such as
  * addition, subtraction, multiplication, determinant calculation, and inversion.
+ *
+ * Rows are 16-byte aligned and contiguous, so products run on SIMD registers
+ * (see Matrix4x4Kernels.h).
  */
-  class Matrix4x4 {
+  class alignas(16) Matrix4x4 {
   public:
     float m[4][4]; /**< The elements of the matrix. */
 
-    // Default constructor initializes to identity matrix
-    Matrix4x4() {
-      for (int i = 0; i < 4; ++i) {
-        for (int j = 0; j < 4; ++j) {
-          m[i][j] = (i == j) ? 1.0f : 0.0f;
-        }
-      }
-    }
-
     /**
      * @brief Default constructor.
      *
@@ -92,14 +90,8 @@ namespace EngineUtilities {
       m[3][0] = a41; m[3][1] = a42; m[3][2] = a43; m[3][3] = a44;
     }
 
-    // Copy constructor
-    Matrix4x4(const Matrix4x4& other) {
-      for (int i = 0; i < 4; ++i) {
-        for (int j = 0; j < 4; ++j) {
-          m[i][j] = other.m[i][j];
-        }
-      }
-    }
+    // Copy constructor (trivial, so arrays of matrices can be relocated with memcpy)
+    Matrix4x4(const Matrix4x4& other) = default;
 
     /**
      * @brief Adds another matrix to this matrix.
@@ -138,26 +130,75 @@ namespace EngineUtilities {
      * @return The result of the multiplication.
      */
     Matrix4x4 operator*(const Matrix4x4& other) const {
+      Matrix4x4 result;
+      multiplyMatrix4x4(&m[0][0], &other.m[0][0], &result.m[0][0]);
+      return result;
+    }
+
+    /**
+     * @brief Multiplies n pairs of matrices: out[i] = a[i] * b[i].
+     *
+     * Uses the AVX2/FMA kernel when the running CPU supports it (detected once) and the
+     * SSE/NEON kernel otherwise. out may alias a or b.
+     *
+     * @param a The left matrices.
+     * @param b The right matrices.
+     * @param out Receives the n products.
+     * @param n The number of products.
+     */
+    static void MultiplyMany(const Matrix4x4* a, const Matrix4x4* b, Matrix4x4* out, size_t n) {
+      selectMultiplyManyMatrix4x4()(reinterpret_cast<const float*>(a), reinterpret_cast<const float*>(b),
+        reinterpret_cast<float*>(out), n);
+    }
+
+    /**
+     * @brief Builds a rotation about the X axis.
+     *
+     * @param angle The angle of rotation in radians.
+     * @return The rotation matrix.
+     */
+    static Matrix4x4 rotationX(float angle) {
+      float s, c;
+      EngineUtilities::sincos(angle, s, c);
+      return Matrix4x4(
+        1, 0, 0, 0,
+        0, c, -s, 0,
+        0, s, c, 0,
+        0, 0, 0, 1
+      );
+    }
+
+    /**
+     * @brief Builds a rotation about the Y axis.
+     *
+     * @param angle The angle of rotation in radians.
+     * @return The rotation matrix.
+     */
+    static Matrix4x4 rotationY(float angle) {
+      float s, c;
+      EngineUtilities::sincos(angle, s, c);
       return Matrix4x4(
-        m[0][0] * other.m[0][0] + m[0][1] * other.m[1][0] + m[0][2] * other.m[2][0] + m[0][3] * other.m[3][0],
-        m[0][0] * other.m[0][1] + m[0][1] * other.m[1][1] + m[0][2] * other.m[2][1] + m[0][3] * other.m[3][1],
-        m[0][0] * other.m[0][2] + m[0][1] * other.m[1][2] + m[0][2] * other.m[2][2] + m[0][3] * other.m[3][2],
-        m[0][0] * other.m[0][3] + m[0][1] * other.m[1][3] + m[0][2] * other.m[2][3] + m[0][3] * other.m[3][3],
-
-        m[1][0] * other.m[0][0] + m[1][1] * other.m[1][0] + m[1][2] * other.m[2][0] + m[1][3] * other.m[3][0],
-        m[1][0] * other.m[0][1] + m[1][1] * other.m[1][1] + m[1][2] * other.m[2][1] + m[1][3] * other.m[3][1],
-        m[1][0] * other.m[0][2] + m[1][1] * other.m[1][2] + m[1][2] * other.m[2][2] + m[1][3] * other.m[3][2],
-        m[1][0] * other.m[0][3] + m[1][1] * other.m[1][3] + m[1][2] * other.m[2][3] + m[1][3] * other.m[3][3],
-
-        m[2][0] * other.m[0][0] + m[2][1] * other.m[1][0] + m[2][2] * other.m[2][0] + m[2][3] * other.m[3][0],
-        m[2][0] * other.m[0][1] + m[2][1] * other.m[1][1] + m[2][2] * other.m[2][1] + m[2][3] * other.m[3][1],
-        m[2][0] * other.m[0][2] + m[2][1] * other.m[1][2] + m[2][2] * other.m[2][2] + m[2][3] * other.m[3][2],
-        m[2][0] * other.m[0][3] + m[2][1] * other.m[1][3] + m[2][2] * other.m[2][3] + m[2][3] * other.m[3][3],
-
-        m[3][0] * other.m[0][0] + m[3][1] * other.m[1][0] + m[3][2] * other.m[2][0] + m[3][3] * other.m[3][0],
-        m[3][0] * other.m[0][1] + m[3][1] * other.m[1][1] + m[3][2] * other.m[2][1] + m[3][3] * other.m[3][1],
-        m[3][0] * other.m[0][2] + m[3][1] * other.m[1][2] + m[3][2] * other.m[2][2] + m[3][3] * other.m[3][2],
-        m[3][0] * other.m[0][3] + m[3][1] * other.m[1][3] + m[3][2] * other.m[2][3] + m[3][3] * other.m[3][3]
+        c, 0, s, 0,
+        0, 1, 0, 0,
+        -s, 0, c, 0,
+        0, 0, 0, 1
+      );
+    }
+
+    /**
+     * @brief Builds a rotation about the Z axis.
+     *
+     * @param angle The angle of rotation in radians.
+     * @return The rotation matrix.
+     */
+    static Matrix4x4 rotationZ(float angle) {
+      float s, c;
+      EngineUtilities::sincos(angle, s, c);
+      return Matrix4x4(
+        c, -s, 0, 0,
+        s, c, 0, 0,
+        0, 0, 1, 0,
+        0, 0, 0, 1
       );
     }
 
@@ -193,60 +234,51 @@ namespace EngineUtilities {
     /**
      * @brief Computes the inverse of the matrix.
      *
-     * @return The inverse of the matrix.
+     * General inverse from 2x2 block cofactors, evaluated in SIMD registers.
+     *
+     * @return The inverse of the matrix, or the identity if the matrix is singular.
+     */
+    Matrix4x4 inverse() const {
+      Matrix4x4 result;
+      inverseMatrix4x4(&m[0][0], &result.m[0][0]);
+      return result;
+    }
+
+    /**
+     * @brief Computes the inverse of an affine transform.
+     *
+     * The last row must be (0, 0, 0, 1). The upper 3x3 block may hold any rotation, scale
+     * and shear. The inverse is [A^-1, -A^-1 t; 0 0 0 1]. A^-1 comes from three cross
+     * products, which is much cheaper than the general inverse.
+     *
+     * @return The inverse transform, or the identity if the 3x3 block is singular.
+     */
+    Matrix4x4 InverseAffine() const {
+      Matrix4x4 result;
+      inverseAffineMatrix4x4(&m[0][0], &result.m[0][0]);
+      return result;
+    }
+
+    /**
+     * @brief Computes the inverse of a rigid transform (rotation plus translation).
+     *
+     * The upper 3x3 block must be orthonormal and the last row (0, 0, 0, 1). The
+     * inverse is the transposed rotation with the translation rotated back and negated.
+     *
+     * @return The inverse transform.
      */
-    
-    //Matrix4x4 inverse() const {
-    //  float det = determinant();
-    //  if (det == 0) {
-    //    // Return identity matrix for simplicity when the matrix is singular.
-    //    return Matrix4x4();
-    //  }
-
-    //  float invDet = 1.0f / det;
-
-    //  return Matrix4x4(
-    //    (m[1][1] * (m[2][2] * m[3][3] - m[2][3] * m[3][2]) -
-    //      m[1][2] * (m[2][1] * m[3][3] - m[2][3] * m[3][1]) +
-    //      m[1][3] * (m[2][1] * m[3][2] - m[2][2] * m[3][1])) * invDet,
-    //    -(m[0][1] * (m[2][2] * m[3][3] - m[2][3] * m[3][2]) -
-    //      m[0][2] * (m[2][1] * m[3][3] - m[2][3] * m[3][1]) +
-    //      m[0][3] * (m[2][1] * m[3][2] - m[2][2] * m[3][1])) * invDet,
-    //    (m[0][1] * (m[1][2] * m[3][3] - m[1][3] * m[3][2]) -
-    //      m[0][2] * (m[1][1] * m[3][3] - m[1][3] * m[3][1]) +
-    //      m[0][3] * (m[1][1] * m[3][2] - m[1][2] * m[3][1])) * invDet,
-    //    -(m[0][1] * (m[1][2] * m[2][3] - m[1][3] * m[2][2]) -
-    //      m[0][2] * (m[1][1] * m[2][3] - m[1][3] * m[2][1]) +
-    //      m[0][3] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])) * invDet,
-
-    //    -(m[1][0] * (m[2][2] * m[3][3] - m[2][3] * m[3][2]) -
-    //      m[1][2] * (m[2][0] * m[3][3] - m[2][3] * m[3][0]) +
-    //      m[1][3] * (m[2][0] * m[3][2] - m[2][2] * m[3][0])) * invDet,
-    //    (m[0][0] * (m[2][2] * m[3][3] - m[2][3] * m[3][2]) -
-    //      m[0][2] * (m[2][0] * m[3][3] - m[2][3] * m[3][0]) +
-    //      m[0][3] * (m[2][0] * m[3][2] - m[2][2] * m[3][0])) * invDet,
-    //    -(m[0][0] * (m[1][2] * m[3][3] - m[1][3] * m[3][2]) -
-    //      m[0][2] * (m[1][0] * m[3][3] - m[1][3] * m[3][0]) +
-    //      m[0][3] * (m[1][0] * m[3][2] - m[1][2] * m[3][0])) * invDet,
-    //    (m[0][0] * (m[1][2] * m[2][3] - m[1][3] * m[2][2]) -
-    //      m[0][2] * (m[1][0] * m[2][3] - m[1][3] * m[2][0]) +
-    //      m[0][3] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])) * invDet,
-
-    //    (m[1][0] * (m[2][1] * m[3][3] - m[2][3] * m[3][1]) -
-    //      m[1][1] * (m[2][0] * m[3][3] - m[2][3] * m[3][0]) +
-    //      m[1][3] * (m[2][0] * m[3][1] - m[2][1] * m[3][0])) * invDet,
-    //    -(m[0][0] * (m[2][1] * m[3][3] - m[2][3] * m[3][1]) -
-    //      m[0][1] * (m[2][0] * m[3][3] - m[2][3] * m[3][0]) +
-    //      m[0][3] * (m[2][0] * m[3][1] - m[2][1] * m[3][0])) * invDet,
-    //    (m[0][0] * (m[1][1] * m[3][3] - m[1][3] * m[3][1]) -
-    //      m[0][1] * (m[1][0] * m[3][3] - m[1][3] * m[3][0]) +
-    //      m[0][3] * (m[1][0] * m[3][1] - m[1][1] * m[3][0])) * invDet,
-    //    -(m[0][0] * (m[1][1] * m[2][3] - m[1][3] * m[2][1]) -
-    //      m[0][1] * (m[1][0] * m[2][3] - m[1][3] * m[2][0]) +
-    //      m[0][3] * (m[1][0] * m[2][1] - m[1][1] * m[2][0])) * invDet
-    //  );
-    //}
+    Matrix4x4 InverseOrthonormal() const {
+      float tx = m[0][3], ty = m[1][3], tz = m[2][3];
+      return Matrix4x4(
+        m[0][0], m[1][0], m[2][0], -(m[0][0] * tx + m[1][0] * ty + m[2][0] * tz),
+        m[0][1], m[1][1], m[2][1], -(m[0][1] * tx + m[1][1] * ty + m[2][1] * tz),
+        m[0][2], m[1][2], m[2][2], -(m[0][2] * tx + m[1][2] * ty + m[2][2] * tz),
+        0, 0, 0, 1
+      );
+    }
 
 
   };
+
+  static_assert(sizeof(Matrix4x4) == 16 * sizeof(float), "Matrix4x4 kernels expect 16 packed floats");
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include "Utilities/CPUFeatures.h"
+#include "Utilities/VectorRegister.h"
+
+#if ENGINEUTILITIES_X86 && ENGINEUTILITIES_SIMD_SSE
+#define ENGINEUTILITIES_MATRIX_AVX2 1
+#include <immintrin.h>
+#else
+#define ENGINEUTILITIES_MATRIX_AVX2 0
+#endif
+
+namespace EngineUtilities {
+  /**
+   * @brief Multiplies two row-major 4x4 matrices with one register per row.
+   *
+   * Each output row is a linear combination of the rows of b, weighted by the
+   * broadcast elements of the matching row of a. All three pointers must be 16-byte
+   * aligned. out may alias a or b.
+   *
+   * @param a The left matrix (16 floats).
+   * @param b The right matrix (16 floats).
+   * @param out Receives a * b (16 floats).
+   */
+  inline void multiplyMatrix4x4(const float* a, const float* b, float* out) {
+    VectorRegister b0 = vectorLoadAligned(b);
+    VectorRegister b1 = vectorLoadAligned(b + 4);
+    VectorRegister b2 = vectorLoadAligned(b + 8);
+    VectorRegister b3 = vectorLoadAligned(b + 12);
+    VectorRegister rows[4];
+    for (int i = 0; i < 4; ++i) {
+      VectorRegister row = vectorLoadAligned(a + 4 * i);
+      VectorRegister result = vectorMultiply(vectorSwizzle<0, 0, 0, 0>(row), b0);
+      result = vectorMultiplyAdd(vectorSwizzle<1, 1, 1, 1>(row), b1, result);
+      result = vectorMultiplyAdd(vectorSwizzle<2, 2, 2, 2>(row), b2, result);
+      rows[i] = vectorMultiplyAdd(vectorSwizzle<3, 3, 3, 3>(row), b3, result);
+    }
+    for (int i = 0; i < 4; ++i) {
+      vectorStoreAligned(out + 4 * i, rows[i]);
+    }
+  }
+
+  /**
+   * @brief Multiplies n pairs of matrices: out[i] = a[i] * b[i].
+   *
+   * Same layout and alignment requirements as multiplyMatrix4x4, with 16 floats per matrix.
+   */
+  inline void multiplyManyMatrix4x4Generic(const float* a, const float* b, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      multiplyMatrix4x4(a + 16 * i, b + 16 * i, out + 16 * i);
+    }
+  }
+
+#if ENGINEUTILITIES_MATRIX_AVX2
+  /**
+   * @brief AVX2/FMA version of multiplyMatrix4x4 that computes two rows per register.
+   *
+   * Each row of b is copied into both 128-bit halves. The in-lane shuffle then
+   * broadcasts a[i][k] and a[i + 1][k] at the same time. Only call it when
+   * cpuFeatures() reports avx2 and fma.
+   */
+  ENGINEUTILITIES_TARGET_AVX2 inline void multiplyMatrix4x4AVX2(const float* a, const float* b, float* out) {
+    __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b));
+    __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+    __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+    __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+    __m256 a01 = _mm256_loadu_ps(a);
+    __m256 a23 = _mm256_loadu_ps(a + 8);
+
+    __m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+    __m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0);
+    r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1, r01);
+    r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1, r23);
+    r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2, r01);
+    r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xAA), b2, r23);
+    r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3, r01);
+    r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xFF), b3, r23);
+
+    _mm256_storeu_ps(out, r01);
+    _mm256_storeu_ps(out + 8, r23);
+  }
+
+  /**
+   * @brief AVX2/FMA version of multiplyManyMatrix4x4Generic.
+   */
+  ENGINEUTILITIES_TARGET_AVX2 inline void multiplyManyMatrix4x4AVX2(const float* a, const float* b, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      multiplyMatrix4x4AVX2(a + 16 * i, b + 16 * i, out + 16 * i);
+    }
+  }
+#endif
+
+  /**
+   * @brief Product of two 2x2 matrices stored row-major in one register: a * b.
+   */
+  inline VectorRegister multiplyMatrix2x2(VectorRegister a, VectorRegister b) {
+    return vectorAdd(vectorMultiply(a, vectorSwizzle<0, 3, 0, 3>(b)),
+      vectorMultiply(vectorSwizzle<1, 0, 3, 2>(a), vectorSwizzle<2, 1, 2, 1>(b)));
+  }
+
+  /**
+   * @brief Adjugate of a times b, for 2x2 matrices stored row-major in one register.
+   */
+  inline VectorRegister adjugateMultiplyMatrix2x2(VectorRegister a, VectorRegister b) {
+    return vectorSubtract(vectorMultiply(vectorSwizzle<3, 3, 0, 0>(a), b),
+      vectorMultiply(vectorSwizzle<1, 1, 2, 2>(a), vectorSwizzle<2, 3, 0, 1>(b)));
+  }
+
+  /**
+   * @brief a times the adjugate of b, for 2x2 matrices stored row-major in one register.
+   */
+  inline VectorRegister multiplyAdjugateMatrix2x2(VectorRegister a, VectorRegister b) {
+    return vectorSubtract(vectorMultiply(a, vectorSwizzle<3, 0, 3, 0>(b)),
+      vectorMultiply(vectorSwizzle<1, 0, 3, 2>(a), vectorSwizzle<2, 1, 2, 1>(b)));
+  }
+
+  /**
+   * @brief Inverts a row-major 4x4 matrix with 2x2 block cofactors.
+   *
+   * The matrix is split into the 2x2 blocks [A B; C D]. The adjugate of each block and
+   * the determinant come from a few 2x2 products, all in registers. Both pointers must
+   * be 16-byte aligned. out may alias m.
+   *
+   * @param m The matrix to invert (16 floats).
+   * @param out Receives the inverse. It is left untouched when the matrix is singular.
+   * @return The determinant of m. A value of 0 means the matrix has no inverse.
+   */
+  inline float inverseMatrix4x4(const float* m, float* out) {
+    VectorRegister row0 = vectorLoadAligned(m);
+    VectorRegister row1 = vectorLoadAligned(m + 4);
+    VectorRegister row2 = vectorLoadAligned(m + 8);
+    VectorRegister row3 = vectorLoadAligned(m + 12);
+
+    VectorRegister a = vectorShuffle<0, 1, 0, 1>(row0, row1);
+    VectorRegister b = vectorShuffle<2, 3, 2, 3>(row0, row1);
+    VectorRegister c = vectorShuffle<0, 1, 0, 1>(row2, row3);
+    VectorRegister d = vectorShuffle<2, 3, 2, 3>(row2, row3);
+
+    // Block determinants (|A|, |B|, |C|, |D|).
+    VectorRegister blockDet = vectorSubtract(
+      vectorMultiply(vectorShuffle<0, 2, 0, 2>(row0, row2), vectorShuffle<1, 3, 1, 3>(row1, row3)),
+      vectorMultiply(vectorShuffle<1, 3, 1, 3>(row0, row2), vectorShuffle<0, 2, 0, 2>(row1, row3)));
+    VectorRegister detA = vectorSwizzle<0, 0, 0, 0>(blockDet);
+    VectorRegister detB = vectorSwizzle<1, 1, 1, 1>(blockDet);
+    VectorRegister detC = vectorSwizzle<2, 2, 2, 2>(blockDet);
+    VectorRegister detD = vectorSwizzle<3, 3, 3, 3>(blockDet);
+
+    VectorRegister dc = adjugateMultiplyMatrix2x2(d, c);
+    VectorRegister ab = adjugateMultiplyMatrix2x2(a, b);
+
+    // Adjugates of the four blocks of the inverse, before the final sign and transpose.
+    VectorRegister x = vectorSubtract(vectorMultiply(detD, a), multiplyMatrix2x2(b, dc));
+    VectorRegister w = vectorSubtract(vectorMultiply(detA, d), multiplyMatrix2x2(c, ab));
+    VectorRegister y = vectorSubtract(vectorMultiply(detB, c), multiplyAdjugateMatrix2x2(d, ab));
+    VectorRegister z = vectorSubtract(vectorMultiply(detC, b), multiplyAdjugateMatrix2x2(a, dc));
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    float det = vectorGetX(detA) * vectorGetX(detD) + vectorGetX(detB) * vectorGetX(detC) -
+      vectorGetX(vectorDot4(ab, vectorSwizzle<0, 2, 1, 3>(dc)));
+    if (det == 0.0f) {
+      return det;
+    }
+
+    VectorRegister invDet = vectorMultiply(vectorSet(1, -1, -1, 1), vectorReplicate(1.0f / det));
+    x = vectorMultiply(x, invDet);
+    y = vectorMultiply(y, invDet);
+    z = vectorMultiply(z, invDet);
+    w = vectorMultiply(w, invDet);
+
+    vectorStoreAligned(out, vectorShuffle<3, 1, 3, 1>(x, y));
+    vectorStoreAligned(out + 4, vectorShuffle<2, 0, 2, 0>(x, y));
+    vectorStoreAligned(out + 8, vectorShuffle<3, 1, 3, 1>(z, w));
+    vectorStoreAligned(out + 12, vectorShuffle<2, 0, 2, 0>(z, w));
+    return det;
+  }
+
+  /**
+   * @brief Cross product of the xyz lanes of two registers. Lane w is 0.
+   */
+  inline VectorRegister crossVector3(VectorRegister a, VectorRegister b) {
+    return vectorSubtract(vectorMultiply(vectorSwizzle<1, 2, 0, 3>(a), vectorSwizzle<2, 0, 1, 3>(b)),
+      vectorMultiply(vectorSwizzle<2, 0, 1, 3>(a), vectorSwizzle<1, 2, 0, 3>(b)));
+  }
+
+  /**
+   * @brief Inverts a row-major affine transform whose last row is (0, 0, 0, 1).
+   *
+   * The cross products of the rows of the 3x3 block are the columns of its adjugate.
+   * One transpose turns them into rows, and the translation column is -A^-1 t. Both
+   * pointers must be 16-byte aligned. out may alias m.
+   *
+   * @param m The transform to invert (16 floats).
+   * @param out Receives the inverse. It is left untouched when the 3x3 block is singular.
+   * @return The determinant of the 3x3 block. A value of 0 means there is no inverse.
+   */
+  inline float inverseAffineMatrix4x4(const float* m, float* out) {
+    VectorRegister row0 = vectorLoadAligned(m);
+    VectorRegister row1 = vectorLoadAligned(m + 4);
+    VectorRegister row2 = vectorLoadAligned(m + 8);
+
+    VectorRegister col0 = crossVector3(row1, row2);
+    VectorRegister col1 = crossVector3(row2, row0);
+    VectorRegister col2 = crossVector3(row0, row1);
+    float det = vectorGetX(vectorDot4(row0, col0)); // Lane w of col0 is 0, so tx drops out.
+    if (det == 0.0f) {
+      return det;
+    }
+
+    // -adj(A) * t, from the translation column (lane w of each row).
+    VectorRegister translation = vectorMultiply(vectorSwizzle<3, 3, 3, 3>(row0), col0);
+    translation = vectorMultiplyAdd(vectorSwizzle<3, 3, 3, 3>(row1), col1, translation);
+    translation = vectorMultiplyAdd(vectorSwizzle<3, 3, 3, 3>(row2), col2, translation);
+    translation = vectorMultiply(translation, vectorReplicate(-1.0f));
+
+    // Transpose [col0; col1; col2; translation] into the three rows of the inverse.
+    VectorRegister invDet = vectorReplicate(1.0f / det);
+    VectorRegister t0 = vectorShuffle<0, 1, 0, 1>(col0, col1);
+    VectorRegister t1 = vectorShuffle<2, 3, 2, 3>(col0, col1);
+    VectorRegister t2 = vectorShuffle<0, 1, 0, 1>(col2, translation);
+    VectorRegister t3 = vectorShuffle<2, 3, 2, 3>(col2, translation);
+    vectorStoreAligned(out, vectorMultiply(vectorShuffle<0, 2, 0, 2>(t0, t2), invDet));
+    vectorStoreAligned(out + 4, vectorMultiply(vectorShuffle<1, 3, 1, 3>(t0, t2), invDet));
+    vectorStoreAligned(out + 8, vectorMultiply(vectorShuffle<0, 2, 0, 2>(t1, t3), invDet));
+    vectorStoreAligned(out + 12, vectorSet(0, 0, 0, 1));
+    return det;
+  }
+
+  using MultiplyManyMatrix4x4Func = void (*)(const float*, const float*, float*, size_t);
+
+  /**
+   * @brief Picks the fastest batched multiply kernel for the running CPU (once).
+   *
+   * @return The kernel to use.
+   */
+  inline MultiplyManyMatrix4x4Func selectMultiplyManyMatrix4x4() {
+    static const MultiplyManyMatrix4x4Func kernel = []() -> MultiplyManyMatrix4x4Func {
+#if ENGINEUTILITIES_MATRIX_AVX2
+      if (cpuFeatures().avx2 && cpuFeatures().fma) {
+        return &multiplyManyMatrix4x4AVX2;
+      }
+#endif
+      return &multiplyManyMatrix4x4Generic;
+    }();
+    return kernel;
+  }
+}
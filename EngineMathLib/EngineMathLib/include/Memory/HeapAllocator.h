@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace EngineUtilities {
+	/**
+	 * @brief Indica si un T se puede reubicar copiando sus bytes (memcpy) y olvidando el original.
+	 *
+	 * Por defecto slo se consideran as los tipos trivialmente copiables. Se puede especializar
+	 * para tipos que no apuntan a s mismos (p. ej. TArray o TSharedPointer) para que los
+	 * contenedores los reubiquen en bloque y puedan crecer con Reallocate.
+	 *
+	 * @tparam T El tipo a consultar.
+	 */
+	template<typename T>
+	struct TIsTriviallyRelocatable : std::is_trivially_copyable<T>
+	{
+	};
+
+	/**
+	 * @brief Poltica de memoria por defecto de los contenedores (TArray, TMap, TSet).
+	 *
+	 * Todas las polticas de memoria exponen la misma interfaz, que los contenedores usan a
+	 * travs de una instancia propia (puede tener estado, como un arena o un heap por subsistema):
+	 *
+	 * - void* Allocate(size_t Bytes, size_t Alignment): bloque sin inicializar, o lanza std::bad_alloc.
+	 * - void Deallocate(void* Block, size_t Bytes, size_t Alignment): libera un bloque de Allocate.
+	 * - void* Reallocate(void* Block, size_t OldBytes, size_t NewBytes, size_t Alignment): cambia
+	 *   el tamao de un bloque conservando sus primeros min(OldBytes, NewBytes) bytes. Puede
+	 *   crecer en su sitio o mover el bloque copiando los bytes, as que los contenedores slo la
+	 *   usan con elementos trivialmente reubicables. Con Block nulo equivale a Allocate.
+	 *
+	 * FHeapAllocator usa malloc/realloc/free cuando la alineacin lo permite. realloc ampla el
+	 * bloque en su sitio si hay hueco detrs y, en glibc, los bloques grandes (servidos con mmap)
+	 * crecen con mremap, remapeando pginas en lugar de copiarlas.
+	 */
+	struct FHeapAllocator
+	{
+		/**
+		 * @brief Reserva un bloque de Bytes bytes alineado a Alignment.
+		 */
+		void* Allocate(size_t Bytes, size_t Alignment)
+		{
+			if (Alignment <= alignof(std::max_align_t))
+			{
+				void* Block = std::malloc(Bytes > 0 ? Bytes : 1);
+				if (Block == nullptr)
+				{
+					throw std::bad_alloc();
+				}
+				return Block;
+			}
+			return ::operator new(Bytes, std::align_val_t(Alignment));
+		}
+
+		/**
+		 * @brief Libera un bloque obtenido con Allocate o Reallocate. Acepta nullptr.
+		 */
+		void Deallocate(void* Block, size_t Bytes, size_t Alignment)
+		{
+			(void)Bytes;
+			if (Alignment <= alignof(std::max_align_t))
+			{
+				std::free(Block);
+			}
+			else
+			{
+				::operator delete(Block, std::align_val_t(Alignment));
+			}
+		}
+
+		/**
+		 * @brief Cambia el tamao de un bloque conservando su contenido, en su sitio si es posible.
+		 */
+		void* Reallocate(void* Block, size_t OldBytes, size_t NewBytes, size_t Alignment)
+		{
+			if (Alignment <= alignof(std::max_align_t))
+			{
+				void* NewBlock = std::realloc(Block, NewBytes > 0 ? NewBytes : 1);
+				if (NewBlock == nullptr)
+				{
+					throw std::bad_alloc();
+				}
+				return NewBlock;
+			}
+			// Las reservas sobrealineadas no tienen realloc: copiar a un bloque nuevo.
+			void* NewBlock = Allocate(NewBytes, Alignment);
+			if (Block != nullptr)
+			{
+				std::memcpy(NewBlock, Block, OldBytes < NewBytes ? OldBytes : NewBytes);
+				Deallocate(Block, OldBytes, Alignment);
+			}
+			return NewBlock;
+		}
+
+		bool operator==(const FHeapAllocator&) const { return true; }
+		bool operator!=(const FHeapAllocator&) const { return false; }
+	};
+}
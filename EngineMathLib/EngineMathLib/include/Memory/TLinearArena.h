@@ -0,0 +1,458 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "Memory/HeapAllocator.h"
+#include "Memory/TSharedPointer.h"
+#include "Memory/TUniquePtr.h"
+
+namespace EngineUtilities {
+	/**
+	 * @brief Arena lineal: reservas con un puntero que slo avanza y liberacin en bloque.
+	 *
+	 * La memoria se pide a Backing en bloques de BlockSize bytes encadenados. Allocate alinea el
+	 * cursor del bloque actual y lo avanza; cuando no cabe, pasa al siguiente bloque de la cadena
+	 * o aade uno nuevo al final. Los bloques nunca se devuelven hasta destruir el arena, as que
+	 * tras el primer frame no hay ms llamadas a Backing:
+	 *
+	 * - Reset() vuelve al primer bloque en O(1), sin recorrer la cadena ni tocar la memoria.
+	 * - GetMarker()/Rewind() liberan de golpe todo lo reservado despus del marcador (pila).
+	 * - Deallocate slo recupera la ltima reserva; el resto se libera con Reset o Rewind.
+	 *
+	 * El arena no llama a destructores: los objetos que los necesiten se destruyen antes del Reset
+	 * (p. ej. con MakeUniqueInArena o MakeSharedInArena). No es seguro entre hilos.
+	 *
+	 * @tparam Backing Poltica de memoria que proporciona los bloques (FHeapAllocator por defecto).
+	 */
+	template<typename Backing = FHeapAllocator>
+	class TLinearArena : private Backing
+	{
+		/**
+		 * @brief Cabecera de cada bloque; los datos empiezan justo despus.
+		 */
+		struct FBlock
+		{
+			FBlock* Next;    ///< Siguiente bloque de la cadena.
+			size_t Capacity; ///< Bytes de datos del bloque.
+		};
+
+		static constexpr size_t HeaderSize = (sizeof(FBlock) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+	public:
+		/**
+		 * @brief Posicin del arena que se puede restaurar con Rewind.
+		 */
+		struct FMarker
+		{
+			FBlock* Block; ///< Bloque actual al tomar el marcador (nullptr si an no haba ninguno).
+			char* Cursor;  ///< Cursor dentro de ese bloque.
+		};
+
+		/**
+		 * @brief Constructor. No reserva nada hasta la primera llamada a Allocate.
+		 *
+		 * @param InBlockSize Tamao de datos de cada bloque (las reservas mayores reciben uno a medida).
+		 * @param InBacking Poltica de memoria de la que salen los bloques.
+		 */
+		explicit TLinearArena(size_t InBlockSize = 64 * 1024, const Backing& InBacking = Backing())
+			: Backing(InBacking), First(nullptr), Last(nullptr), Current(nullptr), Cursor(nullptr), End(nullptr),
+			  BlockSize(InBlockSize > 0 ? InBlockSize : 1), ReservedBytes(0)
+		{
+		}
+
+		/**
+		 * @brief Destructor. Devuelve todos los bloques a Backing.
+		 */
+		~TLinearArena()
+		{
+			FBlock* Block = First;
+			while (Block != nullptr)
+			{
+				FBlock* Next = Block->Next;
+				Backing::Deallocate(Block, HeaderSize + Block->Capacity, alignof(std::max_align_t));
+				Block = Next;
+			}
+		}
+
+		// Los asignadores de los contenedores apuntan al arena: no se copia ni se mueve.
+		TLinearArena(const TLinearArena&) = delete;
+		TLinearArena& operator=(const TLinearArena&) = delete;
+
+		/**
+		 * @brief Reserva Bytes bytes alineados a Alignment (potencia de dos).
+		 *
+		 * @return Memoria sin inicializar vlida hasta el siguiente Reset o un Rewind anterior a ella.
+		 */
+		void* Allocate(size_t Bytes, size_t Alignment)
+		{
+			char* Aligned = AlignUp(Cursor, Alignment);
+			if (Current != nullptr && Aligned <= End && static_cast<size_t>(End - Aligned) >= Bytes)
+			{
+				Cursor = Aligned + Bytes;
+				return Aligned;
+			}
+			return AllocateSlow(Bytes, Alignment);
+		}
+
+		/**
+		 * @brief Libera un bloque. Slo recupera memoria si es la ltima reserva; si no, no hace nada.
+		 */
+		void Deallocate(void* Block, size_t Bytes, size_t Alignment)
+		{
+			(void)Alignment;
+			if (Block != nullptr && static_cast<char*>(Block) + Bytes == Cursor)
+			{
+				Cursor = static_cast<char*>(Block);
+			}
+		}
+
+		/**
+		 * @brief Cambia el tamao de un bloque conservando su contenido.
+		 *
+		 * Si el bloque es la ltima reserva y cabe en el bloque actual crece (o encoge) en su sitio
+		 * moviendo el cursor; as un TArray que crece en el arena no deja copias por el camino.
+		 */
+		void* Reallocate(void* Block, size_t OldBytes, size_t NewBytes, size_t Alignment)
+		{
+			if (Block == nullptr)
+			{
+				return Allocate(NewBytes, Alignment);
+			}
+			char* Begin = static_cast<char*>(Block);
+			if (Begin + OldBytes == Cursor && static_cast<size_t>(End - Begin) >= NewBytes)
+			{
+				Cursor = Begin + NewBytes;
+				return Block;
+			}
+			if (NewBytes <= OldBytes)
+			{
+				return Block;
+			}
+			void* NewBlock = Allocate(NewBytes, Alignment);
+			std::memcpy(NewBlock, Block, OldBytes);
+			return NewBlock;
+		}
+
+		/**
+		 * @brief Construye un T en el arena. Su destructor no se llamar automticamente.
+		 */
+		template<typename T, typename... Args>
+		T* New(Args&&... args)
+		{
+			return ::new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * @brief Reserva un array de Count elementos de T sin construir.
+		 */
+		template<typename T>
+		T* AllocateArray(size_t Count)
+		{
+			return static_cast<T*>(Allocate(sizeof(T) * Count, alignof(T)));
+		}
+
+		/**
+		 * @brief Devuelve la posicin actual del arena para restaurarla despus con Rewind.
+		 */
+		FMarker GetMarker() const
+		{
+			return FMarker{ Current, Cursor };
+		}
+
+		/**
+		 * @brief Libera todo lo reservado despus de Marker en O(1).
+		 *
+		 * El marcador debe haberse tomado despus del ltimo Reset y no haber sido invalidado por
+		 * un Rewind a una posicin anterior.
+		 */
+		void Rewind(const FMarker& Marker)
+		{
+			if (Marker.Block == nullptr)
+			{
+				Reset();
+				return;
+			}
+			Current = Marker.Block;
+			Cursor = Marker.Cursor;
+			End = GetData(Current) + Current->Capacity;
+		}
+
+		/**
+		 * @brief Libera todas las reservas en O(1). Los bloques se conservan para los siguientes frames.
+		 */
+		void Reset()
+		{
+			Current = First;
+			Cursor = First != nullptr ? GetData(First) : nullptr;
+			End = First != nullptr ? Cursor + First->Capacity : nullptr;
+		}
+
+		/**
+		 * @brief Bytes pedidos a Backing (datos de todos los bloques).
+		 */
+		size_t GetReservedBytes() const
+		{
+			return ReservedBytes;
+		}
+
+		/**
+		 * @brief Obtener la poltica de memoria de la que salen los bloques.
+		 */
+		const Backing& GetBacking() const
+		{
+			return *this;
+		}
+
+	private:
+		static char* GetData(FBlock* Block)
+		{
+			return reinterpret_cast<char*>(Block) + HeaderSize;
+		}
+
+		static char* AlignUp(char* Pointer, size_t Alignment)
+		{
+			uintptr_t Address = reinterpret_cast<uintptr_t>(Pointer);
+			return Pointer + (((Address + Alignment - 1) & ~(uintptr_t)(Alignment - 1)) - Address);
+		}
+
+		/**
+		 * @brief El bloque actual est lleno: pasa a los siguientes de la cadena o aade uno nuevo.
+		 */
+		void* AllocateSlow(size_t Bytes, size_t Alignment)
+		{
+			// Tras un Reset o Rewind quedan bloques ya reservados por delante.
+			while (Current != nullptr && Current->Next != nullptr)
+			{
+				Current = Current->Next;
+				Cursor = GetData(Current);
+				End = Cursor + Current->Capacity;
+				char* Aligned = AlignUp(Cursor, Alignment);
+				if (Aligned <= End && static_cast<size_t>(End - Aligned) >= Bytes)
+				{
+					Cursor = Aligned + Bytes;
+					return Aligned;
+				}
+			}
+
+			size_t Needed = Bytes + (Alignment > alignof(std::max_align_t) ? Alignment : 0);
+			size_t Capacity = Needed > BlockSize ? Needed : BlockSize;
+			FBlock* Block = static_cast<FBlock*>(Backing::Allocate(HeaderSize + Capacity, alignof(std::max_align_t)));
+			Block->Next = nullptr;
+			Block->Capacity = Capacity;
+			if (Last != nullptr)
+			{
+				Last->Next = Block;
+			}
+			else
+			{
+				First = Block;
+			}
+			Last = Block;
+			ReservedBytes += Capacity;
+
+			Current = Block;
+			char* Aligned = AlignUp(GetData(Block), Alignment);
+			Cursor = Aligned + Bytes;
+			End = GetData(Block) + Capacity;
+			return Aligned;
+		}
+
+		FBlock* First;        ///< Primer bloque de la cadena.
+		FBlock* Last;         ///< ltimo bloque de la cadena.
+		FBlock* Current;      ///< Bloque del que se est reservando.
+		char* Cursor;         ///< Siguiente byte libre de Current.
+		char* End;            ///< Fin de los datos de Current.
+		size_t BlockSize;     ///< Tamao de datos de los bloques nuevos.
+		size_t ReservedBytes; ///< Suma de las capacidades de todos los bloques.
+	};
+
+	/**
+	 * @brief Poltica de memoria que reserva en un arena, para TArray, TMap, TSet, AllocateUnique y AllocateShared.
+	 *
+	 * Slo guarda un puntero al arena, que debe vivir ms que el contenedor. Deallocate no libera
+	 * nada salvo la ltima reserva: el contenedor puede destruirse normalmente o abandonarse
+	 * antes del Reset si sus elementos no necesitan destructor.
+	 *
+	 * @code
+	 * TLinearArena<> Arena;
+	 * TArray<int, TArenaAllocator<TLinearArena<>>> Scratch{ TArenaAllocator<TLinearArena<>>(Arena) };
+	 * @endcode
+	 *
+	 * @tparam ArenaType Tipo del arena (TLinearArena<...>).
+	 */
+	template<typename ArenaType>
+	class TArenaAllocator
+	{
+	public:
+		/**
+		 * @brief Asignador sin arena, slo para punteros y contenedores vacos que se asignarn despus.
+		 */
+		TArenaAllocator() : Arena(nullptr) {}
+
+		explicit TArenaAllocator(ArenaType& InArena) : Arena(&InArena) {}
+
+		void* Allocate(size_t Bytes, size_t Alignment)
+		{
+			return Arena->Allocate(Bytes, Alignment);
+		}
+
+		void Deallocate(void* Block, size_t Bytes, size_t Alignment)
+		{
+			Arena->Deallocate(Block, Bytes, Alignment);
+		}
+
+		void* Reallocate(void* Block, size_t OldBytes, size_t NewBytes, size_t Alignment)
+		{
+			return Arena->Reallocate(Block, OldBytes, NewBytes, Alignment);
+		}
+
+		ArenaType& GetArena() const { return *Arena; }
+
+		bool operator==(const TArenaAllocator& other) const { return Arena == other.Arena; }
+		bool operator!=(const TArenaAllocator& other) const { return Arena != other.Arena; }
+
+	private:
+		ArenaType* Arena; ///< Arena del que sale la memoria.
+	};
+
+	/**
+	 * @brief Asignador de frame con doble bfer: dos arenas lineales que se alternan.
+	 *
+	 * BeginFrame() cambia de arena y hace Reset del que se va a reutilizar, as que lo reservado
+	 * en el frame N sigue siendo vlido durante el frame N + 1 (p. ej. para que otro sistema lo
+	 * consuma) y se libera en bloque al empezar el frame N + 2. Nada sobrevive ms de un frame
+	 * completo ni se libera objeto a objeto.
+	 *
+	 * @tparam Backing Poltica de memoria de la que salen los bloques de ambos arenas.
+	 */
+	template<typename Backing = FHeapAllocator>
+	class TFrameAllocator
+	{
+	public:
+		using ArenaType = TLinearArena<Backing>;
+
+		/**
+		 * @brief Constructor.
+		 *
+		 * @param BlockSize Tamao de bloque de cada arena; conviene que quepa un frame entero.
+		 * @param InBacking Poltica de memoria de la que salen los bloques.
+		 */
+		explicit TFrameAllocator(size_t BlockSize = 256 * 1024, const Backing& InBacking = Backing())
+			: Arenas{ ArenaType(BlockSize, InBacking), ArenaType(BlockSize, InBacking) }, CurrentIndex(0), FrameNumber(0)
+		{
+		}
+
+		/**
+		 * @brief Empieza un frame: libera lo reservado hace dos frames y pasa a reservar en ese arena.
+		 */
+		void BeginFrame()
+		{
+			CurrentIndex ^= 1;
+			Arenas[CurrentIndex].Reset();
+			++FrameNumber;
+		}
+
+		/**
+		 * @brief Reserva memoria para el frame actual.
+		 */
+		void* Allocate(size_t Bytes, size_t Alignment)
+		{
+			return Arenas[CurrentIndex].Allocate(Bytes, Alignment);
+		}
+
+		/**
+		 * @brief Construye un T en el frame actual. Su destructor no se llamar automticamente.
+		 */
+		template<typename T, typename... Args>
+		T* New(Args&&... args)
+		{
+			return Arenas[CurrentIndex].template New<T>(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * @brief Arena del frame actual.
+		 */
+		ArenaType& GetCurrent() { return Arenas[CurrentIndex]; }
+
+		/**
+		 * @brief Arena del frame anterior, todava vlido hasta el prximo BeginFrame.
+		 */
+		ArenaType& GetPrevious() { return Arenas[CurrentIndex ^ 1]; }
+
+		/**
+		 * @brief Poltica de memoria para contenedores que viven en el frame actual.
+		 */
+		TArenaAllocator<ArenaType> GetAllocator() { return TArenaAllocator<ArenaType>(Arenas[CurrentIndex]); }
+
+		/**
+		 * @brief Nmero de llamadas a BeginFrame.
+		 */
+		size_t GetFrameNumber() const { return FrameNumber; }
+
+	private:
+		ArenaType Arenas[2]; ///< Arenas de los frames actual y anterior.
+		size_t CurrentIndex; ///< ndice del arena del frame actual.
+		size_t FrameNumber;  ///< Nmero de frames empezados.
+	};
+
+	/**
+	 * @brief TUniquePtr cuyo objeto vive en un TLinearArena.
+	 */
+	template<typename T, typename Backing = FHeapAllocator>
+	using TArenaUniquePtr = TUniquePtr<T, TAllocatorDelete<T, TArenaAllocator<TLinearArena<Backing>>>>;
+
+	/**
+	 * @brief Crea un TUniquePtr con el objeto reservado en un arena.
+	 *
+	 * Al destruirse llama al destructor de T; la memoria vuelve al arena con el siguiente Reset.
+	 * El puntero debe destruirse antes de ese Reset.
+	 */
+	template<typename T, typename Backing, typename... Args>
+	TArenaUniquePtr<T, Backing> MakeUniqueInArena(TLinearArena<Backing>& Arena, Args&&... args)
+	{
+		return AllocateUnique<T>(TArenaAllocator<TLinearArena<Backing>>(Arena), std::forward<Args>(args)...);
+	}
+
+	/**
+	 * @brief Crea un TSharedPointer con el objeto y su bloque de control en un arena.
+	 *
+	 * El objeto se destruye con la ltima referencia fuerte, como con MakeShared. Todas las
+	 * referencias (tambin las dbiles) deben soltarse antes del siguiente Reset del arena.
+	 */
+	template<typename T, ESPMode Mode = ESPMode::NotThreadSafe, typename Backing, typename... Args>
+	TSharedPointer<T, Mode> MakeSharedInArena(TLinearArena<Backing>& Arena, Args&&... args)
+	{
+		return AllocateShared<T, Mode>(TArenaAllocator<TLinearArena<Backing>>(Arena), std::forward<Args>(args)...);
+	}
+}
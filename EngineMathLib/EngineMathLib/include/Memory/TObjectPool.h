@@ -0,0 +1,625 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "Memory/HeapAllocator.h"
+#include "Memory/TSharedPointer.h"
+#include "Memory/TUniquePtr.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace EngineUtilities {
+	/**
+	 * @brief ndice pequeo y estable del hilo actual, para indexar las cachs por hilo de los pools.
+	 *
+	 * Cada hilo recibe el menor ndice libre la primera vez que lo pide y lo devuelve al terminar,
+	 * as que las cachs de un hilo que termina pasan al siguiente que recibe su ndice (el mutex
+	 * ordena ambos accesos). A partir de MaxThreads hilos vivos se devuelve MaxThreads y esos
+	 * hilos usan directamente la lista global.
+	 */
+	class FPoolThreadIndex
+	{
+	public:
+		static constexpr uint32_t MaxThreads = 64;
+
+		static uint32_t Get()
+		{
+			thread_local FSlot Slot;
+			return Slot.Index;
+		}
+
+	private:
+		struct FSlot
+		{
+			uint32_t Index;
+
+			FSlot()
+			{
+				std::lock_guard<std::mutex> Lock(GetMutex());
+				uint64_t& Used = GetUsedMask();
+				Index = 0;
+				while (Index < MaxThreads && (Used >> Index) & 1)
+				{
+					++Index;
+				}
+				if (Index < MaxThreads)
+				{
+					Used |= uint64_t(1) << Index;
+				}
+			}
+
+			~FSlot()
+			{
+				if (Index < MaxThreads)
+				{
+					std::lock_guard<std::mutex> Lock(GetMutex());
+					GetUsedMask() &= ~(uint64_t(1) << Index);
+				}
+			}
+		};
+
+		static std::mutex& GetMutex()
+		{
+			static std::mutex Mutex;
+			return Mutex;
+		}
+
+		static uint64_t& GetUsedMask()
+		{
+			static uint64_t Used = 0;
+			return Used;
+		}
+	};
+
+	/**
+	 * @brief Pool de bloques de tamao fijo con lista libre global sin bloqueos.
+	 *
+	 * Es la parte sin tipo de TObjectPool y TSharedObjectPool. Los huecos se reservan en slabs
+	 * que doblan su tamao cada vez (el slab k tiene FirstSlabSlots << k huecos) y no se
+	 * devuelven hasta destruir el pool. Cada hueco tiene un ndice global de 32 bits, y la lista
+	 * libre es una pila de Treiber intrusiva: un hueco libre guarda el ndice del siguiente en
+	 * sus primeros bytes y la cabeza empaqueta (etiqueta, ndice + 1) en 64 bits, de modo que un
+	 * nico compare_exchange evita el problema ABA sin CAS de 128 bits.
+	 *
+	 * Allocate y Free se pueden llamar desde cualquier hilo. Slo el crecimiento toma un mutex.
+	 * Salvo que se desactiven, cada hilo tiene adems una cach de bloques libres sin atmicos que
+	 * slo habla con la lista global por lotes de CacheBatch bloques; un bloque puede liberarse en
+	 * un hilo distinto al que lo reserv.
+	 */
+	class FFixedSizePool
+	{
+	public:
+		/**
+		 * @brief Constructor. No reserva nada hasta la primera llamada a Allocate.
+		 *
+		 * @param InSlotSize Tamao de cada bloque.
+		 * @param InSlotAlignment Alineacin de cada bloque (potencia de dos).
+		 * @param FirstSlabSlots Huecos del primer slab (se redondea a potencia de dos).
+		 * @param bInUseThreadCaches Si es false, cada Allocate/Free va directo a la lista global.
+		 */
+		FFixedSizePool(size_t InSlotSize, size_t InSlotAlignment, uint32_t FirstSlabSlots = 256, bool bInUseThreadCaches = true)
+			: FreeHead(0), NumSlabs(0), bUseThreadCaches(bInUseThreadCaches)
+		{
+			SlotAlignment = InSlotAlignment > alignof(void*) ? InSlotAlignment : alignof(void*);
+			size_t Size = InSlotSize > sizeof(void*) ? InSlotSize : sizeof(void*);
+			SlotSize = (Size + SlotAlignment - 1) & ~(SlotAlignment - 1);
+			FirstSlabShift = 0;
+			while ((1u << FirstSlabShift) < FirstSlabSlots && FirstSlabShift < 20)
+			{
+				++FirstSlabShift;
+			}
+			for (uint32_t i = 0; i < MaxSlabs; ++i)
+			{
+				Slabs[i].store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		 * @brief Destructor. Devuelve los slabs; no destruye los objetos que sigan vivos.
+		 */
+		~FFixedSizePool()
+		{
+			uint32_t Count = NumSlabs.load(std::memory_order_relaxed);
+			for (uint32_t k = 0; k < Count; ++k)
+			{
+				Heap.Deallocate(Slabs[k].load(std::memory_order_relaxed), GetSlabBytes(k), SlotAlignment);
+			}
+		}
+
+		FFixedSizePool(const FFixedSizePool&) = delete;
+		FFixedSizePool& operator=(const FFixedSizePool&) = delete;
+
+		/**
+		 * @brief Reserva un bloque de GetSlotSize() bytes. Sin bloqueos salvo cuando hay que crecer.
+		 */
+		void* Allocate()
+		{
+			uint32_t Thread = bUseThreadCaches ? FPoolThreadIndex::Get() : FPoolThreadIndex::MaxThreads;
+			if (Thread < FPoolThreadIndex::MaxThreads)
+			{
+				FThreadCache& Cache = Caches[Thread];
+				if (Cache.Head != nullptr || Refill(Cache))
+				{
+					void* Slot = Cache.Head;
+					Cache.Head = *static_cast<void**>(Slot);
+					--Cache.Count;
+					return Slot;
+				}
+				return Grow();
+			}
+			void* Slot = TryPop();
+			return Slot != nullptr ? Slot : Grow();
+		}
+
+		/**
+		 * @brief Devuelve a la lista libre un bloque obtenido con Allocate (desde cualquier hilo).
+		 */
+		void Free(void* Slot)
+		{
+			if (Slot == nullptr)
+			{
+				return;
+			}
+			uint32_t Thread = bUseThreadCaches ? FPoolThreadIndex::Get() : FPoolThreadIndex::MaxThreads;
+			if (Thread < FPoolThreadIndex::MaxThreads)
+			{
+				FThreadCache& Cache = Caches[Thread];
+				*static_cast<void**>(Slot) = Cache.Head;
+				Cache.Head = Slot;
+				if (++Cache.Count >= 2 * CacheBatch)
+				{
+					Release(Cache, CacheBatch);
+				}
+				return;
+			}
+			uint32_t Index = IndexOf(Slot);
+			PushChain(Index, Index);
+		}
+
+		/**
+		 * @brief Tamao de cada bloque, ya redondeado a su alineacin.
+		 */
+		size_t GetSlotSize() const { return SlotSize; }
+
+		/**
+		 * @brief Alineacin de cada bloque.
+		 */
+		size_t GetSlotAlignment() const { return SlotAlignment; }
+
+		/**
+		 * @brief Nmero de bloques reservados en todos los slabs (libres u ocupados).
+		 */
+		size_t GetCapacity() const
+		{
+			return FirstIndexOf(NumSlabs.load(std::memory_order_acquire));
+		}
+
+		/**
+		 * @brief Devuelve al pool los bloques libres de la cach del hilo que llama.
+		 *
+		 * til antes de que un hilo quede inactivo mucho tiempo; si el hilo termina, su cach
+		 * pasa al siguiente hilo que reciba su ndice.
+		 */
+		void FlushThreadCache()
+		{
+			uint32_t Thread = FPoolThreadIndex::Get();
+			if (bUseThreadCaches && Thread < FPoolThreadIndex::MaxThreads)
+			{
+				Release(Caches[Thread], Caches[Thread].Count);
+			}
+		}
+
+	private:
+		static constexpr uint32_t MaxSlabs = 32;
+		static constexpr uint32_t EmptyIndex = 0; ///< ndice + 1 de la cabeza cuando la lista est vaca.
+		static constexpr uint32_t CacheBatch = 32; ///< Bloques que se mueven en cada intercambio cach/lista global.
+
+		/**
+		 * @brief Lista local de bloques libres de un hilo, enlazada por punteros y sin atmicos.
+		 *
+		 * Cada una ocupa su propia lnea de cach para que los hilos no compartan lneas.
+		 */
+		struct alignas(64) FThreadCache
+		{
+			void* Head = nullptr; ///< Primer bloque libre.
+			uint32_t Count = 0;   ///< Bloques en la lista.
+		};
+
+		/**
+		 * @brief Pasa hasta CacheBatch bloques de la lista global a la cach.
+		 */
+		bool Refill(FThreadCache& Cache)
+		{
+			for (uint32_t i = 0; i < CacheBatch; ++i)
+			{
+				void* Slot = TryPop();
+				if (Slot == nullptr)
+				{
+					break;
+				}
+				*static_cast<void**>(Slot) = Cache.Head;
+				Cache.Head = Slot;
+				++Cache.Count;
+			}
+			return Cache.Head != nullptr;
+		}
+
+		/**
+		 * @brief Encadena los primeros Amount bloques de la cach por ndice y los publica con un solo CAS.
+		 */
+		void Release(FThreadCache& Cache, uint32_t Amount)
+		{
+			if (Amount == 0)
+			{
+				return;
+			}
+			void* Slot = Cache.Head;
+			uint32_t FirstIndex = IndexOf(Slot);
+			uint32_t Index = FirstIndex;
+			for (uint32_t i = 1; i < Amount; ++i)
+			{
+				void* Next = *static_cast<void**>(Slot);
+				uint32_t NextIndex = IndexOf(Next);
+				GetNextIndex(Slot).store(NextIndex + 1, std::memory_order_relaxed);
+				Slot = Next;
+				Index = NextIndex;
+			}
+			Cache.Head = *static_cast<void**>(Slot);
+			Cache.Count -= Amount;
+			PushChain(FirstIndex, Index);
+		}
+
+		/**
+		 * @brief ndice del bit ms significativo activo de un valor no nulo.
+		 */
+		static uint32_t HighestBit(uint32_t Value)
+		{
+#if defined(_MSC_VER)
+			unsigned long Index;
+			_BitScanReverse(&Index, Value);
+			return static_cast<uint32_t>(Index);
+#else
+			return 31u - static_cast<uint32_t>(__builtin_clz(Value));
+#endif
+		}
+
+		/**
+		 * @brief Los primeros bytes de un bloque libre guardan el ndice + 1 del siguiente.
+		 */
+		static std::atomic<uint32_t>& GetNextIndex(void* Slot)
+		{
+			return *static_cast<std::atomic<uint32_t>*>(Slot);
+		}
+
+		size_t GetSlabSlots(uint32_t Slab) const
+		{
+			return size_t(1) << (FirstSlabShift + Slab);
+		}
+
+		size_t GetSlabBytes(uint32_t Slab) const
+		{
+			return GetSlabSlots(Slab) * SlotSize;
+		}
+
+		/**
+		 * @brief ndice global del primer bloque del slab Slab: FirstSlabSlots * (2^Slab - 1).
+		 */
+		size_t FirstIndexOf(uint32_t Slab) const
+		{
+			return ((size_t(1) << Slab) - 1) << FirstSlabShift;
+		}
+
+		char* SlotFromIndex(uint32_t Index) const
+		{
+			uint32_t Slab = HighestBit((Index >> FirstSlabShift) + 1);
+			size_t Offset = Index - FirstIndexOf(Slab);
+			return Slabs[Slab].load(std::memory_order_acquire) + Offset * SlotSize;
+		}
+
+		/**
+		 * @brief Busca el slab de un bloque empezando por el ms reciente, que contiene al menos
+		 *        la mitad de los bloques, as que de media bastan menos de dos comparaciones.
+		 */
+		uint32_t IndexOf(void* Slot) const
+		{
+			const char* Address = static_cast<const char*>(Slot);
+			for (uint32_t k = NumSlabs.load(std::memory_order_acquire); k-- > 0;)
+			{
+				const char* Begin = Slabs[k].load(std::memory_order_relaxed);
+				if (Address >= Begin && Address < Begin + GetSlabBytes(k))
+				{
+					return static_cast<uint32_t>(FirstIndexOf(k) + size_t(Address - Begin) / SlotSize);
+				}
+			}
+			std::cerr << "FFixedSizePool: block does not belong to this pool" << std::endl;
+			exit(1);
+		}
+
+		/**
+		 * @brief Saca un bloque de la lista libre global, o nullptr si est vaca.
+		 */
+		void* TryPop()
+		{
+			uint64_t Head = FreeHead.load(std::memory_order_acquire);
+			while (static_cast<uint32_t>(Head) != EmptyIndex)
+			{
+				char* Slot = SlotFromIndex(static_cast<uint32_t>(Head) - 1);
+				// Si otro hilo ya sac este bloque, Next puede ser basura (y ThreadSanitizer lo
+				// seala como carrera con el objeto que se construye encima), pero la etiqueta
+				// habr cambiado y el CAS fallar. Los slabs nunca se liberan: la lectura es vlida.
+				uint64_t Next = GetNextIndex(Slot).load(std::memory_order_relaxed);
+				uint64_t NewHead = ((Head >> 32) + 1) << 32 | Next;
+				if (FreeHead.compare_exchange_weak(Head, NewHead, std::memory_order_acquire, std::memory_order_acquire))
+				{
+					return Slot;
+				}
+			}
+			return nullptr;
+		}
+
+		/**
+		 * @brief Publica la cadena First..Last (ya enlazada por ndices) en la lista libre global.
+		 */
+		void PushChain(uint32_t First, uint32_t Last)
+		{
+			std::atomic<uint32_t>& LastNext = GetNextIndex(SlotFromIndex(Last));
+			uint64_t Head = FreeHead.load(std::memory_order_relaxed);
+			uint64_t NewHead;
+			do
+			{
+				LastNext.store(static_cast<uint32_t>(Head), std::memory_order_relaxed);
+				NewHead = ((Head >> 32) + 1) << 32 | (uint64_t(First) + 1);
+			} while (!FreeHead.compare_exchange_weak(Head, NewHead, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		/**
+		 * @brief Aade un slab del doble de tamao que el anterior y devuelve su primer bloque.
+		 */
+		void* Grow()
+		{
+			std::lock_guard<std::mutex> Lock(GrowMutex);
+			// Otro hilo puede haber crecido mientras esperbamos el mutex.
+			if (void* Slot = TryPop())
+			{
+				return Slot;
+			}
+			uint32_t Slab = NumSlabs.load(std::memory_order_relaxed);
+			if (Slab == MaxSlabs || FirstIndexOf(Slab + 1) > UINT32_MAX)
+			{
+				throw std::bad_alloc();
+			}
+			char* Memory = static_cast<char*>(Heap.Allocate(GetSlabBytes(Slab), SlotAlignment));
+			Slabs[Slab].store(Memory, std::memory_order_release);
+			NumSlabs.store(Slab + 1, std::memory_order_release);
+
+			// El primer bloque se devuelve; el resto se encadena y se publica de una vez.
+			uint32_t First = static_cast<uint32_t>(FirstIndexOf(Slab));
+			uint32_t Count = static_cast<uint32_t>(GetSlabSlots(Slab));
+			if (Count > 1)
+			{
+				for (uint32_t i = 1; i + 1 < Count; ++i)
+				{
+					::new (Memory + i * SlotSize) std::atomic<uint32_t>(First + i + 2);
+				}
+				::new (Memory + (Count - 1) * SlotSize) std::atomic<uint32_t>(EmptyIndex);
+				PushChain(First + 1, First + Count - 1);
+			}
+			return Memory;
+		}
+
+		std::atomic<uint64_t> FreeHead;       ///< Cabeza de la lista libre: (etiqueta << 32) | (ndice + 1).
+		std::atomic<char*> Slabs[MaxSlabs];   ///< Memoria de cada slab.
+		std::atomic<uint32_t> NumSlabs;       ///< Slabs publicados.
+		size_t SlotSize;                      ///< Tamao de cada bloque.
+		size_t SlotAlignment;                 ///< Alineacin de cada bloque y de los slabs.
+		uint32_t FirstSlabShift;              ///< log2 de los bloques del primer slab.
+		std::mutex GrowMutex;                 ///< Serializa el crecimiento.
+		FHeapAllocator Heap;                  ///< Origen de la memoria de los slabs.
+		bool bUseThreadCaches;                ///< Si Allocate/Free pasan por las cachs por hilo.
+		FThreadCache Caches[FPoolThreadIndex::MaxThreads]; ///< Cach de cada ndice de hilo.
+	};
+
+	/**
+	 * @brief Poltica de memoria que reserva bloques de un FFixedSizePool (para AllocateUnique/AllocateShared).
+	 *
+	 * Slo admite peticiones que quepan en un bloque del pool; cualquier otra es un error de uso.
+	 */
+	class FFixedSizePoolAllocator
+	{
+	public:
+		/**
+		 * @brief Asignador sin pool, slo para punteros vacos (p. ej. un TPoolUniquePtr por defecto).
+		 */
+		FFixedSizePoolAllocator() : Pool(nullptr) {}
+
+		explicit FFixedSizePoolAllocator(FFixedSizePool& InPool) : Pool(&InPool) {}
+
+		void* Allocate(size_t Bytes, size_t Alignment)
+		{
+			if (Bytes > Pool->GetSlotSize() || Alignment > Pool->GetSlotAlignment())
+			{
+				std::cerr << "FFixedSizePoolAllocator: request does not fit in a pool block" << std::endl;
+				exit(1);
+			}
+			return Pool->Allocate();
+		}
+
+		void Deallocate(void* Block, size_t Bytes, size_t Alignment)
+		{
+			(void)Bytes;
+			(void)Alignment;
+			Pool->Free(Block);
+		}
+
+		void* Reallocate(void* Block, size_t OldBytes, size_t NewBytes, size_t Alignment)
+		{
+			(void)OldBytes;
+			if (Block == nullptr || NewBytes > Pool->GetSlotSize())
+			{
+				void* NewBlock = Allocate(NewBytes, Alignment);
+				Pool->Free(Block);
+				return NewBlock;
+			}
+			return Block;
+		}
+
+		FFixedSizePool& GetPool() const { return *Pool; }
+
+		bool operator==(const FFixedSizePoolAllocator& other) const { return Pool == other.Pool; }
+		bool operator!=(const FFixedSizePoolAllocator& other) const { return Pool != other.Pool; }
+
+	private:
+		FFixedSizePool* Pool; ///< Pool del que salen los bloques.
+	};
+
+	/**
+	 * @brief Pool de objetos de tipo T para objetos pequeos que se crean y destruyen constantemente.
+	 *
+	 * Cada objeto ocupa un bloque de un FFixedSizePool, as que reservar y liberar es sacar o meter
+	 * un puntero en la cach del hilo (o un CAS sobre la lista global). El pool debe vivir ms
+	 * que sus objetos.
+	 *
+	 * @code
+	 * TObjectPool<FParticle> Pool;
+	 * TPoolUniquePtr<FParticle> Particle = MakeUniqueFromPool(Pool, Position);
+	 * @endcode
+	 *
+	 * @tparam T Tipo de los objetos.
+	 */
+	template<typename T>
+	class TObjectPool : public FFixedSizePool
+	{
+	public:
+		explicit TObjectPool(uint32_t FirstSlabSlots = 256, bool bInUseThreadCaches = true)
+			: FFixedSizePool(sizeof(T), alignof(T), FirstSlabSlots, bInUseThreadCaches)
+		{
+		}
+
+		/**
+		 * @brief Construye un T en un bloque del pool.
+		 */
+		template<typename... Args>
+		T* New(Args&&... args)
+		{
+			return Construct(Allocate(), std::forward<Args>(args)...);
+		}
+
+		/**
+		 * @brief Destruye un objeto de New y devuelve su bloque al pool.
+		 */
+		void Delete(T* Object)
+		{
+			if (Object != nullptr)
+			{
+				Object->~T();
+				Free(Object);
+			}
+		}
+
+		/**
+		 * @brief Poltica de memoria sobre este pool.
+		 */
+		FFixedSizePoolAllocator GetAllocator() { return FFixedSizePoolAllocator(*this); }
+
+	private:
+		template<typename... Args>
+		T* Construct(void* Slot, Args&&... args)
+		{
+			try
+			{
+				return ::new (Slot) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				Free(Slot);
+				throw;
+			}
+		}
+	};
+
+	/**
+	 * @brief Pool para MakeSharedFromPool: cada bloque guarda el objeto y su bloque de control.
+	 *
+	 * @tparam T Tipo de los objetos.
+	 * @tparam Mode Modo de recuento de los TSharedPointer que se crean.
+	 */
+	template<typename T, ESPMode Mode = ESPMode::NotThreadSafe>
+	class TSharedObjectPool : public FFixedSizePool
+	{
+	public:
+		using ControllerType = TAllocatedReferenceController<T, Mode, FFixedSizePoolAllocator>;
+
+		explicit TSharedObjectPool(uint32_t FirstSlabSlots = 256, bool bInUseThreadCaches = true)
+			: FFixedSizePool(sizeof(ControllerType), alignof(ControllerType), FirstSlabSlots, bInUseThreadCaches)
+		{
+		}
+
+		/**
+		 * @brief Poltica de memoria sobre este pool.
+		 */
+		FFixedSizePoolAllocator GetAllocator() { return FFixedSizePoolAllocator(*this); }
+	};
+
+	/**
+	 * @brief TUniquePtr cuyo objeto vive en un TObjectPool.
+	 */
+	template<typename T>
+	using TPoolUniquePtr = TUniquePtr<T, TAllocatorDelete<T, FFixedSizePoolAllocator>>;
+
+	/**
+	 * @brief Crea un TUniquePtr con el objeto en un bloque del pool; al destruirse lo devuelve al pool.
+	 */
+	template<typename T, typename... Args>
+	TPoolUniquePtr<T> MakeUniqueFromPool(TObjectPool<T>& Pool, Args&&... args)
+	{
+		return AllocateUnique<T>(Pool.GetAllocator(), std::forward<Args>(args)...);
+	}
+
+	/**
+	 * @brief Crea un TSharedPointer con el objeto y su bloque de control en un bloque del pool.
+	 *
+	 * El objeto se destruye con la ltima referencia fuerte y el bloque vuelve al pool con la
+	 * ltima dbil, desde el hilo que la suelte.
+	 */
+	template<typename T, ESPMode Mode, typename... Args>
+	TSharedPointer<T, Mode> MakeSharedFromPool(TSharedObjectPool<T, Mode>& Pool, Args&&... args)
+	{
+		return AllocateShared<T, Mode>(Pool.GetAllocator(), std::forward<Args>(args)...);
+	}
+}
@@ -0,0 +1,483 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace EngineUtilities {
+	class TRefCounted;
+
+	/**
+	 * @brief Proxy compartido entre un objeto TRefCounted y sus TWeakRefPtr.
+	 *
+	 * Se crea la primera vez que alguien observa el objeto con un TWeakRefPtr, as que los
+	 * objetos que nunca se observan no pagan nada. Su propio recuento incluye una referencia
+	 * del objeto mientras est vivo ms una por cada TWeakRefPtr.
+	 */
+	class FRefWeakProxy
+	{
+	public:
+		FRefWeakProxy(const TRefCounted* InObject) : ProxyRefs(1), Object(InObject)
+		{
+			Guard.clear();
+		}
+
+		void AddRef() { ProxyRefs.fetch_add(1, std::memory_order_relaxed); }
+
+		void Release()
+		{
+			if (ProxyRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				delete this;
+			}
+		}
+
+		/**
+		 * @brief Cerrojo de espera activa que protege a Object. Las secciones crticas son
+		 * de unas pocas instrucciones.
+		 */
+		void Lock()
+		{
+			while (Guard.test_and_set(std::memory_order_acquire))
+			{
+			}
+		}
+
+		void Unlock() { Guard.clear(std::memory_order_release); }
+
+		std::atomic<int32_t> ProxyRefs; ///< Referencias al proxy.
+		std::atomic_flag Guard;         ///< Cerrojo que protege a Object.
+		const TRefCounted* Object;      ///< Objeto observado, o nullptr si ya se destruy.
+	};
+
+	/**
+	 * @brief Clase base para objetos con recuento de referencias intrusivo.
+	 *
+	 * El contador atmico vive dentro del propio objeto, por lo que TRefPtr ocupa un solo
+	 * puntero y copiarlo no toca otra lnea de cach. El objeto se destruye con delete al
+	 * liberar la ltima referencia, as que debe crearse con new (o con MakeRefCounted).
+	 */
+	class TRefCounted
+	{
+	public:
+		/**
+		 * @brief Aade una referencia fuerte.
+		 */
+		void AddRef() const
+		{
+			RefCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Libera una referencia fuerte y destruye el objeto si era la ltima.
+		 */
+		void Release() const
+		{
+			if (RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				Destroy();
+			}
+		}
+
+		/**
+		 * @brief Devuelve el nmero actual de referencias fuertes.
+		 */
+		int32_t GetRefCount() const
+		{
+			return RefCount.load(std::memory_order_acquire);
+		}
+
+	protected:
+		TRefCounted() : RefCount(0), WeakProxy(nullptr) {}
+
+		// Copiar un objeto no copia sus referencias.
+		TRefCounted(const TRefCounted&) : RefCount(0), WeakProxy(nullptr) {}
+		TRefCounted& operator=(const TRefCounted&) { return *this; }
+
+		virtual ~TRefCounted() {}
+
+	private:
+		template<typename U>
+		friend class TWeakRefPtr;
+
+		mutable std::atomic<int32_t> RefCount;         ///< Nmero de referencias fuertes.
+		mutable std::atomic<FRefWeakProxy*> WeakProxy; ///< Proxy de observacin, creado bajo demanda.
+
+		/**
+		 * @brief Aade una referencia slo si el objeto sigue vivo (compare-and-swap).
+		 * @return true si se aadi la referencia.
+		 */
+		bool TryAddRef() const
+		{
+			int32_t Expected = RefCount.load(std::memory_order_relaxed);
+			while (Expected != 0)
+			{
+				if (RefCount.compare_exchange_weak(Expected, Expected + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * @brief Devuelve el proxy de observacin, crendolo si no existe.
+		 *
+		 * Slo debe llamarse mientras se tiene una referencia fuerte al objeto.
+		 */
+		FRefWeakProxy* GetWeakProxy() const
+		{
+			FRefWeakProxy* Proxy = WeakProxy.load(std::memory_order_acquire);
+			if (Proxy == nullptr)
+			{
+				FRefWeakProxy* NewProxy = new FRefWeakProxy(this);
+				if (WeakProxy.compare_exchange_strong(Proxy, NewProxy, std::memory_order_acq_rel, std::memory_order_acquire))
+				{
+					Proxy = NewProxy;
+				}
+				else
+				{
+					delete NewProxy;  ///< Otro hilo cre el proxy antes.
+				}
+			}
+			return Proxy;
+		}
+
+		/**
+		 * @brief Desconecta el proxy (si existe) y destruye el objeto.
+		 *
+		 * Se toma el cerrojo del proxy antes de borrar, de modo que un TWeakRefPtr::lock
+		 * concurrente nunca lee el objeto despus de liberado.
+		 */
+		void Destroy() const
+		{
+			FRefWeakProxy* Proxy = WeakProxy.load(std::memory_order_acquire);
+			if (Proxy)
+			{
+				Proxy->Lock();
+				Proxy->Object = nullptr;
+				Proxy->Unlock();
+				Proxy->Release();
+			}
+			delete this;
+		}
+	};
+
+	/**
+	 * @brief Puntero con recuento de referencias intrusivo para objetos derivados de TRefCounted.
+	 *
+	 * Ocupa lo mismo que un puntero crudo. Copiarlo slo incrementa el contador del objeto.
+	 *
+	 * @tparam T Tipo del objeto gestionado (derivado de TRefCounted).
+	 */
+	template<typename T>
+	class TRefPtr
+	{
+	public:
+		/**
+		 * @brief Constructor por defecto. Inicializa el puntero a nullptr.
+		 */
+		TRefPtr() : ptr(nullptr) {}
+
+		/**
+		 * @brief Constructor que toma un puntero crudo y aade una referencia.
+		 *
+		 * @param rawPtr Puntero crudo al objeto.
+		 */
+		TRefPtr(T* rawPtr) : ptr(rawPtr)
+		{
+			if (ptr)
+			{
+				ptr->AddRef();
+			}
+		}
+
+		/**
+		 * @brief Constructor de copia.
+		 *
+		 * @param other Otro TRefPtr del mismo tipo.
+		 */
+		TRefPtr(const TRefPtr& other) : ptr(other.ptr)
+		{
+			if (ptr)
+			{
+				ptr->AddRef();
+			}
+		}
+
+		/**
+		 * @brief Constructor de movimiento.
+		 *
+		 * @param other Otro TRefPtr del mismo tipo.
+		 */
+		TRefPtr(TRefPtr&& other) noexcept : ptr(other.ptr)
+		{
+			other.ptr = nullptr;
+		}
+
+		/**
+		 * @brief Operador de asignacin de copia.
+		 *
+		 * @param other Otro TRefPtr del mismo tipo.
+		 * @return Referencia al TRefPtr actual.
+		 */
+		TRefPtr& operator=(const TRefPtr& other)
+		{
+			reset(other.ptr);
+			return *this;
+		}
+
+		/**
+		 * @brief Operador de asignacin de movimiento.
+		 *
+		 * @param other Otro TRefPtr del mismo tipo.
+		 * @return Referencia al TRefPtr actual.
+		 */
+		TRefPtr& operator=(TRefPtr&& other) noexcept
+		{
+			if (this != &other)
+			{
+				T* oldPtr = ptr;
+				ptr = other.ptr;
+				other.ptr = nullptr;
+				if (oldPtr)
+				{
+					oldPtr->Release();
+				}
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Destructor. Libera la referencia.
+		 */
+		~TRefPtr()
+		{
+			if (ptr)
+			{
+				ptr->Release();
+			}
+		}
+
+		T& operator*() const { return *ptr; }
+		T* operator->() const { return ptr; }
+
+		/**
+		 * @brief Obtener el puntero crudo.
+		 *
+		 * @return Puntero crudo al objeto gestionado.
+		 */
+		T* get() const { return ptr; }
+
+		/**
+		 * @brief Comprobar si el puntero es nulo.
+		 *
+		 * @return true si el puntero es nulo, false en caso contrario.
+		 */
+		bool isNull() const { return ptr == nullptr; }
+
+		/**
+		 * @brief Libera el objeto actual y opcionalmente pasa a gestionar otro.
+		 *
+		 * @param newPtr Nuevo objeto (por defecto nullptr).
+		 */
+		void reset(T* newPtr = nullptr)
+		{
+			if (newPtr)
+			{
+				newPtr->AddRef();  ///< Primero la nueva referencia, por si newPtr == ptr.
+			}
+			T* oldPtr = ptr;
+			ptr = newPtr;
+			if (oldPtr)
+			{
+				oldPtr->Release();
+			}
+		}
+
+	private:
+		template<typename U>
+		friend class TWeakRefPtr;
+
+		struct FAdoptTag {};
+
+		/**
+		 * @brief Toma una referencia ya aadida sin incrementar el contador.
+		 */
+		TRefPtr(T* rawPtr, FAdoptTag) : ptr(rawPtr) {}
+
+		T* ptr; ///< Puntero al objeto gestionado.
+	};
+
+	/**
+	 * @brief Observador dbil de un objeto TRefCounted.
+	 *
+	 * No mantiene vivo al objeto. lock() devuelve un TRefPtr vlido slo si el objeto
+	 * todava existe, y es seguro frente a la liberacin concurrente de la ltima referencia.
+	 *
+	 * @tparam T Tipo del objeto observado (derivado de TRefCounted).
+	 */
+	template<typename T>
+	class TWeakRefPtr
+	{
+	public:
+		/**
+		 * @brief Constructor por defecto.
+		 */
+		TWeakRefPtr() : ptr(nullptr), proxy(nullptr) {}
+
+		/**
+		 * @brief Constructor que observa el objeto de un TRefPtr.
+		 *
+		 * @param refPtr TRefPtr desde el cual se observar el objeto.
+		 */
+		TWeakRefPtr(const TRefPtr<T>& refPtr) : ptr(refPtr.get()), proxy(nullptr)
+		{
+			if (ptr)
+			{
+				proxy = ptr->GetWeakProxy();
+				proxy->AddRef();
+			}
+		}
+
+		TWeakRefPtr(const TWeakRefPtr& other) : ptr(other.ptr), proxy(other.proxy)
+		{
+			if (proxy)
+			{
+				proxy->AddRef();
+			}
+		}
+
+		TWeakRefPtr(TWeakRefPtr&& other) noexcept : ptr(other.ptr), proxy(other.proxy)
+		{
+			other.ptr = nullptr;
+			other.proxy = nullptr;
+		}
+
+		TWeakRefPtr& operator=(const TWeakRefPtr& other)
+		{
+			if (this != &other)
+			{
+				if (other.proxy)
+				{
+					other.proxy->AddRef();
+				}
+				reset();
+				ptr = other.ptr;
+				proxy = other.proxy;
+			}
+			return *this;
+		}
+
+		TWeakRefPtr& operator=(TWeakRefPtr&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				ptr = other.ptr;
+				proxy = other.proxy;
+				other.ptr = nullptr;
+				other.proxy = nullptr;
+			}
+			return *this;
+		}
+
+		~TWeakRefPtr()
+		{
+			reset();
+		}
+
+		/**
+		 * @brief Convertir TWeakRefPtr a TRefPtr.
+		 *
+		 * @return Un TRefPtr al objeto, o nulo si el objeto ha sido destruido.
+		 */
+		TRefPtr<T> lock() const
+		{
+			T* result = nullptr;
+			if (proxy)
+			{
+				proxy->Lock();
+				if (proxy->Object && ptr->TryAddRef())
+				{
+					result = ptr;
+				}
+				proxy->Unlock();
+			}
+			return TRefPtr<T>(result, typename TRefPtr<T>::FAdoptTag());
+		}
+
+		/**
+		 * @brief Comprobar si el objeto observado ya fue destruido.
+		 */
+		bool isExpired() const
+		{
+			if (proxy == nullptr)
+			{
+				return true;
+			}
+			proxy->Lock();
+			bool expired = proxy->Object == nullptr;
+			proxy->Unlock();
+			return expired;
+		}
+
+		/**
+		 * @brief Deja de observar el objeto.
+		 */
+		void reset()
+		{
+			if (proxy)
+			{
+				proxy->Release();
+			}
+			ptr = nullptr;
+			proxy = nullptr;
+		}
+
+	private:
+		T* ptr;               ///< Puntero al objeto observado (slo se usa si sigue vivo).
+		FRefWeakProxy* proxy; ///< Proxy compartido con el objeto.
+	};
+
+	/**
+	 * @brief Funcin de utilidad para crear un objeto TRefCounted y su TRefPtr.
+	 *
+	 * @tparam T Tipo del objeto (derivado de TRefCounted).
+	 * @tparam Args Tipos de los argumentos del constructor.
+	 * @param args Argumentos del constructor.
+	 * @return Un TRefPtr gestionando el nuevo objeto.
+	 */
+	template<typename T, typename... Args>
+	TRefPtr<T> MakeRefCounted(Args&&... args)
+	{
+		return TRefPtr<T>(new T(std::forward<Args>(args)...));
+	}
+}
@@ -27,44 +27,283 @@
  * SOFTWARE.
 */
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <utility>
 
 namespace EngineUtilities {
+	/**
+	 * @brief Modo de recuento de referencias de los punteros compartidos.
+	 *
+	 * NotThreadSafe usa enteros normales y es el ms barato; ThreadSafe usa contadores
+	 * atmicos y permite compartir el mismo objeto entre hilos.
+	 */
+	enum class ESPMode
+	{
+		NotThreadSafe,
+		ThreadSafe
+	};
+
+	/**
+	 * @brief Poltica de recuento de referencias seleccionada por ESPMode.
+	 *
+	 * @tparam Mode El modo de recuento.
+	 */
+	template<ESPMode Mode>
+	struct TRefCounter;
+
+	/**
+	 * @brief Contador no atmico para uso desde un nico hilo.
+	 */
+	template<>
+	struct TRefCounter<ESPMode::NotThreadSafe>
+	{
+		using Type = int32_t;
+
+		static void Increment(Type& Count) { ++Count; }
+
+		/**
+		 * @brief Decrementa el contador.
+		 * @return El nuevo valor del contador.
+		 */
+		static int32_t Decrement(Type& Count) { return --Count; }
+
+		/**
+		 * @brief Incrementa el contador slo si no es cero.
+		 * @return true si se increment.
+		 */
+		static bool IncrementIfNonZero(Type& Count)
+		{
+			if (Count == 0)
+			{
+				return false;
+			}
+			++Count;
+			return true;
+		}
+
+		static int32_t Load(const Type& Count) { return Count; }
+	};
+
+	/**
+	 * @brief Contador atmico para objetos compartidos entre hilos.
+	 *
+	 * Los incrementos son relaxed: quien copia ya tiene una referencia, as que no necesita
+	 * sincronizarse con nadie. Los decrementos son acq_rel para que el hilo que llega a cero
+	 * vea todas las escrituras de los dems hilos antes de destruir el objeto.
+	 */
+	template<>
+	struct TRefCounter<ESPMode::ThreadSafe>
+	{
+		using Type = std::atomic<int32_t>;
+
+		static void Increment(Type& Count) { Count.fetch_add(1, std::memory_order_relaxed); }
+
+		/**
+		 * @brief Decrementa el contador.
+		 * @return El nuevo valor del contador.
+		 */
+		static int32_t Decrement(Type& Count) { return Count.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
+		/**
+		 * @brief Incrementa el contador slo si no es cero, con un bucle compare-and-swap.
+		 *
+		 * Lo usa TWeakPointer::lock: un contador que ya lleg a cero no puede resucitar,
+		 * aunque otro hilo est destruyendo el objeto en ese momento.
+		 *
+		 * @return true si se increment.
+		 */
+		static bool IncrementIfNonZero(Type& Count)
+		{
+			int32_t Expected = Count.load(std::memory_order_relaxed);
+			while (Expected != 0)
+			{
+				if (Count.compare_exchange_weak(Expected, Expected + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		static int32_t Load(const Type& Count) { return Count.load(std::memory_order_acquire); }
+	};
+
+	/**
+	 * @brief Bloque de control de los punteros compartidos.
+	 *
+	 * Guarda el recuento fuerte (nmero de TSharedPointer) y el dbil (nmero de TWeakPointer,
+	 * ms uno mientras quede alguna referencia fuerte). El objeto se destruye cuando el recuento
+	 * fuerte llega a cero y el bloque de control cuando llega a cero el dbil.
+	 *
+	 * @tparam Mode Modo de recuento.
+	 */
+	template<ESPMode Mode>
+	class TReferenceController
+	{
+	public:
+		using CounterPolicy = TRefCounter<Mode>;
+
+		typename CounterPolicy::Type StrongCount; ///< Nmero de referencias fuertes.
+		typename CounterPolicy::Type WeakCount;   ///< Nmero de referencias dbiles (+1 si StrongCount > 0).
+
+		TReferenceController() : StrongCount(1), WeakCount(1) {}
+		virtual ~TReferenceController() {}
+
+		TReferenceController(const TReferenceController&) = delete;
+		TReferenceController& operator=(const TReferenceController&) = delete;
+
+		/**
+		 * @brief Destruye el objeto gestionado. Se llama cuando el recuento fuerte llega a cero.
+		 */
+		virtual void DestroyObject() = 0;
+
+		/**
+		 * @brief Libera el propio bloque de control. Se llama cuando el recuento dbil llega a cero.
+		 */
+		virtual void DestroySelf() { delete this; }
+
+		void AddStrongRef() { CounterPolicy::Increment(StrongCount); }
+
+		/**
+		 * @brief Aade una referencia fuerte slo si el objeto sigue vivo.
+		 * @return true si se aadi la referencia.
+		 */
+		bool TryAddStrongRef() { return CounterPolicy::IncrementIfNonZero(StrongCount); }
+
+		void ReleaseStrongRef()
+		{
+			if (CounterPolicy::Decrement(StrongCount) == 0)
+			{
+				DestroyObject();
+				ReleaseWeakRef();
+			}
+		}
+
+		void AddWeakRef() { CounterPolicy::Increment(WeakCount); }
+
+		void ReleaseWeakRef()
+		{
+			if (CounterPolicy::Decrement(WeakCount) == 0)
+			{
+				DestroySelf();
+			}
+		}
+	};
+
+	/**
+	 * @brief Bloque de control para un objeto reservado aparte con new.
+	 */
+	template<typename T, ESPMode Mode>
+	class TDefaultReferenceController : public TReferenceController<Mode>
+	{
+	public:
+		explicit TDefaultReferenceController(T* InObject) : Object(InObject) {}
+
+		void DestroyObject() override { delete Object; }
+
+	private:
+		T* Object; ///< Objeto gestionado.
+	};
+
+	/**
+	 * @brief Bloque de control que contiene al propio objeto (usado por MakeShared).
+	 *
+	 * Los contadores y el objeto comparten una nica reserva de memoria y quedan contiguos,
+	 * normalmente en la misma lnea de cach.
+	 */
+	template<typename T, ESPMode Mode>
+	class TInlineReferenceController : public TReferenceController<Mode>
+	{
+	public:
+		template<typename... Args>
+		explicit TInlineReferenceController(Args&&... args)
+		{
+			::new (static_cast<void*>(Storage)) T(std::forward<Args>(args)...);
+		}
+
+		T* GetObject() { return std::launder(reinterpret_cast<T*>(Storage)); }
+
+		void DestroyObject() override { GetObject()->~T(); }
+
+	private:
+		alignas(T) unsigned char Storage[sizeof(T)]; ///< Memoria donde vive el objeto.
+	};
+
+	/**
+	 * @brief Bloque de control con el objeto dentro, reservado con una poltica de memoria (usado por AllocateShared).
+	 *
+	 * Guarda una copia de la poltica para devolverle su propia memoria en DestroySelf.
+	 *
+	 * @tparam Alloc Poltica de memoria (Allocate/Deallocate/Reallocate).
+	 */
+	template<typename T, ESPMode Mode, typename Alloc>
+	class TAllocatedReferenceController : public TInlineReferenceController<T, Mode>
+	{
+	public:
+		template<typename... Args>
+		explicit TAllocatedReferenceController(const Alloc& InAllocator, Args&&... args)
+			: TInlineReferenceController<T, Mode>(std::forward<Args>(args)...), Allocator(InAllocator)
+		{
+		}
+
+		void DestroySelf() override
+		{
+			Alloc OwnerAllocator(Allocator);
+			this->~TAllocatedReferenceController();
+			OwnerAllocator.Deallocate(this, sizeof(TAllocatedReferenceController), alignof(TAllocatedReferenceController));
+		}
+
+	private:
+		Alloc Allocator; ///< Poltica de la que sali la memoria del bloque.
+	};
+
 	/**
 	 * @brief Clase TSharedPointer para manejar la gestin de memoria compartida.
 	 *
 	 * La clase TSharedPointer gestiona la memoria de un objeto de tipo T y lleva un
 	 * recuento de referencias para permitir la comparticin segura de un mismo objeto
 	 * en mltiples instancias de TSharedPointer.
+	 *
+	 * @tparam T Tipo del objeto gestionado.
+	 * @tparam Mode Modo de recuento: ESPMode::ThreadSafe para compartir entre hilos.
 	 */
-	template<typename T>
+	template<typename T, ESPMode Mode = ESPMode::NotThreadSafe>
 	class TSharedPointer
 	{
 	public:
+		using CounterPolicy = TRefCounter<Mode>;
+		using ControllerType = TReferenceController<Mode>;
+
 		/**
 		 * @brief Constructor por defecto.
 		 *
-		 * Inicializa el puntero y el recuento de referencias a nullptr.
+		 * Inicializa el puntero y el bloque de control a nullptr.
 		 */
-		TSharedPointer() : ptr(nullptr), refCount(nullptr) {}
+		TSharedPointer() : ptr(nullptr), controller(nullptr) {}
 
 		/**
 		 * @brief Constructor que toma un puntero crudo.
 		 *
 		 * @param rawPtr Puntero crudo al objeto que se va a gestionar.
 		 */
-		explicit TSharedPointer(T* rawPtr) : ptr(rawPtr), refCount(new int(1)) {}
+		explicit TSharedPointer(T* rawPtr)
+			: ptr(rawPtr), controller(rawPtr ? new TDefaultReferenceController<T, Mode>(rawPtr) : nullptr) {}
 
 		/**
-		 * @brief Constructor desde un puntero crudo y un recuento de referencias.
+		 * @brief Constructor desde un puntero crudo y un bloque de control existente.
+		 *
+		 * Aade una referencia fuerte al bloque de control.
 		 *
 		 * @param rawPtr Puntero crudo al objeto gestionado.
-		 * @param existingRefCount Puntero al recuento de referencias existente.
+		 * @param existingController Bloque de control del objeto.
 		 */
-		TSharedPointer(T* rawPtr, int* existingRefCount) : ptr(rawPtr), refCount(existingRefCount)
+		TSharedPointer(T* rawPtr, ControllerType* existingController) : ptr(rawPtr), controller(existingController)
 		{
-			if (refCount)
+			if (controller)
 			{
-				++(*refCount);
+				controller->AddStrongRef();
 			}
 		}
 
@@ -76,11 +315,11 @@ namespace EngineUtilities {
 		 *
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 */
-		TSharedPointer(const TSharedPointer<T>& other) : ptr(other.ptr), refCount(other.refCount)
+		TSharedPointer(const TSharedPointer& other) : ptr(other.ptr), controller(other.controller)
 		{
-			if (refCount)
+			if (controller)
 			{
-				++(*refCount);
+				controller->AddStrongRef();
 			}
 		}
 
@@ -92,10 +331,10 @@ namespace EngineUtilities {
 		 *
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 */
-		TSharedPointer(TSharedPointer<T>&& other) noexcept : ptr(other.ptr), refCount(other.refCount)
+		TSharedPointer(TSharedPointer&& other) noexcept : ptr(other.ptr), controller(other.controller)
 		{
 			other.ptr = nullptr;
-			other.refCount = nullptr;
+			other.controller = nullptr;
 		}
 
 		/**
@@ -107,22 +346,21 @@ namespace EngineUtilities {
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 * @return Referencia al objeto TSharedPointer actual.
 		 */
-		TSharedPointer<T>& operator=(const TSharedPointer<T>& other)
+		TSharedPointer& operator=(const TSharedPointer& other)
 		{
 			if (this != &other)
 			{
 				// Disminuir el recuento de referencias del objeto actual
-				if (refCount && --(*refCount) == 0)
+				if (controller)
 				{
-					delete ptr;
-					delete refCount;
+					controller->ReleaseStrongRef();
 				}
 				// Copiar datos del otro puntero compartido
 				ptr = other.ptr;
-				refCount = other.refCount;
-				if (refCount)
+				controller = other.controller;
+				if (controller)
 				{
-					++(*refCount);
+					controller->AddStrongRef();
 				}
 			}
 			return *this;
@@ -137,21 +375,20 @@ namespace EngineUtilities {
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 * @return Referencia al objeto TSharedPointer actual.
 		 */
-		TSharedPointer<T>& operator=(TSharedPointer<T>&& other) noexcept
+		TSharedPointer& operator=(TSharedPointer&& other) noexcept
 		{
 			if (this != &other)
 			{
 				// Liberar el objeto actual
-				if (refCount && --(*refCount) == 0)
+				if (controller)
 				{
-					delete ptr;
-					delete refCount;
+					controller->ReleaseStrongRef();
 				}
 				// Transferir los datos del otro puntero compartido
 				ptr = other.ptr;
-				refCount = other.refCount;
+				controller = other.controller;
 				other.ptr = nullptr;
-				other.refCount = nullptr;
+				other.controller = nullptr;
 			}
 			return *this;
 		}
@@ -164,10 +401,9 @@ namespace EngineUtilities {
 		 */
 		~TSharedPointer()
 		{
-			if (refCount && --(*refCount) == 0)
+			if (controller)
 			{
-				delete ptr;
-				delete refCount;
+				controller->ReleaseStrongRef();
 			}
 		}
 
@@ -201,7 +437,7 @@ namespace EngineUtilities {
 
 	public:
 		T* ptr;       ///< Puntero al objeto gestionado.
-		int* refCount; ///< Puntero al recuento de referencias.
+		ControllerType* controller; ///< Bloque de control con los recuentos de referencias.
 
 		/**
 		 * @brief Mtodo swap.
@@ -210,16 +446,16 @@ namespace EngineUtilities {
 		 *
 		 * @param other Otro objeto TSharedPointer del mismo tipo T.
 		 */
-		void swap(TSharedPointer<T>& other) noexcept
+		void swap(TSharedPointer& other) noexcept
 		{
 			T* tempPtr = other.ptr;
-			int* tempRefCount = other.refCount;
+			ControllerType* tempController = other.controller;
 
 			other.ptr = this->ptr;
-			other.refCount = this->refCount;
+			other.controller = this->controller;
 
 			this->ptr = tempPtr;
-			this->refCount = tempRefCount;
+			this->controller = tempController;
 		}
 
 		/**
@@ -230,23 +466,22 @@ namespace EngineUtilities {
 		void reset(T* newPtr = nullptr)
 		{
 			// Disminuir el recuento de referencias del objeto actual
-			if (refCount && --(*refCount) == 0)
+			if (controller)
 			{
-				delete ptr;
-				delete refCount;
+				controller->ReleaseStrongRef();
 			}
 
 			// Si newPtr es nullptr, asignar nullptr al puntero y recuento de referencias
 			if (newPtr == nullptr)
 			{
 				ptr = nullptr;
-				refCount = nullptr;
+				controller = nullptr;
 			}
 			else
 			{
 				// Asignar nuevo objeto y manejar el recuento de referencias
 				ptr = newPtr;
-				refCount = new int(1);
+				controller = new TDefaultReferenceController<T, Mode>(newPtr);
 			}
 		}
 	};
@@ -254,14 +489,56 @@ namespace EngineUtilities {
 	/**
 	 * @brief Funcin de utilidad para crear un TSharedPointer.
 	 *
+	 * El objeto y su bloque de control se crean en una nica reserva de memoria, y los
+	 * argumentos se reenvan al constructor de T sin copias intermedias.
+	 *
 	 * @tparam T Tipo del objeto gestionado.
+	 * @tparam Mode Modo de recuento del puntero devuelto.
 	 * @tparam Args Tipos de los argumentos del constructor del objeto gestionado.
 	 * @param args Argumentos del constructor del objeto gestionado.
 	 * @return Un objeto TSharedPointer gestionando un nuevo objeto de tipo T.
 	 */
-	template<typename T, typename... Args>
-	TSharedPointer<T> MakeShared(Args... args)
+	template<typename T, ESPMode Mode = ESPMode::NotThreadSafe, typename... Args>
+	TSharedPointer<T, Mode> MakeShared(Args&&... args)
+	{
+		TInlineReferenceController<T, Mode>* Controller = new TInlineReferenceController<T, Mode>(std::forward<Args>(args)...);
+		TSharedPointer<T, Mode> Result;
+		Result.ptr = Controller->GetObject();
+		Result.controller = Controller;  ///< El bloque nace con una referencia fuerte, que pasa a Result.
+		return Result;
+	}
+
+	/**
+	 * @brief Crea un TSharedPointer cuyo objeto y bloque de control se reservan con una poltica de memoria.
+	 *
+	 * Igual que MakeShared, pero la nica reserva sale de Allocator (FHeapAllocator,
+	 * TArenaAllocator, ...), que recibe la memoria de vuelta cuando muere la ltima referencia.
+	 *
+	 * @tparam T Tipo del objeto gestionado.
+	 * @tparam Mode Modo de recuento del puntero devuelto.
+	 * @param Allocator Instancia de la poltica; el bloque de control guarda una copia.
+	 * @param args Argumentos del constructor del objeto gestionado.
+	 * @return Un objeto TSharedPointer gestionando un nuevo objeto de tipo T.
+	 */
+	template<typename T, ESPMode Mode = ESPMode::NotThreadSafe, typename Alloc, typename... Args>
+	TSharedPointer<T, Mode> AllocateShared(const Alloc& Allocator, Args&&... args)
 	{
-		return TSharedPointer<T>(new T(args...));
+		using ControllerType = TAllocatedReferenceController<T, Mode, Alloc>;
+		Alloc OwnerAllocator(Allocator);
+		void* Memory = OwnerAllocator.Allocate(sizeof(ControllerType), alignof(ControllerType));
+		ControllerType* Controller;
+		try
+		{
+			Controller = ::new (Memory) ControllerType(Allocator, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			OwnerAllocator.Deallocate(Memory, sizeof(ControllerType), alignof(ControllerType));
+			throw;
+		}
+		TSharedPointer<T, Mode> Result;
+		Result.ptr = Controller->GetObject();
+		Result.controller = Controller;  ///< El bloque nace con una referencia fuerte, que pasa a Result.
+		return Result;
 	}
 }
@@ -27,17 +27,55 @@
  * SOFTWARE.
 */
 #pragma once
+#include <new>
+#include <utility>
 
 namespace EngineUtilities {
+  /**
+   * @brief Borrador por defecto de TUniquePtr: destruye el objeto con delete.
+   */
+  template<typename T>
+  struct TDefaultDelete
+  {
+    void operator()(T* rawPtr) const { delete rawPtr; }
+  };
+
+  /**
+   * @brief Borrador para objetos creados con AllocateUnique.
+   *
+   * Destruye el objeto y devuelve su memoria a la poltica de memoria con la que se reserv
+   * (FHeapAllocator, un arena, un pool...).
+   *
+   * @tparam T Tipo del objeto gestionado.
+   * @tparam Alloc Poltica de memoria (Allocate/Deallocate/Reallocate).
+   */
+  template<typename T, typename Alloc>
+  struct TAllocatorDelete
+  {
+    Alloc allocator; ///< Poltica de la que sali la memoria del objeto.
+
+    TAllocatorDelete() = default;
+    explicit TAllocatorDelete(const Alloc& inAllocator) : allocator(inAllocator) {}
+
+    void operator()(T* rawPtr)
+    {
+      rawPtr->~T();
+      allocator.Deallocate(rawPtr, sizeof(T), alignof(T));
+    }
+  };
+
   /**
  * @brief Clase TUniquePtr para manejo exclusivo de memoria.
  *
  * La clase TUniquePtr gestiona la memoria de un objeto de tipo T y garantiza
  * que solo una instancia de TUniquePtr puede poseer y gestionar el objeto en
  * cualquier momento.
+ *
+ * El objeto se libera con Deleter (por defecto delete). El borrador se guarda como base
+ * vaca, as que uno sin estado no aumenta el tamao del puntero.
  */
-  template<typename T>
-  class TUniquePtr
+  template<typename T, typename Deleter = TDefaultDelete<T>>
+  class TUniquePtr : private Deleter
   {
   public:
     /**
@@ -54,6 +92,14 @@ namespace EngineUtilities {
      */
     explicit TUniquePtr(T* rawPtr) : ptr(rawPtr) {}
 
+    /**
+     * @brief Constructor que toma un puntero crudo y el borrador que lo liberar.
+     *
+     * @param rawPtr Puntero crudo al objeto que se va a gestionar.
+     * @param deleter Borrador a utilizar.
+     */
+    TUniquePtr(T* rawPtr, const Deleter& deleter) : Deleter(deleter), ptr(rawPtr) {}
+
     /**
      * @brief Constructor de movimiento.
      *
@@ -61,7 +107,7 @@ namespace EngineUtilities {
      *
      * @param other Otro objeto TUniquePtr del mismo tipo T.
      */
-    TUniquePtr(TUniquePtr<T>&& other) noexcept : ptr(other.ptr)
+    TUniquePtr(TUniquePtr&& other) noexcept : Deleter(std::move(other.getDeleter())), ptr(other.ptr)
     {
       other.ptr = nullptr;
     }
@@ -75,14 +121,15 @@ namespace EngineUtilities {
      * @param other Otro objeto TUniquePtr del mismo tipo T.
      * @return Referencia al objeto TUniquePtr actual.
      */
-    TUniquePtr<T>& operator=(TUniquePtr<T>&& other) noexcept
+    TUniquePtr& operator=(TUniquePtr&& other) noexcept
     {
       if (this != &other)
       {
         // Liberar el objeto actual
-        delete ptr;
+        destroy();
 
-        // Transferir los datos del otro puntero exclusivo
+        // Transferir los datos (y el borrador) del otro puntero exclusivo
+        getDeleter() = std::move(other.getDeleter());
         ptr = other.ptr;
         other.ptr = nullptr;
       }
@@ -96,12 +143,12 @@ namespace EngineUtilities {
      */
     ~TUniquePtr()
     {
-      delete ptr;
+      destroy();
     }
 
     // Prohibir la copia de TUniquePtr
-    TUniquePtr(const TUniquePtr<T>&) = delete;
-    TUniquePtr<T>& operator=(const TUniquePtr<T>&) = delete;
+    TUniquePtr(const TUniquePtr&) = delete;
+    TUniquePtr& operator=(const TUniquePtr&) = delete;
 
     /**
      * @brief Operador de desreferenciacin.
@@ -147,7 +194,7 @@ namespace EngineUtilities {
      */
     void reset(T* rawPtr = nullptr)
     {
-      delete ptr;
+      destroy();
       ptr = rawPtr;
     }
 
@@ -160,7 +207,25 @@ namespace EngineUtilities {
     {
       return ptr == nullptr;
     }
+
+    /**
+     * @brief Obtener el borrador que liberar el objeto.
+     */
+    Deleter& getDeleter() { return *this; }
+    const Deleter& getDeleter() const { return *this; }
+
   private:
+    /**
+     * @brief Libera el objeto actual, si existe, con el borrador.
+     */
+    void destroy()
+    {
+      if (ptr)
+      {
+        getDeleter()(ptr);
+      }
+    }
+
     T* ptr; ///< Puntero al objeto gestionado.
   };
 
@@ -178,6 +243,33 @@ namespace EngineUtilities {
     return TUniquePtr<T>(new T(args...));
   }
 
+  /**
+   * @brief Crea un TUniquePtr cuyo objeto se reserva con una poltica de memoria.
+   *
+   * @tparam T Tipo del objeto gestionado.
+   * @tparam Alloc Poltica de memoria (FHeapAllocator, TArenaAllocator, ...).
+   * @param allocator Instancia de la poltica; el borrador guarda una copia.
+   * @param args Argumentos del constructor del objeto gestionado.
+   * @return Un TUniquePtr que devolver la memoria a la poltica al destruirse.
+   */
+  template<typename T, typename Alloc, typename... Args>
+  TUniquePtr<T, TAllocatorDelete<T, Alloc>> AllocateUnique(const Alloc& allocator, Args&&... args)
+  {
+    TAllocatorDelete<T, Alloc> deleter(allocator);
+    void* memory = deleter.allocator.Allocate(sizeof(T), alignof(T));
+    T* object;
+    try
+    {
+      object = ::new (memory) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      deleter.allocator.Deallocate(memory, sizeof(T), alignof(T));
+      throw;
+    }
+    return TUniquePtr<T, TAllocatorDelete<T, Alloc>>(object, deleter);
+  }
+
   /*
   // Ejemplo de uso de TUniquePtr
   class MyClass
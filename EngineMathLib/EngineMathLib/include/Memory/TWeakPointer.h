@@ -36,45 +36,157 @@ namespace EngineUtilities {
 		 * La clase TWeakPointer proporciona una manera de observar un objeto gestionado por un TSharedPointer
 		 * sin tener influencia sobre el recuento de referencias del objeto. Permite acceder al objeto solo si
 		 * an existe.
+		 *
+		 * @tparam T Tipo del objeto observado.
+		 * @tparam Mode Modo de recuento, igual al del TSharedPointer observado.
 		 */
-	template<typename T>
+	template<typename T, ESPMode Mode = ESPMode::NotThreadSafe>
 	class TWeakPointer
 	{
 	public:
 		/**
 		 * @brief Constructor por defecto.
 		 */
-		TWeakPointer() : ptr(nullptr), refCount(nullptr) {}
+		TWeakPointer() : ptr(nullptr), controller(nullptr) {}
 
 		/**
 		 * @brief Constructor que toma un TSharedPointer.
 		 *
+		 * Aade una referencia dbil al bloque de control, que permanece vivo (aunque el
+		 * objeto se destruya) hasta que se libere el ltimo TWeakPointer.
+		 *
 		 * @param sharedPtr TSharedPointer desde el cual se observar el objeto.
 		 */
-		TWeakPointer(const TSharedPointer<T>& sharedPtr) 
-		: ptr(sharedPtr.ptr), refCount(sharedPtr.refCount) {}
+		TWeakPointer(const TSharedPointer<T, Mode>& sharedPtr) 
+		: ptr(sharedPtr.ptr), controller(sharedPtr.controller)
+		{
+			if (controller)
+			{
+				controller->AddWeakRef();
+			}
+		}
+
+		/**
+		 * @brief Constructor de copia.
+		 *
+		 * @param other Otro TWeakPointer del mismo tipo.
+		 */
+		TWeakPointer(const TWeakPointer& other) : ptr(other.ptr), controller(other.controller)
+		{
+			if (controller)
+			{
+				controller->AddWeakRef();
+			}
+		}
+
+		/**
+		 * @brief Constructor de movimiento.
+		 *
+		 * @param other Otro TWeakPointer del mismo tipo.
+		 */
+		TWeakPointer(TWeakPointer&& other) noexcept : ptr(other.ptr), controller(other.controller)
+		{
+			other.ptr = nullptr;
+			other.controller = nullptr;
+		}
+
+		/**
+		 * @brief Operador de asignacin de copia.
+		 *
+		 * @param other Otro TWeakPointer del mismo tipo.
+		 * @return Referencia al TWeakPointer actual.
+		 */
+		TWeakPointer& operator=(const TWeakPointer& other)
+		{
+			if (this != &other)
+			{
+				if (other.controller)
+				{
+					other.controller->AddWeakRef();
+				}
+				reset();
+				ptr = other.ptr;
+				controller = other.controller;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Operador de asignacin de movimiento.
+		 *
+		 * @param other Otro TWeakPointer del mismo tipo.
+		 * @return Referencia al TWeakPointer actual.
+		 */
+		TWeakPointer& operator=(TWeakPointer&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				ptr = other.ptr;
+				controller = other.controller;
+				other.ptr = nullptr;
+				other.controller = nullptr;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Destructor. Libera la referencia dbil.
+		 */
+		~TWeakPointer()
+		{
+			reset();
+		}
 
 		/**
 		 * @brief Convertir TWeakPointer a TSharedPointer.
 		 *
+		 * El recuento fuerte se incrementa con compare-and-swap slo si no es cero, por lo que
+		 * es seguro llamar a lock() mientras otro hilo libera la ltima referencia fuerte.
+		 *
 		 * @return Un TSharedPointer al objeto gestionado, o nullptr si el objeto ha sido destruido.
 		 */
-		TSharedPointer<T> lock() const
+		TSharedPointer<T, Mode> lock() const
+		{
+			TSharedPointer<T, Mode> result;
+			if (controller && controller->TryAddStrongRef())
+			{
+				result.ptr = ptr;
+				result.controller = controller;  ///< La referencia recin aadida pasa a result.
+			}
+			return result;
+		}
+
+		/**
+		 * @brief Comprobar si el objeto observado ya fue destruido.
+		 *
+		 * @return true si no queda ninguna referencia fuerte al objeto.
+		 */
+		bool isExpired() const
+		{
+			return controller == nullptr || TSharedPointer<T, Mode>::CounterPolicy::Load(controller->StrongCount) == 0;
+		}
+
+		/**
+		 * @brief Deja de observar el objeto y libera la referencia dbil.
+		 */
+		void reset()
 		{
-			if (refCount && *refCount > 0)
+			if (controller)
 			{
-				return TSharedPointer<T>(ptr, refCount);
+				controller->ReleaseWeakRef();
 			}
-			return TSharedPointer<T>();
+			ptr = nullptr;
+			controller = nullptr;
 		}
 
 		// Hacer que TSharedPointer sea un amigo para acceder a los miembros privados.
-		template<typename U>
+		template<typename U, ESPMode M>
 		friend class TSharedPointer;
 
 	private:
 		T* ptr;       ///< Puntero al objeto observado.
-		int* refCount; ///< Puntero al recuento de referencias del TSharedPointer original.
+		typename TSharedPointer<T, Mode>::ControllerType* controller; ///< Bloque de control del TSharedPointer original.
 	};
 
 	/*
@@ -0,0 +1,373 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Structures/TArray.h"
+
+namespace EngineUtilities {
+	/**
+	 * @brief Comparador por defecto de Sort: ordena de menor a mayor con operator<.
+	 */
+	template<typename T>
+	struct TLess
+	{
+		bool operator()(const T& A, const T& B) const
+		{
+			return A < B;
+		}
+	};
+
+	/**
+	 * @brief Extractor de clave por defecto de RadixSort: el propio elemento es la clave.
+	 */
+	template<typename T>
+	struct TIdentityKey
+	{
+		const T& operator()(const T& Element) const
+		{
+			return Element;
+		}
+	};
+
+	/**
+	 * @brief Ordena por insercin el rango [First, Last). Estable; slo conviene en rangos cortos.
+	 */
+	template<typename T, typename LessFn>
+	void InsertionSortRange(T* First, T* Last, LessFn& Less)
+	{
+		for (T* Current = First + 1; Current < Last; ++Current)
+		{
+			if (!Less(*Current, *(Current - 1)))
+			{
+				continue;
+			}
+			T Value(std::move(*Current));
+			T* Hole = Current;
+			do
+			{
+				*Hole = std::move(*(Hole - 1));
+				--Hole;
+			} while (Hole > First && Less(Value, *(Hole - 1)));
+			*Hole = std::move(Value);
+		}
+	}
+
+	/**
+	 * @brief Hunde el elemento Root del montculo mximo First[0, Count).
+	 */
+	template<typename T, typename LessFn>
+	void SiftDown(T* First, size_t Root, size_t Count, LessFn& Less)
+	{
+		T Value(std::move(First[Root]));
+		size_t Child;
+		while ((Child = 2 * Root + 1) < Count)
+		{
+			if (Child + 1 < Count && Less(First[Child], First[Child + 1]))
+			{
+				++Child;
+			}
+			if (!Less(Value, First[Child]))
+			{
+				break;
+			}
+			First[Root] = std::move(First[Child]);
+			Root = Child;
+		}
+		First[Root] = std::move(Value);
+	}
+
+	/**
+	 * @brief Ordena [First, Last) con heapsort: O(n log n) garantizado, pero con peor localidad que quicksort.
+	 */
+	template<typename T, typename LessFn>
+	void HeapSortRange(T* First, T* Last, LessFn& Less)
+	{
+		size_t Count = static_cast<size_t>(Last - First);
+		for (size_t i = Count / 2; i > 0; --i)
+		{
+			SiftDown(First, i - 1, Count, Less);
+		}
+		for (size_t End = Count; End > 1; --End)
+		{
+			std::swap(First[0], First[End - 1]);
+			SiftDown(First, 0, End - 1, Less);
+		}
+	}
+
+	/**
+	 * @brief Bucle principal de introsort sobre [First, Last).
+	 *
+	 * Quicksort con pivote mediana de tres: tras ordenar el primero, el central y el ltimo,
+	 * los extremos hacen de centinela y los bucles de particin no comprueban lmites. Se
+	 * recurre sobre la mitad menor y se itera sobre la mayor, as que la pila queda en
+	 * O(log n). Si la profundidad se agota el rango se termina con heapsort, y los rangos de
+	 * hasta InsertionThreshold elementos se dejan a la ordenacin por insercin.
+	 */
+	template<typename T, typename LessFn>
+	void IntroSortLoop(T* First, T* Last, size_t DepthLimit, LessFn& Less)
+	{
+		const ptrdiff_t InsertionThreshold = 16;
+		while (Last - First > InsertionThreshold)
+		{
+			if (DepthLimit == 0)
+			{
+				HeapSortRange(First, Last, Less);
+				return;
+			}
+			--DepthLimit;
+
+			T* Middle = First + (Last - First) / 2;
+			if (Less(*Middle, *First))
+			{
+				std::swap(*Middle, *First);
+			}
+			if (Less(*(Last - 1), *Middle))
+			{
+				std::swap(*(Last - 1), *Middle);
+				if (Less(*Middle, *First))
+				{
+					std::swap(*Middle, *First);
+				}
+			}
+			// *First <= mediana <= *(Last - 1). El pivote se aparca en First + 1.
+			std::swap(*Middle, *(First + 1));
+			T* Pivot = First + 1;
+			T* Left = First + 1;
+			T* Right = Last - 1;
+			while (true)
+			{
+				do
+				{
+					++Left;
+				} while (Less(*Left, *Pivot));
+				do
+				{
+					--Right;
+				} while (Less(*Pivot, *Right));
+				if (Left >= Right)
+				{
+					break;
+				}
+				std::swap(*Left, *Right);
+			}
+			std::swap(*Pivot, *Right);
+
+			// [First, Right) <= pivote <= (Right, Last).
+			if (Right - First < Last - (Right + 1))
+			{
+				IntroSortLoop(First, Right, DepthLimit, Less);
+				First = Right + 1;
+			}
+			else
+			{
+				IntroSortLoop(Right + 1, Last, DepthLimit, Less);
+				Last = Right;
+			}
+		}
+		if (Last - First > 1)
+		{
+			InsertionSortRange(First, Last, Less);
+		}
+	}
+
+	/**
+	 * @brief Ordena [First, Last) en el sitio con introsort.
+	 *
+	 * O(n log n) en el peor caso y sin memoria adicional. No es estable.
+	 *
+	 * @param First Primer elemento.
+	 * @param Last Uno ms all del ltimo elemento.
+	 * @param Less Comparador de orden estricto dbil con la firma bool(const T&, const T&).
+	 */
+	template<typename T, typename LessFn = TLess<T>>
+	void SortRange(T* First, T* Last, LessFn Less = LessFn())
+	{
+		size_t DepthLimit = 0;
+		for (size_t Count = static_cast<size_t>(Last - First); Count > 1; Count >>= 1)
+		{
+			DepthLimit += 2;
+		}
+		IntroSortLoop(First, Last, DepthLimit, Less);
+	}
+
+	/**
+	 * @brief Ordena un TArray en el sitio con introsort. No es estable.
+	 *
+	 * @param Array El array a ordenar.
+	 * @param Less Comparador con la firma bool(const T&, const T&); por defecto operator<.
+	 */
+	template<typename T, typename Alloc, typename LessFn = TLess<T>>
+	void Sort(TArray<T, Alloc>& Array, LessFn Less = LessFn())
+	{
+		SortRange(Array.begin(), Array.end(), Less);
+	}
+
+	/**
+	 * @brief Convierte una clave entera en un entero sin signo que se ordena igual.
+	 *
+	 * Los enteros con signo invierten el bit de signo para que los negativos queden delante.
+	 */
+	template<typename K>
+	typename std::enable_if<std::is_integral<K>::value && !std::is_same<K, bool>::value, typename std::make_unsigned<K>::type>::type
+		ToRadixKey(K Key)
+	{
+		using U = typename std::make_unsigned<K>::type;
+		U Bits = static_cast<U>(Key);
+		if (std::is_signed<K>::value)
+		{
+			Bits = static_cast<U>(Bits ^ (static_cast<U>(1) << (sizeof(U) * 8 - 1)));
+		}
+		return Bits;
+	}
+
+	/**
+	 * @brief Convierte un float en un uint32_t que se ordena igual.
+	 *
+	 * Los positivos encienden el bit de signo y los negativos invierten todos los bits, de modo
+	 * que -0.0 queda justo delante de +0.0 y los NaN en los extremos segn su signo.
+	 */
+	inline uint32_t ToRadixKey(float Key)
+	{
+		uint32_t Bits;
+		std::memcpy(&Bits, &Key, sizeof(Bits));
+		return (Bits & 0x80000000u) ? ~Bits : (Bits | 0x80000000u);
+	}
+
+	/**
+	 * @brief Convierte un double en un uint64_t que se ordena igual. Ver ToRadixKey(float).
+	 */
+	inline uint64_t ToRadixKey(double Key)
+	{
+		uint64_t Bits;
+		std::memcpy(&Bits, &Key, sizeof(Bits));
+		return (Bits & 0x8000000000000000ull) ? ~Bits : (Bits | 0x8000000000000000ull);
+	}
+
+	/**
+	 * @brief Tipo sin signo que ToRadixKey devuelve para las claves que extrae KeyFn de un T.
+	 */
+	template<typename T, typename KeyFn>
+	using TRadixKey = decltype(ToRadixKey(std::declval<KeyFn&>()(std::declval<const T&>())));
+
+	/**
+	 * @brief Ordena Data[0, Count) por radix LSD con dgitos de 8 bits, usando Scratch como bfer auxiliar.
+	 *
+	 * Un nico recorrido inicial cuenta los histogramas de todos los dgitos; las pasadas en
+	 * las que todas las claves comparten dgito no cambian el orden y se saltan, as que claves
+	 * de 64 bits con los bits altos a cero cuestan slo las pasadas de sus bytes tiles. Cada
+	 * pasada reparte de un bfer al otro y, si el resultado acaba en Scratch, se copia de vuelta.
+	 *
+	 * @param Data Elementos a ordenar. Deben ser trivialmente copiables.
+	 * @param Count Nmero de elementos.
+	 * @param Scratch Bfer de al menos Count elementos; su contenido se sobrescribe.
+	 * @param Key Funcin con la firma K(const T&), donde K es entero, float o double.
+	 */
+	template<typename T, typename KeyFn>
+	void RadixSortRange(T* Data, size_t Count, T* Scratch, KeyFn& Key)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "RadixSort requiere elementos trivialmente copiables.");
+		using KeyType = TRadixKey<T, KeyFn>;
+		const size_t NumPasses = sizeof(KeyType);
+
+		size_t Counts[NumPasses][256] = {};
+		for (size_t i = 0; i < Count; ++i)
+		{
+			KeyType Bits = ToRadixKey(Key(Data[i]));
+			for (size_t Pass = 0; Pass < NumPasses; ++Pass)
+			{
+				++Counts[Pass][(Bits >> (Pass * 8)) & 0xFF];
+			}
+		}
+
+		T* Source = Data;
+		T* Destination = Scratch;
+		for (size_t Pass = 0; Pass < NumPasses; ++Pass)
+		{
+			size_t* Offsets = Counts[Pass];
+			size_t Sum = 0;
+			bool bSkip = false;
+			for (size_t Digit = 0; Digit < 256; ++Digit)
+			{
+				bSkip = bSkip || Offsets[Digit] == Count;
+				size_t Bucket = Offsets[Digit];
+				Offsets[Digit] = Sum;
+				Sum += Bucket;
+			}
+			if (bSkip)
+			{
+				continue;
+			}
+			const size_t Shift = Pass * 8;
+			for (size_t i = 0; i < Count; ++i)
+			{
+				size_t Digit = (ToRadixKey(Key(Source[i])) >> Shift) & 0xFF;
+				Destination[Offsets[Digit]++] = Source[i];
+			}
+			std::swap(Source, Destination);
+		}
+		if (Source != Data)
+		{
+			std::memcpy(static_cast<void*>(Data), Source, Count * sizeof(T));
+		}
+	}
+
+	/**
+	 * @brief Ordena un TArray de forma estable por radix LSD segn la clave que extrae Key.
+	 *
+	 * O(n) por pasada y como mucho sizeof(clave) pasadas; suele ganar a Sort a partir de unos
+	 * miles de elementos con claves de 32 o 64 bits. El bfer auxiliar de Num() elementos se
+	 * pide al asignador del propio array. Los arrays muy cortos se ordenan por insercin.
+	 *
+	 * @param Array El array a ordenar. Sus elementos deben ser trivialmente copiables.
+	 * @param Key Funcin con la firma K(const T&), donde K es entero, float o double; por defecto el propio elemento.
+	 */
+	template<typename T, typename Alloc, typename KeyFn = TIdentityKey<T>>
+	void RadixSort(TArray<T, Alloc>& Array, KeyFn Key = KeyFn())
+	{
+		const size_t Count = Array.Num();
+		if (Count < 64)
+		{
+			auto Less = [&Key](const T& A, const T& B) { return ToRadixKey(Key(A)) < ToRadixKey(Key(B)); };
+			if (Count > 1)
+			{
+				InsertionSortRange(Array.begin(), Array.end(), Less);
+			}
+			return;
+		}
+		Alloc Allocator(Array.GetAllocator());
+		T* Scratch = static_cast<T*>(Allocator.Allocate(Count * sizeof(T), alignof(T)));
+		RadixSortRange(Array.GetData(), Count, Scratch, Key);
+		Allocator.Deallocate(Scratch, Count * sizeof(T), alignof(T));
+	}
+}
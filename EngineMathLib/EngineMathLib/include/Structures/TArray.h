@@ -26,8 +26,25 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
 */
-
 #pragma once
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Memory/HeapAllocator.h"
+
+// operator[] de TArray y TInlineArray comprueba el ndice slo si ENGINEUTILITIES_CHECK_BOUNDS
+// vale 1 (por defecto, en las compilaciones sin NDEBUG). At() lo comprueba siempre.
+#if !defined(ENGINEUTILITIES_CHECK_BOUNDS)
+#if defined(NDEBUG)
+#define ENGINEUTILITIES_CHECK_BOUNDS 0
+#else
+#define ENGINEUTILITIES_CHECK_BOUNDS 1
+#endif
+#endif
+
 namespace EngineUtilities {
 	/**
 	 * @brief TArray es una clase de array dinmica para almacenar elementos de tipo T.
@@ -36,16 +53,108 @@ namespace EngineUtilities {
 	 * colecciones de elementos, con operaciones bsicas como agregar, eliminar y acceder a elementos.
 	 * La memoria se gestiona dinmicamente, aumentando la capacidad del array segn sea necesario.
 	 *
+	 * El almacenamiento es memoria cruda sin inicializar: los elementos se construyen en su
+	 * sitio (placement new) slo cuando se aaden, y al crecer se reubican movindolos, o con
+	 * un nico memcpy si T es trivialmente reubicable (TIsTriviallyRelocatable). En ese caso
+	 * el bloque crece con Alloc::Reallocate, que puede ampliarlo sin copiar.
+	 *
+	 * La memoria se pide a la poltica Alloc (ver FHeapAllocator). El array guarda su propia
+	 * instancia de la poltica; una poltica sin estado no aumenta su tamao.
+	 *
 	 * @tparam T El tipo de elementos almacenados en el array.
+	 * @tparam Alloc La poltica de memoria (por defecto FHeapAllocator).
 	 */
-	template<typename T>
-	class TArray
+	template<typename T, typename Alloc = FHeapAllocator>
+	class TArray : private Alloc
 	{
 	private:
 		T* Data;           ///< Puntero a la memoria donde se almacenan los elementos del array.
 		size_t Capacity;   ///< Capacidad actual del array (nmero de elementos que puede almacenar).
 		size_t Size;       ///< Nmero de elementos actualmente en el array.
 
+		static constexpr bool bTriviallyRelocatable = TIsTriviallyRelocatable<T>::value;
+
+		/**
+		 * @brief Reserva memoria cruda para Count elementos sin construirlos.
+		 *
+		 * @param Count El nmero de elementos.
+		 * @return Puntero al bloque reservado.
+		 */
+		T* Allocate(size_t Count)
+		{
+			return static_cast<T*>(GetAllocator().Allocate(Count * sizeof(T), alignof(T)));
+		}
+
+		/**
+		 * @brief Libera un bloque obtenido con Allocate. No destruye los elementos.
+		 *
+		 * @param Block El bloque a liberar (puede ser nulo).
+		 * @param Count La capacidad, en elementos, con la que se reserv.
+		 */
+		void Deallocate(T* Block, size_t Count)
+		{
+			if (Block != nullptr)
+			{
+				GetAllocator().Deallocate(Block, Count * sizeof(T), alignof(T));
+			}
+		}
+
+		/**
+		 * @brief Reubica Count elementos de Source a Dest (memoria sin inicializar).
+		 *
+		 * Los elementos de Source quedan destruidos al terminar.
+		 *
+		 * @param Dest Bloque de destino.
+		 * @param Source Bloque de origen.
+		 * @param Count Nmero de elementos a reubicar.
+		 */
+		static void Relocate(T* Dest, T* Source, size_t Count)
+		{
+			if constexpr (bTriviallyRelocatable)
+			{
+				if (Count > 0)
+				{
+					std::memcpy(static_cast<void*>(Dest), static_cast<const void*>(Source), Count * sizeof(T));
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < Count; ++i)
+				{
+					::new (static_cast<void*>(Dest + i)) T(std::move_if_noexcept(Source[i]));
+					Source[i].~T();
+				}
+			}
+		}
+
+		/**
+		 * @brief Destruye los elementos construidos en el rango [0, Count).
+		 *
+		 * @param Count Nmero de elementos a destruir.
+		 */
+		void DestroyElements(size_t Count)
+		{
+			if constexpr (!std::is_trivially_destructible<T>::value)
+			{
+				for (size_t i = 0; i < Count; ++i)
+				{
+					Data[i].~T();
+				}
+			}
+		}
+
+		/**
+		 * @brief Termina el programa si Index no es una posicin vlida.
+		 */
+		void CheckIndex(size_t Index) const
+		{
+			if (Index >= Size)
+			{
+				std::cerr << "Index out of range" << std::endl;  ///< Manejar el caso de ndice fuera de rango.
+				exit(1);  ///< Salir del programa en caso de error.
+			}
+		}
+
 		/**
 		 * @brief Redimensiona el array para tener una nueva capacidad.
 		 *
@@ -53,75 +162,371 @@ namespace EngineUtilities {
 		 */
 		void Resize(size_t NewCapacity)
 		{
-			T* NewData = new T[NewCapacity];  ///< Crear un nuevo bloque de memoria con la nueva capacidad.
-			for (size_t i = 0; i < Size; ++i)
+			if constexpr (bTriviallyRelocatable)
 			{
-				NewData[i] = Data[i];  ///< Copiar los elementos existentes al nuevo bloque de memoria.
+				// Los bytes se pueden mover tal cual: la poltica puede crecer el bloque en su sitio.
+				Data = static_cast<T*>(GetAllocator().Reallocate(Data, Capacity * sizeof(T), NewCapacity * sizeof(T), alignof(T)));
+			}
+			else
+			{
+				T* NewData = Allocate(NewCapacity);  ///< Reservar memoria cruda sin construir elementos.
+				Relocate(NewData, Data, Size);       ///< Mover los elementos existentes.
+				Deallocate(Data, Capacity);  ///< Liberar la memoria del array antiguo.
+				Data = NewData; ///< Actualizar el puntero Data para que apunte al nuevo bloque de memoria.
 			}
-			delete[] Data;  ///< Liberar la memoria del array antiguo.
-			Data = NewData; ///< Actualizar el puntero Data para que apunte al nuevo bloque de memoria.
 			Capacity = NewCapacity;  ///< Actualizar la capacidad del array.
 		}
 
+		/**
+		 * @brief Construye un nuevo elemento al final cuando el array est lleno.
+		 *
+		 * El elemento se construye antes de liberar el bloque antiguo, de modo que los
+		 * argumentos pueden referirse a elementos del propio array (p. ej. Add(A[0])). Con
+		 * elementos trivialmente reubicables se construye en un temporal y el bloque crece con
+		 * Reallocate; si no, se construye directamente en el bloque nuevo.
+		 *
+		 * @param args Argumentos del constructor del nuevo elemento.
+		 * @return Referencia al elemento construido.
+		 */
+		template<typename... Args>
+		T& EmplaceGrow(Args&&... args)
+		{
+			size_t NewCapacity = Capacity == 0 ? 1 : Capacity * 2;
+			if constexpr (bTriviallyRelocatable)
+			{
+				T Element(std::forward<Args>(args)...);
+				Resize(NewCapacity);
+				::new (static_cast<void*>(Data + Size)) T(std::move(Element));
+				return Data[Size++];
+			}
+			T* NewData = Allocate(NewCapacity);
+			try
+			{
+				::new (static_cast<void*>(NewData + Size)) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				Deallocate(NewData, NewCapacity);
+				throw;
+			}
+			Relocate(NewData, Data, Size);
+			Deallocate(Data, Capacity);
+			Data = NewData;
+			Capacity = NewCapacity;
+			return Data[Size++];
+		}
+
 	public:
 		/**
 		 * @brief Constructor por defecto que inicializa el array con capacidad y tamao cero.
 		 */
 		TArray() : Data(nullptr), Capacity(0), Size(0)	{}
 
+		/**
+		 * @brief Constructor que usa una instancia concreta de la poltica de memoria.
+		 *
+		 * @param InAllocator La poltica de la que se pedir la memoria.
+		 */
+		explicit TArray(const Alloc& InAllocator) : Alloc(InAllocator), Data(nullptr), Capacity(0), Size(0) {}
+
+		/**
+		 * @brief Constructor de copia. Copia los elementos (y la poltica de memoria) de otro array.
+		 *
+		 * @param Other El array a copiar.
+		 */
+		TArray(const TArray& Other) : Alloc(Other.GetAllocator()), Data(nullptr), Capacity(0), Size(0)
+		{
+			if (Other.Size > 0)
+			{
+				Data = Allocate(Other.Size);
+				Capacity = Other.Size;
+				for (; Size < Other.Size; ++Size)
+				{
+					::new (static_cast<void*>(Data + Size)) T(Other.Data[Size]);
+				}
+			}
+		}
+
+		/**
+		 * @brief Constructor de movimiento. Toma la memoria del otro array sin copiar.
+		 *
+		 * @param Other El array del que se toma la memoria.
+		 */
+		TArray(TArray&& Other) noexcept : Alloc(std::move(Other.GetAllocator())), Data(Other.Data), Capacity(Other.Capacity), Size(Other.Size)
+		{
+			Other.Data = nullptr;
+			Other.Capacity = 0;
+			Other.Size = 0;
+		}
+
+		/**
+		 * @brief Operador de asignacin de copia.
+		 *
+		 * @param Other El array a copiar.
+		 * @return Referencia a este array.
+		 */
+		TArray& operator=(const TArray& Other)
+		{
+			if (this != &Other)
+			{
+				TArray Copy(Other);
+				*this = std::move(Copy);
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Operador de asignacin de movimiento. La poltica de memoria viaja con el bloque.
+		 *
+		 * @param Other El array del que se toma la memoria.
+		 * @return Referencia a este array.
+		 */
+		TArray& operator=(TArray&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				DestroyElements(Size);
+				Deallocate(Data, Capacity);
+				GetAllocator() = std::move(Other.GetAllocator());
+				Data = Other.Data;
+				Capacity = Other.Capacity;
+				Size = Other.Size;
+				Other.Data = nullptr;
+				Other.Capacity = 0;
+				Other.Size = 0;
+			}
+			return *this;
+		}
+
 		/**
 		 * @brief Destructor que libera la memoria asignada al array.
 		 */
 		~TArray()	{
-			delete[] Data;  ///< Liberar la memoria del array.
+			DestroyElements(Size);  ///< Destruir los elementos construidos.
+			Deallocate(Data, Capacity);  ///< Liberar la memoria del array.
 		}
 
 		/**
-		 * @brief Aade un nuevo elemento al final del array.
+		 * @brief Construye un nuevo elemento al final del array a partir de los argumentos dados.
 		 *
-		 * @param Element El elemento a aadir al array.
+		 * @param args Argumentos que se reenvan al constructor de T.
+		 * @return Referencia al elemento construido.
 		 */
-		void Add(const T& Element)
+		template<typename... Args>
+		T& Emplace(Args&&... args)
 		{
 			if (Size == Capacity)
 			{
-				Resize(Capacity == 0 ? 1 : Capacity * 2);  ///< Redimensionar si es necesario.
+				return EmplaceGrow(std::forward<Args>(args)...);  ///< Redimensionar si es necesario.
 			}
-			Data[Size++] = Element;  ///< Aadir el nuevo elemento y aumentar el tamao.
+			::new (static_cast<void*>(Data + Size)) T(std::forward<Args>(args)...);
+			return Data[Size++];  ///< Aumentar el tamao tras construir el elemento.
+		}
+
+		/**
+		 * @brief Aade un nuevo elemento al final del array.
+		 *
+		 * @param Element El elemento a aadir al array.
+		 */
+		void Add(const T& Element)
+		{
+			Emplace(Element);  ///< Construir una copia del elemento al final.
 		}
 
 		/**
-		 * @brief Elimina el elemento en la posicin especificada.
+		 * @brief Aade un nuevo elemento al final del array movindolo.
+		 *
+		 * @param Element El elemento a mover al array.
+		 */
+		void Add(T&& Element)
+		{
+			Emplace(std::move(Element));  ///< Construir el elemento al final por movimiento.
+		}
+
+		/**
+		 * @brief Elimina el elemento en la posicin especificada conservando el orden.
+		 *
+		 * Desplaza los elementos siguientes una posicin (con un nico memmove si T es
+		 * trivialmente reubicable). Un ndice fuera de rango termina el programa.
 		 *
 		 * @param Index La posicin del elemento a eliminar.
 		 */
 		void RemoveAt(size_t Index)
 		{
-			if (Index >= Size)
+			RemoveRange(Index, 1);
+		}
+
+		/**
+		 * @brief Elimina el elemento en la posicin especificada en O(1) sin conservar el orden.
+		 *
+		 * El ltimo elemento pasa a ocupar la posicin eliminada.
+		 *
+		 * @param Index La posicin del elemento a eliminar.
+		 */
+		void RemoveAtSwap(size_t Index)
+		{
+			CheckIndex(Index);
+			size_t Last = Size - 1;
+			if constexpr (bTriviallyRelocatable)
+			{
+				Data[Index].~T();
+				if (Index != Last)
+				{
+					std::memcpy(static_cast<void*>(Data + Index), static_cast<const void*>(Data + Last), sizeof(T));
+				}
+			}
+			else
+			{
+				if (Index != Last)
+				{
+					Data[Index] = std::move(Data[Last]);
+				}
+				Data[Last].~T();
+			}
+			Size = Last;
+		}
+
+		/**
+		 * @brief Elimina Count elementos a partir de Index conservando el orden.
+		 *
+		 * Los elementos siguientes se desplazan una sola vez. Un rango fuera del array termina el programa.
+		 *
+		 * @param Index La posicin del primer elemento a eliminar.
+		 * @param Count El nmero de elementos a eliminar.
+		 */
+		void RemoveRange(size_t Index, size_t Count)
+		{
+			if (Index > Size || Count > Size - Index)
 			{
 				std::cerr << "Index out of range" << std::endl;  ///< Manejar el caso de ndice fuera de rango.
+				exit(1);  ///< Salir del programa en caso de error.
+			}
+			if (Count == 0)
+			{
 				return;
 			}
-			for (size_t i = Index; i < Size - 1; ++i)
+			size_t Tail = Size - Index - Count;  ///< Elementos que hay que desplazar.
+			if constexpr (bTriviallyRelocatable)
 			{
-				Data[i] = Data[i + 1];  ///< Desplazar los elementos hacia la izquierda para llenar el hueco.
+				for (size_t i = Index; i < Index + Count; ++i)
+				{
+					Data[i].~T();
+				}
+				if (Tail > 0)
+				{
+					std::memmove(static_cast<void*>(Data + Index), static_cast<const void*>(Data + Index + Count), Tail * sizeof(T));
+				}
+			}
+			else
+			{
+				for (size_t i = Index; i < Index + Tail; ++i)
+				{
+					Data[i] = std::move(Data[i + Count]);  ///< Desplazar los elementos hacia la izquierda para llenar el hueco.
+				}
+				for (size_t i = Index + Tail; i < Size; ++i)
+				{
+					Data[i].~T();  ///< Destruir los elementos sobrantes del final, que ya se han desplazado.
+				}
+			}
+			Size -= Count;
+		}
+
+		/**
+		 * @brief Elimina todos los elementos que cumplen Pred en una sola pasada, conservando el orden.
+		 *
+		 * Cada elemento que se queda se mueve como mucho una vez.
+		 *
+		 * @param Pred Predicado bool(const T&).
+		 * @return El nmero de elementos eliminados.
+		 */
+		template<typename Predicate>
+		size_t RemoveAllMatching(Predicate Pred)
+		{
+			size_t Write = 0;
+			for (size_t Read = 0; Read < Size; ++Read)
+			{
+				if (!Pred(static_cast<const T&>(Data[Read])))
+				{
+					if (Write != Read)
+					{
+						Data[Write] = std::move(Data[Read]);
+					}
+					++Write;
+				}
+			}
+			size_t Removed = Size - Write;
+			for (size_t i = Write; i < Size; ++i)
+			{
+				Data[i].~T();
+			}
+			Size = Write;
+			return Removed;
+		}
+
+		/**
+		 * @brief Asegura capacidad para al menos NewCapacity elementos sin ms reservas.
+		 *
+		 * @param NewCapacity La capacidad mnima deseada.
+		 */
+		void Reserve(size_t NewCapacity)
+		{
+			if (NewCapacity > Capacity)
+			{
+				Resize(NewCapacity);
+			}
+		}
+
+		/**
+		 * @brief Ajusta la capacidad al nmero de elementos, liberando la memoria sobrante.
+		 */
+		void Shrink()
+		{
+			if (Size == Capacity)
+			{
+				return;
+			}
+			if (Size == 0)
+			{
+				Deallocate(Data, Capacity);
+				Data = nullptr;
+				Capacity = 0;
+				return;
+			}
+			Resize(Size);
+		}
+
+		/**
+		 * @brief Elimina todos los elementos.
+		 *
+		 * @param bKeepCapacity Si es true conserva la memoria para volver a llenar el array sin
+		 *        reservas (p. ej. listas que se reconstruyen cada frame).
+		 */
+		void Empty(bool bKeepCapacity = false)
+		{
+			DestroyElements(Size);
+			Size = 0;
+			if (!bKeepCapacity)
+			{
+				Deallocate(Data, Capacity);
+				Data = nullptr;
+				Capacity = 0;
 			}
-			--Size;  ///< Disminuir el tamao del array.
 		}
 
 		/**
 		 * @brief Sobrecarga del operador [] para acceder a elementos por ndice.
 		 *
+		 * Slo comprueba el ndice si ENGINEUTILITIES_CHECK_BOUNDS est activo (compilaciones de
+		 * depuracin); en las dems es un acceso directo que no impide vectorizar los bucles.
+		 *
 		 * @param Index La posicin del elemento a acceder.
 		 * @return Referencia al elemento en la posicin especificada.
 		 */
 		T& operator[](size_t Index)
 		{
-			if (Index >= Size)
-			{
-				std::cerr << "Index out of range" << std::endl;  ///< Manejar el caso de ndice fuera de rango.
-				exit(1);  ///< Salir del programa en caso de error.
-			}
+#if ENGINEUTILITIES_CHECK_BOUNDS
+			CheckIndex(Index);
+#endif
 			return Data[Index];  ///< Devolver el elemento en la posicin especificada.
 		}
 
@@ -133,14 +538,54 @@ namespace EngineUtilities {
 		 */
 		const T& operator[](size_t Index) const
 		{
-			if (Index >= Size)
-			{
-				std::cerr << "Index out of range" << std::endl;  ///< Manejar el caso de ndice fuera de rango.
-				exit(1);  ///< Salir del programa en caso de error.
-			}
+#if ENGINEUTILITIES_CHECK_BOUNDS
+			CheckIndex(Index);
+#endif
 			return Data[Index];  ///< Devolver el elemento en la posicin especificada.
 		}
 
+		/**
+		 * @brief Acceso por ndice comprobado siempre. Un ndice fuera de rango termina el programa.
+		 *
+		 * @param Index La posicin del elemento a acceder.
+		 * @return Referencia al elemento en la posicin especificada.
+		 */
+		T& At(size_t Index)
+		{
+			CheckIndex(Index);
+			return Data[Index];
+		}
+
+		const T& At(size_t Index) const
+		{
+			CheckIndex(Index);
+			return Data[Index];
+		}
+
+		/**
+		 * @brief Devuelve un puntero a los elementos, contiguos en memoria (nulo si el array nunca reserv).
+		 */
+		T* GetData()
+		{
+			return Data;
+		}
+
+		const T* GetData() const
+		{
+			return Data;
+		}
+
+		/**
+		 * @brief Iteradores de acceso aleatorio sobre los elementos (punteros, al ser memoria contigua).
+		 *
+		 * Permiten el for por rango y los algoritmos de la STL (std::sort, std::find...). Se
+		 * invalidan al aadir o eliminar elementos.
+		 */
+		T* begin() { return Data; }
+		T* end() { return Data + Size; }
+		const T* begin() const { return Data; }
+		const T* end() const { return Data + Size; }
+
 		/**
 		 * @brief Devuelve el nmero de elementos actualmente en el array.
 		 *
@@ -160,6 +605,19 @@ namespace EngineUtilities {
 		{
 			return Capacity;  ///< Devolver la capacidad actual del array.
 		}
+
+		/**
+		 * @brief Devuelve la poltica de memoria del array.
+		 */
+		Alloc& GetAllocator()
+		{
+			return *this;
+		}
+
+		const Alloc& GetAllocator() const
+		{
+			return *this;
+		}
 	};
 
 	// EXAMPLE
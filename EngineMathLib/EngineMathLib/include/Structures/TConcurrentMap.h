@@ -0,0 +1,274 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include "THashTable.h"
+
+namespace EngineUtilities {
+	/**
+	 * @brief Mapa hash seguro entre hilos, repartido en fragmentos con un cerrojo cada uno.
+	 *
+	 * Cada clave pertenece a un nico fragmento, elegido con los bits altos de su hash; cada
+	 * fragmento es una THashTable protegida por su propio std::mutex y alineada a una lnea
+	 * de cach, as que hilos que tocan claves distintas casi nunca compiten por el mismo
+	 * cerrojo ni por la misma lnea. Los bits altos no se solapan con los que usa la tabla
+	 * interna (los 7 bajos como etiqueta y los siguientes como posicin), de modo que las
+	 * claves de un fragmento siguen bien repartidas dentro de l.
+	 *
+	 * Las operaciones devuelven copias de los valores: una referencia dejara de estar
+	 * protegida en cuanto se suelta el cerrojo.
+	 *
+	 * @tparam K Tipo de la clave.
+	 * @tparam V Tipo del valor. Debe poder copiarse.
+	 * @tparam HashFunc Functor de hash (por defecto THash<K>); debe repartir bien los bits altos.
+	 * @tparam Alloc Poltica de asignacin de memoria de las tablas de cada fragmento.
+	 */
+	template<typename K, typename V, typename HashFunc = THash<K>, typename Alloc = FHeapAllocator>
+	class TConcurrentMap
+	{
+	private:
+		struct Pair
+		{
+			K Key;
+			V Value;
+
+			Pair(const K& Key, const V& Value) : Key(Key), Value(Value) {}
+		};
+
+		struct PairKeyFuncs
+		{
+			using KeyType = K;
+			using HashType = HashFunc;
+			static const K& GetKey(const Pair& Element) { return Element.Key; }
+		};
+
+		using TableType = THashTable<Pair, PairKeyFuncs, Alloc>;
+
+		/**
+		 * @brief Fragmento del mapa: su cerrojo y su tabla, en lneas de cach propias.
+		 */
+		struct alignas(64) FShard
+		{
+			mutable std::mutex Mutex;
+			TableType Table;
+		};
+
+		FShard* Shards;      ///< Fragmentos (NumShards, potencia de dos).
+		size_t NumShards;    ///< Nmero de fragmentos.
+		uint32_t ShardShift; ///< Desplazamiento que deja en el hash slo los bits del fragmento.
+		HashFunc Hasher;     ///< Functor de hash.
+
+		void Init(size_t InNumShards)
+		{
+			NumShards = 1;
+			uint32_t ShardBits = 0;
+			while (NumShards < InNumShards && ShardBits < 16)
+			{
+				NumShards *= 2;
+				++ShardBits;
+			}
+			ShardShift = static_cast<uint32_t>(sizeof(size_t) * 8) - ShardBits;
+			Shards = new FShard[NumShards];
+		}
+
+		FShard& GetShard(size_t Hash) const
+		{
+			// Con un solo fragmento ShardShift vale el ancho de size_t y el desplazamiento no estara definido.
+			return Shards[NumShards > 1 ? Hash >> ShardShift : 0];
+		}
+
+	public:
+		/**
+		 * @brief Construye un mapa vaco.
+		 *
+		 * @param InNumShards Nmero de fragmentos; se redondea a potencia de dos (como mucho 65536).
+		 *        Conviene que sea varias veces el nmero de hilos que lo usan a la vez.
+		 */
+		explicit TConcurrentMap(size_t InNumShards = 64)
+		{
+			Init(InNumShards);
+		}
+
+		/**
+		 * @brief Construye un mapa vaco cuyas tablas usan una instancia concreta del asignador.
+		 */
+		TConcurrentMap(size_t InNumShards, const Alloc& InAllocator)
+		{
+			Init(InNumShards);
+			for (size_t i = 0; i < NumShards; ++i)
+			{
+				Shards[i].Table = TableType(InAllocator);
+			}
+		}
+
+		TConcurrentMap(const TConcurrentMap&) = delete;
+		TConcurrentMap& operator=(const TConcurrentMap&) = delete;
+
+		~TConcurrentMap()
+		{
+			delete[] Shards;
+		}
+
+		/**
+		 * @brief Devuelve el valor de la clave, aadiendo antes el par (Key, Value) si no exista.
+		 *
+		 * La bsqueda y la insercin ocurren bajo el mismo cerrojo: si varios hilos aaden la
+		 * misma clave a la vez, slo el primero inserta y todos reciben su valor.
+		 *
+		 * @param Key La clave.
+		 * @param Value Valor que se inserta si la clave no existe.
+		 * @return Una copia del valor asociado a Key tras la llamada.
+		 */
+		V FindOrAdd(const K& Key, const V& Value)
+		{
+			size_t Hash = Hasher(Key);
+			FShard& Shard = GetShard(Hash);
+			std::lock_guard<std::mutex> Lock(Shard.Mutex);
+			size_t Index = Shard.Table.FindHashed(Key, Hash);
+			if (Index == TableType::INDEX_NONE)
+			{
+				Index = Shard.Table.EmplaceNew(Hash, Key, Value);
+			}
+			return Shard.Table.GetElement(Index).Value;
+		}
+
+		/**
+		 * @brief Aade un par o actualiza el valor si la clave ya existe.
+		 */
+		void Add(const K& Key, const V& Value)
+		{
+			size_t Hash = Hasher(Key);
+			FShard& Shard = GetShard(Hash);
+			std::lock_guard<std::mutex> Lock(Shard.Mutex);
+			size_t Index = Shard.Table.FindHashed(Key, Hash);
+			if (Index != TableType::INDEX_NONE)
+			{
+				Shard.Table.GetElement(Index).Value = Value;  ///< Actualizar el valor si la clave ya existe.
+				return;
+			}
+			Shard.Table.EmplaceNew(Hash, Key, Value);
+		}
+
+		/**
+		 * @brief Copia en OutValue el valor de la clave, si existe.
+		 *
+		 * @return true si la clave exista; si no, OutValue no se modifica.
+		 */
+		bool TryGet(const K& Key, V& OutValue) const
+		{
+			size_t Hash = Hasher(Key);
+			FShard& Shard = GetShard(Hash);
+			std::lock_guard<std::mutex> Lock(Shard.Mutex);
+			size_t Index = Shard.Table.FindHashed(Key, Hash);
+			if (Index == TableType::INDEX_NONE)
+			{
+				return false;
+			}
+			OutValue = Shard.Table.GetElement(Index).Value;
+			return true;
+		}
+
+		bool Contains(const K& Key) const
+		{
+			size_t Hash = Hasher(Key);
+			FShard& Shard = GetShard(Hash);
+			std::lock_guard<std::mutex> Lock(Shard.Mutex);
+			return Shard.Table.FindHashed(Key, Hash) != TableType::INDEX_NONE;
+		}
+
+		/**
+		 * @brief Elimina el par con la clave dada.
+		 *
+		 * @return true si la clave exista.
+		 */
+		bool Remove(const K& Key)
+		{
+			size_t Hash = Hasher(Key);
+			FShard& Shard = GetShard(Hash);
+			std::lock_guard<std::mutex> Lock(Shard.Mutex);
+			size_t Index = Shard.Table.FindHashed(Key, Hash);
+			if (Index == TableType::INDEX_NONE)
+			{
+				return false;
+			}
+			Shard.Table.RemoveAt(Index);
+			return true;
+		}
+
+		/**
+		 * @brief Llama a Func(Key, Value) con cada par del mapa.
+		 *
+		 * Recorre los fragmentos de uno en uno, con el cerrojo de cada uno tomado mientras se
+		 * visita: los dems hilos pueden seguir usando el resto del mapa, y por eso el
+		 * recorrido no es una instantnea (un par aadido o borrado durante la llamada puede
+		 * verse o no). Func no debe llamar a este mapa: el cerrojo del fragmento no es recursivo.
+		 *
+		 * @param Func Funcin con la firma void(const K& Key, const V& Value).
+		 */
+		template<typename Fn>
+		void ForEach(Fn&& Func) const
+		{
+			for (size_t s = 0; s < NumShards; ++s)
+			{
+				const FShard& Shard = Shards[s];
+				std::lock_guard<std::mutex> Lock(Shard.Mutex);
+				for (size_t i = 0; i < Shard.Table.GetCapacity(); ++i)
+				{
+					if (Shard.Table.IsValidIndex(i))
+					{
+						const Pair& Element = Shard.Table.GetElement(i);
+						Func(Element.Key, Element.Value);
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Nmero total de pares. Con otros hilos modificando el mapa es slo aproximado.
+		 */
+		size_t Num() const
+		{
+			size_t Total = 0;
+			for (size_t s = 0; s < NumShards; ++s)
+			{
+				std::lock_guard<std::mutex> Lock(Shards[s].Mutex);
+				Total += Shards[s].Table.Num();
+			}
+			return Total;
+		}
+
+		size_t GetNumShards() const
+		{
+			return NumShards;
+		}
+	};
+}
@@ -0,0 +1,271 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "TArray.h"
+#include "Memory/HeapAllocator.h"
+
+namespace EngineUtilities {
+	/**
+	 * @brief Referencia dbil a un objeto de un THandlePool: ndice de hueco y generacin (64 bits).
+	 *
+	 * Es un valor trivial que se puede copiar, guardar en otros objetos o serializar. Un handle
+	 * deja de ser vlido cuando su objeto se elimina, aunque el hueco se reutilice despus,
+	 * porque la generacin del hueco ya no coincide.
+	 *
+	 * @tparam T Tipo de los objetos del pool (slo sirve para no mezclar handles de pools distintos).
+	 */
+	template<typename T>
+	struct THandle
+	{
+		uint32_t Index;      ///< Hueco del pool.
+		uint32_t Generation; ///< Generacin del hueco al crear el objeto; 0 es el handle nulo.
+
+		THandle() : Index(0), Generation(0) {}
+		THandle(uint32_t InIndex, uint32_t InGeneration) : Index(InIndex), Generation(InGeneration) {}
+
+		/**
+		 * @brief Indica si es el handle nulo (no indica si el objeto sigue vivo; ver THandlePool::IsValid).
+		 */
+		bool IsNull() const { return Generation == 0; }
+
+		bool operator==(const THandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+		bool operator!=(const THandle& Other) const { return !(*this == Other); }
+	};
+
+	/**
+	 * @brief Pool de objetos con handles generacionales y almacenamiento denso.
+	 *
+	 * Los objetos vivos estn contiguos en un TArray, de modo que recorrerlos (ForEach o el
+	 * operador [] de 0 a Num() - 1) no sigue punteros. Una tabla de huecos traduce cada handle a
+	 * su posicin en el array denso:
+	 *
+	 * - Get e IsValid son O(1): comprueban la generacin del hueco y leen su posicin.
+	 * - Remove es O(1): mueve el ltimo objeto al hueco que queda y actualiza su entrada.
+	 * - Los huecos libres forman una lista intrusiva en la propia tabla y se reutilizan con la
+	 *   generacin incrementada, as que los handles antiguos siguen fallando.
+	 *
+	 * Los handles son estables; las posiciones densas y los punteros a objetos no lo son tras un
+	 * Add (el array puede crecer) o un Remove (el ltimo objeto se mueve).
+	 *
+	 * @tparam T Tipo de los objetos.
+	 * @tparam Alloc Poltica de memoria de los arrays internos.
+	 */
+	template<typename T, typename Alloc = FHeapAllocator>
+	class THandlePool
+	{
+	public:
+		using HandleType = THandle<T>;
+
+		THandlePool() : FirstFree(InvalidIndex) {}
+
+		explicit THandlePool(const Alloc& Allocator)
+			: Dense(Allocator), DenseToSlot(Allocator), Slots(Allocator), FirstFree(InvalidIndex)
+		{
+		}
+
+		/**
+		 * @brief Construye un objeto en el pool.
+		 *
+		 * @param args Argumentos que se reenvan al constructor de T.
+		 * @return Handle del nuevo objeto.
+		 */
+		template<typename... Args>
+		HandleType Emplace(Args&&... args)
+		{
+			uint32_t DenseIndex = static_cast<uint32_t>(Dense.Num());
+			Dense.Emplace(std::forward<Args>(args)...);
+
+			uint32_t SlotIndex;
+			if (FirstFree != InvalidIndex)
+			{
+				SlotIndex = FirstFree;
+				FirstFree = Slots[SlotIndex].DenseIndex;
+				Slots[SlotIndex].DenseIndex = DenseIndex;
+			}
+			else
+			{
+				SlotIndex = static_cast<uint32_t>(Slots.Num());
+				Slots.Add(FSlot{ 1, DenseIndex });
+			}
+			DenseToSlot.Add(SlotIndex);
+			return HandleType(SlotIndex, Slots[SlotIndex].Generation);
+		}
+
+		/**
+		 * @brief Aade una copia de Element al pool.
+		 */
+		HandleType Add(const T& Element)
+		{
+			return Emplace(Element);
+		}
+
+		/**
+		 * @brief Aade Element al pool movindolo.
+		 */
+		HandleType Add(T&& Element)
+		{
+			return Emplace(std::move(Element));
+		}
+
+		/**
+		 * @brief Elimina el objeto de Handle. El ltimo objeto denso ocupa su posicin.
+		 *
+		 * @return false si el handle ya no era vlido.
+		 */
+		bool Remove(HandleType Handle)
+		{
+			if (!IsValid(Handle))
+			{
+				return false;
+			}
+			FSlot& Slot = Slots[Handle.Index];
+			uint32_t DenseIndex = Slot.DenseIndex;
+			uint32_t LastIndex = static_cast<uint32_t>(Dense.Num() - 1);
+			if (DenseIndex != LastIndex)
+			{
+				Slots[DenseToSlot[LastIndex]].DenseIndex = DenseIndex;
+			}
+			Dense.RemoveAtSwap(DenseIndex);
+			DenseToSlot.RemoveAtSwap(DenseIndex);
+
+			// Invalidar los handles existentes y pasar el hueco a la lista libre.
+			Slot.Generation = Slot.Generation + 1 != 0 ? Slot.Generation + 1 : 1;
+			Slot.DenseIndex = FirstFree;
+			FirstFree = Handle.Index;
+			return true;
+		}
+
+		/**
+		 * @brief Indica si Handle apunta a un objeto vivo de este pool.
+		 */
+		bool IsValid(HandleType Handle) const
+		{
+			return Handle.Index < Slots.Num() && Slots[Handle.Index].Generation == Handle.Generation
+				&& Handle.Generation != 0;
+		}
+
+		/**
+		 * @brief Devuelve el objeto de Handle, o nullptr si ya no existe.
+		 */
+		T* Get(HandleType Handle)
+		{
+			return IsValid(Handle) ? &Dense[Slots[Handle.Index].DenseIndex] : nullptr;
+		}
+
+		const T* Get(HandleType Handle) const
+		{
+			return IsValid(Handle) ? &Dense[Slots[Handle.Index].DenseIndex] : nullptr;
+		}
+
+		/**
+		 * @brief Nmero de objetos vivos.
+		 */
+		size_t Num() const
+		{
+			return Dense.Num();
+		}
+
+		/**
+		 * @brief Objeto en la posicin densa DenseIndex (0 <= DenseIndex < Num()).
+		 */
+		T& operator[](size_t DenseIndex)
+		{
+			return Dense[DenseIndex];
+		}
+
+		const T& operator[](size_t DenseIndex) const
+		{
+			return Dense[DenseIndex];
+		}
+
+		/**
+		 * @brief Handle del objeto en la posicin densa DenseIndex.
+		 */
+		HandleType GetHandle(size_t DenseIndex) const
+		{
+			uint32_t SlotIndex = DenseToSlot[DenseIndex];
+			return HandleType(SlotIndex, Slots[SlotIndex].Generation);
+		}
+
+		/**
+		 * @brief Llama a Func(T&) para cada objeto vivo, en orden de memoria.
+		 */
+		template<typename Fn>
+		void ForEach(Fn&& Func)
+		{
+			size_t Count = Dense.Num();
+			for (size_t i = 0; i < Count; ++i)
+			{
+				Func(Dense[i]);
+			}
+		}
+
+		template<typename Fn>
+		void ForEach(Fn&& Func) const
+		{
+			size_t Count = Dense.Num();
+			for (size_t i = 0; i < Count; ++i)
+			{
+				Func(Dense[i]);
+			}
+		}
+
+		/**
+		 * @brief Elimina todos los objetos e invalida todos sus handles. Conserva la tabla de huecos.
+		 */
+		void Empty()
+		{
+			size_t Count = Dense.Num();
+			for (size_t i = Count; i-- > 0;)
+			{
+				Remove(GetHandle(i));
+			}
+		}
+
+	private:
+		static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+		/**
+		 * @brief Entrada de la tabla de huecos.
+		 */
+		struct FSlot
+		{
+			uint32_t Generation; ///< Generacin actual; los handles con otra generacin no son vlidos.
+			uint32_t DenseIndex; ///< Posicin en Dense si est ocupado; siguiente hueco libre si no.
+		};
+
+		TArray<T, Alloc> Dense;              ///< Objetos vivos, contiguos.
+		TArray<uint32_t, Alloc> DenseToSlot; ///< Hueco de cada objeto denso.
+		TArray<FSlot, Alloc> Slots;          ///< Tabla de huecos indexada por THandle::Index.
+		uint32_t FirstFree;                  ///< Primer hueco libre, o InvalidIndex.
+	};
+}
@@ -0,0 +1,125 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+namespace EngineUtilities {
+	/**
+	 * @brief Mezcla los bits de un valor de 64 bits (finalizador de SplitMix64).
+	 *
+	 * Las tablas hash de la biblioteca usan los 7 bits bajos del hash como etiqueta y el resto
+	 * como posicin inicial, por lo que todos los bits deben depender de toda la entrada.
+	 *
+	 * @param Value El valor a mezclar.
+	 * @return El valor mezclado.
+	 */
+	inline uint64_t MixHash64(uint64_t Value)
+	{
+		Value ^= Value >> 30;
+		Value *= 0xBF58476D1CE4E5B9ULL;
+		Value ^= Value >> 27;
+		Value *= 0x94D049BB133111EBULL;
+		Value ^= Value >> 31;
+		return Value;
+	}
+
+	/**
+	 * @brief Calcula el hash FNV-1a de un bloque de bytes.
+	 *
+	 * @param Bytes Puntero a los bytes.
+	 * @param Length Nmero de bytes.
+	 * @return El hash del bloque.
+	 */
+	inline uint64_t HashBytes(const void* Bytes, size_t Length)
+	{
+		const unsigned char* P = static_cast<const unsigned char*>(Bytes);
+		uint64_t Hash = 0xCBF29CE484222325ULL;
+		for (size_t i = 0; i < Length; ++i)
+		{
+			Hash ^= P[i];
+			Hash *= 0x100000001B3ULL;
+		}
+		return MixHash64(Hash);
+	}
+
+	/**
+	 * @brief Rasgo de hash usado por TMap y TSet.
+	 *
+	 * La versin genrica delega en std::hash y mezcla el resultado. Se puede especializar
+	 * para tipos propios, o pasar otro functor como parmetro de plantilla del contenedor.
+	 * El functor debe devolver un size_t con todos los bits bien distribuidos.
+	 *
+	 * @tparam K El tipo de la clave.
+	 */
+	template<typename K, typename Enable = void>
+	struct THash
+	{
+		size_t operator()(const K& Key) const
+		{
+			return static_cast<size_t>(MixHash64(static_cast<uint64_t>(std::hash<K>()(Key))));
+		}
+	};
+
+	/**
+	 * @brief Especializacin de THash para enteros, enumeraciones y punteros.
+	 */
+	template<typename K>
+	struct THash<K, typename std::enable_if<std::is_integral<K>::value || std::is_enum<K>::value || std::is_pointer<K>::value>::type>
+	{
+		size_t operator()(const K& Key) const
+		{
+			uint64_t Bits;
+			if constexpr (std::is_pointer<K>::value)
+			{
+				Bits = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(Key));
+			}
+			else
+			{
+				Bits = static_cast<uint64_t>(Key);
+			}
+			return static_cast<size_t>(MixHash64(Bits));
+		}
+	};
+
+	/**
+	 * @brief Especializacin de THash para std::string.
+	 */
+	template<>
+	struct THash<std::string>
+	{
+		size_t operator()(const std::string& Key) const
+		{
+			return static_cast<size_t>(HashBytes(Key.data(), Key.size()));
+		}
+	};
+}
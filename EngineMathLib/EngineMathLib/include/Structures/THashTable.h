@@ -0,0 +1,550 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "THash.h"
+#include "Memory/HeapAllocator.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINEUTILITIES_HASH_SSE2 1
+#include <emmintrin.h>
+#else
+#define ENGINEUTILITIES_HASH_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace EngineUtilities {
+	/**
+	 * @brief Grupo de 16 bytes de control que se examinan a la vez.
+	 *
+	 * Cada byte de control describe una ranura de la tabla: 0x80 si est vaca, o los 7 bits
+	 * bajos del hash de la clave (H2) si est ocupada. Con SSE2 se comparan los 16 bytes con
+	 * una sola instruccin; sin SSE2 se usa un bucle escalar equivalente.
+	 */
+	struct THashGroup
+	{
+		static constexpr size_t Width = 16;   ///< Nmero de ranuras por grupo.
+		static constexpr uint8_t Empty = 0x80; ///< Byte de control de una ranura vaca.
+
+#if ENGINEUTILITIES_HASH_SSE2
+		__m128i Ctrl;
+
+		explicit THashGroup(const uint8_t* Pos)
+			: Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Pos))) {}
+
+		/**
+		 * @brief Mscara de bits de las ranuras cuyo byte de control coincide con H2.
+		 */
+		uint32_t Match(uint8_t H2) const
+		{
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(Ctrl, _mm_set1_epi8(static_cast<char>(H2)))));
+		}
+
+		/**
+		 * @brief Mscara de bits de las ranuras vacas del grupo.
+		 */
+		uint32_t MatchEmpty() const
+		{
+			return static_cast<uint32_t>(_mm_movemask_epi8(Ctrl));
+		}
+#else
+		const uint8_t* Ctrl;
+
+		explicit THashGroup(const uint8_t* Pos) : Ctrl(Pos) {}
+
+		uint32_t Match(uint8_t H2) const
+		{
+			uint32_t Mask = 0;
+			for (size_t i = 0; i < Width; ++i)
+			{
+				Mask |= static_cast<uint32_t>(Ctrl[i] == H2) << i;
+			}
+			return Mask;
+		}
+
+		uint32_t MatchEmpty() const
+		{
+			uint32_t Mask = 0;
+			for (size_t i = 0; i < Width; ++i)
+			{
+				Mask |= static_cast<uint32_t>(Ctrl[i] >> 7) << i;
+			}
+			return Mask;
+		}
+#endif
+
+		/**
+		 * @brief ndice del bit menos significativo activo de una mscara no nula.
+		 */
+		static uint32_t LowestBit(uint32_t Mask)
+		{
+#if defined(_MSC_VER)
+			unsigned long Index;
+			_BitScanForward(&Index, Mask);
+			return static_cast<uint32_t>(Index);
+#else
+			return static_cast<uint32_t>(__builtin_ctz(Mask));
+#endif
+		}
+	};
+
+	/**
+	 * @brief Tabla hash de direccionamiento abierto compartida por TMap y TSet.
+	 *
+	 * Las ranuras se guardan en un bloque contiguo y se sondean linealmente en grupos de
+	 * 16 bytes de control (estilo SwissTable). El borrado desplaza hacia atrs los elementos
+	 * siguientes del mismo tramo, as que no existen lpidas y las bsquedas no se degradan
+	 * tras muchas eliminaciones. La capacidad es siempre potencia de dos y la tabla crece
+	 * cuando el nmero de elementos supera el factor de carga mximo.
+	 *
+	 * @tparam ElementType El tipo almacenado en cada ranura.
+	 * @tparam KeyFuncs Tipo con KeyType, HashType y GetKey(const ElementType&).
+	 * @tparam Alloc La poltica de memoria de las ranuras y los bytes de control (ver FHeapAllocator).
+	 */
+	template<typename ElementType, typename KeyFuncs, typename Alloc = FHeapAllocator>
+	class THashTable : private Alloc
+	{
+	public:
+		using KeyType = typename KeyFuncs::KeyType;
+		using HashType = typename KeyFuncs::HashType;
+
+		static constexpr size_t INDEX_NONE = static_cast<size_t>(-1); ///< ndice devuelto cuando no se encuentra la clave.
+
+	private:
+		ElementType* Slots;  ///< Ranuras (memoria cruda; slo las ocupadas estn construidas).
+		uint8_t* Ctrl;       ///< Bytes de control: Capacity + Width, el final replica el inicio.
+		size_t Capacity;     ///< Nmero de ranuras (0 o potencia de dos >= Width).
+		size_t Size;         ///< Nmero de elementos almacenados.
+		float MaxLoadFactor; ///< Fraccin mxima de ranuras ocupadas antes de crecer.
+		HashType Hasher;     ///< Functor de hash.
+
+		/**
+		 * @brief Reserva las ranuras y los bytes de control (marcados vacos) para NewCapacity ranuras.
+		 */
+		void AllocateStorage(size_t NewCapacity)
+		{
+			Slots = static_cast<ElementType*>(GetAllocator().Allocate(NewCapacity * sizeof(ElementType), alignof(ElementType)));
+			Ctrl = static_cast<uint8_t*>(GetAllocator().Allocate(NewCapacity + THashGroup::Width, 1));
+			std::memset(Ctrl, THashGroup::Empty, NewCapacity + THashGroup::Width);
+			Capacity = NewCapacity;
+		}
+
+		/**
+		 * @brief Libera las ranuras y los bytes de control de una tabla de OldCapacity ranuras.
+		 */
+		void DeallocateStorage(ElementType* OldSlots, uint8_t* OldCtrl, size_t OldCapacity)
+		{
+			if (OldSlots != nullptr)
+			{
+				GetAllocator().Deallocate(OldSlots, OldCapacity * sizeof(ElementType), alignof(ElementType));
+				GetAllocator().Deallocate(OldCtrl, OldCapacity + THashGroup::Width, 1);
+			}
+		}
+
+		static uint8_t H2(size_t Hash) { return static_cast<uint8_t>(Hash & 0x7F); }
+		size_t HomeIndex(size_t Hash) const { return (Hash >> 7) & (Capacity - 1); }
+
+		/**
+		 * @brief Escribe un byte de control manteniendo la rplica del final del array.
+		 */
+		void SetCtrl(size_t Index, uint8_t Value)
+		{
+			Ctrl[Index] = Value;
+			if (Index < THashGroup::Width)
+			{
+				Ctrl[Capacity + Index] = Value;
+			}
+		}
+
+		/**
+		 * @brief Devuelve la primera ranura vaca a partir de la posicin inicial del hash.
+		 */
+		size_t FindEmptySlot(size_t Hash) const
+		{
+			size_t Mask = Capacity - 1;
+			size_t Pos = HomeIndex(Hash);
+			while (true)
+			{
+				uint32_t Empties = THashGroup(Ctrl + Pos).MatchEmpty();
+				if (Empties)
+				{
+					return (Pos + THashGroup::LowestBit(Empties)) & Mask;
+				}
+				Pos = (Pos + THashGroup::Width) & Mask;
+			}
+		}
+
+		/**
+		 * @brief Redistribuye todos los elementos en una tabla con la nueva capacidad.
+		 *
+		 * @param NewCapacity Nueva capacidad (potencia de dos >= Width).
+		 */
+		void Rehash(size_t NewCapacity)
+		{
+			ElementType* OldSlots = Slots;
+			uint8_t* OldCtrl = Ctrl;
+			size_t OldCapacity = Capacity;
+
+			AllocateStorage(NewCapacity);
+
+			for (size_t i = 0; i < OldCapacity; ++i)
+			{
+				if (OldCtrl[i] != THashGroup::Empty)
+				{
+					size_t Hash = Hasher(KeyFuncs::GetKey(OldSlots[i]));
+					size_t Index = FindEmptySlot(Hash);
+					::new (static_cast<void*>(Slots + Index)) ElementType(std::move(OldSlots[i]));
+					OldSlots[i].~ElementType();
+					SetCtrl(Index, H2(Hash));
+				}
+			}
+			DeallocateStorage(OldSlots, OldCtrl, OldCapacity);
+		}
+
+		/**
+		 * @brief Crece si aadir un elemento ms superara el factor de carga mximo.
+		 */
+		void GrowIfNeeded()
+		{
+			if (Capacity == 0)
+			{
+				Rehash(THashGroup::Width);
+			}
+			else if (static_cast<float>(Size + 1) > static_cast<float>(Capacity) * MaxLoadFactor)
+			{
+				Rehash(Capacity * 2);
+			}
+		}
+
+	public:
+		/**
+		 * @brief Constructor por defecto. No reserva memoria hasta la primera insercin.
+		 *
+		 * @param InHasher Functor de hash a utilizar.
+		 */
+		explicit THashTable(const HashType& InHasher = HashType())
+			: Slots(nullptr), Ctrl(nullptr), Capacity(0), Size(0), MaxLoadFactor(0.75f), Hasher(InHasher)
+		{
+		}
+
+		/**
+		 * @brief Constructor que usa una instancia concreta de la poltica de memoria.
+		 *
+		 * @param InAllocator La poltica de la que se pedir la memoria.
+		 * @param InHasher Functor de hash a utilizar.
+		 */
+		explicit THashTable(const Alloc& InAllocator, const HashType& InHasher = HashType())
+			: Alloc(InAllocator), Slots(nullptr), Ctrl(nullptr), Capacity(0), Size(0), MaxLoadFactor(0.75f), Hasher(InHasher)
+		{
+		}
+
+		/**
+		 * @brief Constructor de copia. Copia tambin la poltica de memoria.
+		 */
+		THashTable(const THashTable& Other)
+			: Alloc(Other.GetAllocator()), Slots(nullptr), Ctrl(nullptr), Capacity(0), Size(0), MaxLoadFactor(Other.MaxLoadFactor), Hasher(Other.Hasher)
+		{
+			if (Other.Capacity > 0)
+			{
+				AllocateStorage(Other.Capacity);
+				for (size_t i = 0; i < Capacity; ++i)
+				{
+					if (Other.Ctrl[i] != THashGroup::Empty)
+					{
+						::new (static_cast<void*>(Slots + i)) ElementType(Other.Slots[i]);
+						SetCtrl(i, Other.Ctrl[i]);
+						++Size;
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Constructor de movimiento.
+		 */
+		THashTable(THashTable&& Other) noexcept
+			: Alloc(std::move(Other.GetAllocator())), Slots(Other.Slots), Ctrl(Other.Ctrl), Capacity(Other.Capacity), Size(Other.Size),
+			MaxLoadFactor(Other.MaxLoadFactor), Hasher(std::move(Other.Hasher))
+		{
+			Other.Slots = nullptr;
+			Other.Ctrl = nullptr;
+			Other.Capacity = 0;
+			Other.Size = 0;
+		}
+
+		/**
+		 * @brief Operador de asignacin de copia.
+		 */
+		THashTable& operator=(const THashTable& Other)
+		{
+			if (this != &Other)
+			{
+				THashTable Copy(Other);
+				*this = std::move(Copy);
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Operador de asignacin de movimiento.
+		 */
+		THashTable& operator=(THashTable&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				Empty();
+				DeallocateStorage(Slots, Ctrl, Capacity);
+				GetAllocator() = std::move(Other.GetAllocator());
+				Slots = Other.Slots;
+				Ctrl = Other.Ctrl;
+				Capacity = Other.Capacity;
+				Size = Other.Size;
+				MaxLoadFactor = Other.MaxLoadFactor;
+				Hasher = std::move(Other.Hasher);
+				Other.Slots = nullptr;
+				Other.Ctrl = nullptr;
+				Other.Capacity = 0;
+				Other.Size = 0;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Destructor. Destruye los elementos y libera la memoria.
+		 */
+		~THashTable()
+		{
+			Empty();
+			DeallocateStorage(Slots, Ctrl, Capacity);
+		}
+
+		/**
+		 * @brief Calcula el hash de una clave con el functor de la tabla.
+		 */
+		size_t HashKey(const KeyType& Key) const
+		{
+			return Hasher(Key);
+		}
+
+		/**
+		 * @brief Busca una clave cuyo hash ya se ha calculado.
+		 *
+		 * @param Key La clave a buscar.
+		 * @param Hash El hash de la clave.
+		 * @return El ndice de la ranura, o INDEX_NONE si no existe.
+		 */
+		size_t FindHashed(const KeyType& Key, size_t Hash) const
+		{
+			if (Size == 0)
+			{
+				return INDEX_NONE;
+			}
+			size_t Mask = Capacity - 1;
+			size_t Pos = HomeIndex(Hash);
+			uint8_t Tag = H2(Hash);
+			while (true)
+			{
+				THashGroup Group(Ctrl + Pos);
+				for (uint32_t Matches = Group.Match(Tag); Matches; Matches &= Matches - 1)
+				{
+					size_t Index = (Pos + THashGroup::LowestBit(Matches)) & Mask;
+					if (KeyFuncs::GetKey(Slots[Index]) == Key)
+					{
+						return Index;
+					}
+				}
+				if (Group.MatchEmpty())
+				{
+					return INDEX_NONE;
+				}
+				Pos = (Pos + THashGroup::Width) & Mask;
+			}
+		}
+
+		/**
+		 * @brief Busca una clave.
+		 *
+		 * @param Key La clave a buscar.
+		 * @return El ndice de la ranura, o INDEX_NONE si no existe.
+		 */
+		size_t Find(const KeyType& Key) const
+		{
+			return Size == 0 ? INDEX_NONE : FindHashed(Key, Hasher(Key));
+		}
+
+		/**
+		 * @brief Construye un elemento cuya clave se sabe que no est en la tabla.
+		 *
+		 * @param Hash El hash de la clave del nuevo elemento.
+		 * @param args Argumentos del constructor del elemento.
+		 * @return El ndice de la ranura ocupada.
+		 */
+		template<typename... Args>
+		size_t EmplaceNew(size_t Hash, Args&&... args)
+		{
+			GrowIfNeeded();
+			size_t Index = FindEmptySlot(Hash);
+			::new (static_cast<void*>(Slots + Index)) ElementType(std::forward<Args>(args)...);
+			SetCtrl(Index, H2(Hash));
+			++Size;
+			return Index;
+		}
+
+		/**
+		 * @brief Elimina el elemento de una ranura desplazando hacia atrs los que le siguen.
+		 *
+		 * @param Index El ndice de una ranura ocupada.
+		 */
+		void RemoveAt(size_t Index)
+		{
+			size_t Mask = Capacity - 1;
+			size_t Hole = Index;
+			Slots[Hole].~ElementType();
+			for (size_t Next = (Hole + 1) & Mask; Ctrl[Next] != THashGroup::Empty; Next = (Next + 1) & Mask)
+			{
+				size_t Home = HomeIndex(Hasher(KeyFuncs::GetKey(Slots[Next])));
+				// El elemento puede ocupar el hueco si ste queda entre su posicin inicial y la actual.
+				if (((Next - Home) & Mask) >= ((Next - Hole) & Mask))
+				{
+					::new (static_cast<void*>(Slots + Hole)) ElementType(std::move(Slots[Next]));
+					Slots[Next].~ElementType();
+					SetCtrl(Hole, Ctrl[Next]);
+					Hole = Next;
+				}
+			}
+			SetCtrl(Hole, THashGroup::Empty);
+			--Size;
+		}
+
+		/**
+		 * @brief Elimina en una sola pasada todos los elementos que cumplen un predicado.
+		 *
+		 * Tras borrar una ranura se vuelve a examinar, porque el desplazamiento hacia atrs
+		 * puede haber trado a ella un elemento an no visitado. No reserva memoria.
+		 *
+		 * @param Predicate Functor bool(const ElementType&).
+		 * @return El nmero de elementos eliminados.
+		 */
+		template<typename Pred>
+		size_t RemoveIf(Pred Predicate)
+		{
+			size_t Removed = 0;
+			for (size_t i = 0; i < Capacity && Size > 0;)
+			{
+				if (Ctrl[i] != THashGroup::Empty && Predicate(static_cast<const ElementType&>(Slots[i])))
+				{
+					RemoveAt(i);
+					++Removed;
+				}
+				else
+				{
+					++i;
+				}
+			}
+			return Removed;
+		}
+
+		/**
+		 * @brief Destruye todos los elementos manteniendo la capacidad.
+		 */
+		void Empty()
+		{
+			for (size_t i = 0; i < Capacity && Size > 0; ++i)
+			{
+				if (Ctrl[i] != THashGroup::Empty)
+				{
+					Slots[i].~ElementType();
+					--Size;
+				}
+			}
+			if (Ctrl)
+			{
+				std::memset(Ctrl, THashGroup::Empty, Capacity + THashGroup::Width);
+			}
+			Size = 0;
+		}
+
+		/**
+		 * @brief Asegura capacidad para Count elementos sin volver a crecer.
+		 *
+		 * @param Count Nmero de elementos esperado.
+		 */
+		void Reserve(size_t Count)
+		{
+			size_t NewCapacity = Capacity == 0 ? THashGroup::Width : Capacity;
+			while (static_cast<float>(Count) > static_cast<float>(NewCapacity) * MaxLoadFactor)
+			{
+				NewCapacity *= 2;
+			}
+			if (NewCapacity != Capacity)
+			{
+				Rehash(NewCapacity);
+			}
+		}
+
+		/**
+		 * @brief Cambia el factor de carga mximo. Se limita al rango [0.25, 0.95].
+		 *
+		 * @param LoadFactor Nueva fraccin mxima de ranuras ocupadas.
+		 */
+		void SetMaxLoadFactor(float LoadFactor)
+		{
+			MaxLoadFactor = LoadFactor < 0.25f ? 0.25f : (LoadFactor > 0.95f ? 0.95f : LoadFactor);
+			if (Size > 0)
+			{
+				Reserve(Size);
+			}
+		}
+
+		Alloc& GetAllocator() { return *this; }
+		const Alloc& GetAllocator() const { return *this; }
+
+		float GetMaxLoadFactor() const { return MaxLoadFactor; }
+		size_t Num() const { return Size; }
+		size_t GetCapacity() const { return Capacity; }
+
+		/**
+		 * @brief Indica si una ranura (0 <= Index < GetCapacity()) contiene un elemento.
+		 */
+		bool IsValidIndex(size_t Index) const
+		{
+			return Index < Capacity && Ctrl[Index] != THashGroup::Empty;
+		}
+
+		ElementType& GetElement(size_t Index) { return Slots[Index]; }
+		const ElementType& GetElement(size_t Index) const { return Slots[Index]; }
+	};
+}
@@ -0,0 +1,632 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "TArray.h"
+#include "Memory/HeapAllocator.h"
+
+namespace EngineUtilities {
+	/**
+	 * @brief Array dinmico con bfer interno para los primeros N elementos.
+	 *
+	 * Tiene la misma interfaz que TArray, pero mientras el array tenga como mucho N elementos
+	 * viven dentro del propio objeto y no se pide memoria a la poltica. Al superar N se pasa a
+	 * un bloque de la poltica (reubicando los elementos) y, desde ah, crece como TArray.
+	 * Pensado para las listas cortas que abundan en un motor (hijos de un nodo, slots de
+	 * material), donde la mayora nunca supera unos pocos elementos.
+	 *
+	 * A diferencia de TArray, mover un TInlineArray cuyo contenido est en el bfer interno
+	 * mueve los elementos uno a uno, y sizeof(TInlineArray) incluye N * sizeof(T).
+	 *
+	 * @tparam T El tipo de elementos almacenados en el array.
+	 * @tparam N Nmero de elementos que caben en el bfer interno.
+	 * @tparam Alloc La poltica de memoria para los elementos que no caben (por defecto FHeapAllocator).
+	 */
+	template<typename T, size_t N, typename Alloc = FHeapAllocator>
+	class TInlineArray : private Alloc
+	{
+		static_assert(N > 0, "TInlineArray necesita al menos un elemento interno");
+
+	private:
+		T* Data;           ///< Elementos: apunta a InlineStorage o a un bloque de la poltica.
+		size_t Capacity;   ///< Capacidad actual (N mientras se usa el bfer interno).
+		size_t Size;       ///< Nmero de elementos actualmente en el array.
+		alignas(T) unsigned char InlineStorage[N * sizeof(T)]; ///< Bfer interno para los primeros N elementos.
+
+		static constexpr bool bTriviallyRelocatable = TIsTriviallyRelocatable<T>::value;
+
+		T* GetInlineData()
+		{
+			return reinterpret_cast<T*>(InlineStorage);
+		}
+
+		T* Allocate(size_t Count)
+		{
+			return static_cast<T*>(GetAllocator().Allocate(Count * sizeof(T), alignof(T)));
+		}
+
+		/**
+		 * @brief Libera el bloque actual si no es el bfer interno. No destruye los elementos.
+		 */
+		void ReleaseHeap()
+		{
+			if (!IsInline())
+			{
+				GetAllocator().Deallocate(Data, Capacity * sizeof(T), alignof(T));
+			}
+		}
+
+		/**
+		 * @brief Reubica Count elementos de Source a Dest (memoria sin inicializar).
+		 */
+		static void Relocate(T* Dest, T* Source, size_t Count)
+		{
+			if constexpr (bTriviallyRelocatable)
+			{
+				if (Count > 0)
+				{
+					std::memcpy(static_cast<void*>(Dest), static_cast<const void*>(Source), Count * sizeof(T));
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < Count; ++i)
+				{
+					::new (static_cast<void*>(Dest + i)) T(std::move_if_noexcept(Source[i]));
+					Source[i].~T();
+				}
+			}
+		}
+
+		void DestroyElements(size_t Count)
+		{
+			if constexpr (!std::is_trivially_destructible<T>::value)
+			{
+				for (size_t i = 0; i < Count; ++i)
+				{
+					Data[i].~T();
+				}
+			}
+		}
+
+		/**
+		 * @brief Termina el programa si Index no es una posicin vlida.
+		 */
+		void CheckIndex(size_t Index) const
+		{
+			if (Index >= Size)
+			{
+				std::cerr << "Index out of range" << std::endl;
+				exit(1);
+			}
+		}
+
+		/**
+		 * @brief Cambia la capacidad a NewCapacity (>= Size). Hasta N elementos se usa el bfer interno.
+		 */
+		void Resize(size_t NewCapacity)
+		{
+			if (NewCapacity <= N)
+			{
+				if (!IsInline())
+				{
+					Relocate(GetInlineData(), Data, Size);
+					ReleaseHeap();
+					Data = GetInlineData();
+					Capacity = N;
+				}
+				return;
+			}
+			if constexpr (bTriviallyRelocatable)
+			{
+				if (!IsInline())
+				{
+					Data = static_cast<T*>(GetAllocator().Reallocate(Data, Capacity * sizeof(T), NewCapacity * sizeof(T), alignof(T)));
+					Capacity = NewCapacity;
+					return;
+				}
+			}
+			T* NewData = Allocate(NewCapacity);
+			Relocate(NewData, Data, Size);
+			ReleaseHeap();
+			Data = NewData;
+			Capacity = NewCapacity;
+		}
+
+		/**
+		 * @brief Toma el contenido de Other, que queda vaco y usando su bfer interno.
+		 */
+		void StealFrom(TInlineArray& Other)
+		{
+			if (Other.IsInline())
+			{
+				Relocate(Data, Other.Data, Other.Size);
+			}
+			else
+			{
+				Data = Other.Data;
+				Capacity = Other.Capacity;
+				Other.Data = Other.GetInlineData();
+				Other.Capacity = N;
+			}
+			Size = Other.Size;
+			Other.Size = 0;
+		}
+
+		/**
+		 * @brief Construye un nuevo elemento al final cuando el array est lleno.
+		 *
+		 * Como en TArray, el elemento se construye antes de liberar el bloque antiguo para que
+		 * los argumentos puedan referirse a elementos del propio array.
+		 */
+		template<typename... Args>
+		T& EmplaceGrow(Args&&... args)
+		{
+			size_t NewCapacity = Capacity * 2;
+			if constexpr (bTriviallyRelocatable)
+			{
+				if (!IsInline())
+				{
+					// Ya en la poltica: el bloque puede crecer en su sitio con Reallocate.
+					T Element(std::forward<Args>(args)...);
+					Data = static_cast<T*>(GetAllocator().Reallocate(Data, Capacity * sizeof(T), NewCapacity * sizeof(T), alignof(T)));
+					Capacity = NewCapacity;
+					::new (static_cast<void*>(Data + Size)) T(std::move(Element));
+					return Data[Size++];
+				}
+			}
+			T* NewData = Allocate(NewCapacity);
+			try
+			{
+				::new (static_cast<void*>(NewData + Size)) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				GetAllocator().Deallocate(NewData, NewCapacity * sizeof(T), alignof(T));
+				throw;
+			}
+			Relocate(NewData, Data, Size);
+			ReleaseHeap();
+			Data = NewData;
+			Capacity = NewCapacity;
+			return Data[Size++];
+		}
+
+	public:
+		/**
+		 * @brief Constructor por defecto: array vaco usando el bfer interno.
+		 */
+		TInlineArray() : Data(GetInlineData()), Capacity(N), Size(0) {}
+
+		/**
+		 * @brief Constructor que usa una instancia concreta de la poltica de memoria.
+		 *
+		 * @param InAllocator La poltica de la que se pedir la memoria si se superan N elementos.
+		 */
+		explicit TInlineArray(const Alloc& InAllocator) : Alloc(InAllocator), Data(GetInlineData()), Capacity(N), Size(0) {}
+
+		/**
+		 * @brief Constructor de copia. Slo reserva memoria si Other tiene ms de N elementos.
+		 *
+		 * @param Other El array a copiar.
+		 */
+		TInlineArray(const TInlineArray& Other) : Alloc(Other.GetAllocator()), Data(GetInlineData()), Capacity(N), Size(0)
+		{
+			if (Other.Size > N)
+			{
+				Data = Allocate(Other.Size);
+				Capacity = Other.Size;
+			}
+			try
+			{
+				for (; Size < Other.Size; ++Size)
+				{
+					::new (static_cast<void*>(Data + Size)) T(Other.Data[Size]);
+				}
+			}
+			catch (...)
+			{
+				DestroyElements(Size);
+				ReleaseHeap();
+				throw;
+			}
+		}
+
+		/**
+		 * @brief Constructor de movimiento. Toma el bloque de Other o, si usa el bfer interno, mueve sus elementos.
+		 *
+		 * @param Other El array del que se toman los elementos.
+		 */
+		TInlineArray(TInlineArray&& Other) noexcept(std::is_nothrow_move_constructible<T>::value)
+			: Alloc(std::move(Other.GetAllocator())), Data(GetInlineData()), Capacity(N), Size(0)
+		{
+			StealFrom(Other);
+		}
+
+		/**
+		 * @brief Operador de asignacin de copia.
+		 *
+		 * @param Other El array a copiar.
+		 * @return Referencia a este array.
+		 */
+		TInlineArray& operator=(const TInlineArray& Other)
+		{
+			if (this != &Other)
+			{
+				TInlineArray Copy(Other);
+				*this = std::move(Copy);
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Operador de asignacin de movimiento. La poltica de memoria viaja con el bloque.
+		 *
+		 * @param Other El array del que se toman los elementos.
+		 * @return Referencia a este array.
+		 */
+		TInlineArray& operator=(TInlineArray&& Other) noexcept(std::is_nothrow_move_constructible<T>::value)
+		{
+			if (this != &Other)
+			{
+				DestroyElements(Size);
+				ReleaseHeap();
+				Data = GetInlineData();
+				Capacity = N;
+				Size = 0;
+				GetAllocator() = std::move(Other.GetAllocator());
+				StealFrom(Other);
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Destructor que destruye los elementos y libera el bloque de la poltica, si lo hay.
+		 */
+		~TInlineArray()
+		{
+			DestroyElements(Size);
+			ReleaseHeap();
+		}
+
+		/**
+		 * @brief Construye un nuevo elemento al final del array a partir de los argumentos dados.
+		 *
+		 * @param args Argumentos que se reenvan al constructor de T.
+		 * @return Referencia al elemento construido.
+		 */
+		template<typename... Args>
+		T& Emplace(Args&&... args)
+		{
+			if (Size == Capacity)
+			{
+				return EmplaceGrow(std::forward<Args>(args)...);
+			}
+			::new (static_cast<void*>(Data + Size)) T(std::forward<Args>(args)...);
+			return Data[Size++];
+		}
+
+		/**
+		 * @brief Aade un nuevo elemento al final del array.
+		 *
+		 * @param Element El elemento a aadir al array.
+		 */
+		void Add(const T& Element)
+		{
+			Emplace(Element);
+		}
+
+		/**
+		 * @brief Aade un nuevo elemento al final del array movindolo.
+		 *
+		 * @param Element El elemento a mover al array.
+		 */
+		void Add(T&& Element)
+		{
+			Emplace(std::move(Element));
+		}
+
+		/**
+		 * @brief Elimina el elemento en la posicin especificada conservando el orden.
+		 *
+		 * Desplaza los elementos siguientes una posicin (con un nico memmove si T es
+		 * trivialmente reubicable). Un ndice fuera de rango termina el programa.
+		 *
+		 * @param Index La posicin del elemento a eliminar.
+		 */
+		void RemoveAt(size_t Index)
+		{
+			RemoveRange(Index, 1);
+		}
+
+		/**
+		 * @brief Elimina el elemento en la posicin especificada en O(1) sin conservar el orden.
+		 *
+		 * El ltimo elemento pasa a ocupar la posicin eliminada.
+		 *
+		 * @param Index La posicin del elemento a eliminar.
+		 */
+		void RemoveAtSwap(size_t Index)
+		{
+			CheckIndex(Index);
+			size_t Last = Size - 1;
+			if constexpr (bTriviallyRelocatable)
+			{
+				Data[Index].~T();
+				if (Index != Last)
+				{
+					std::memcpy(static_cast<void*>(Data + Index), static_cast<const void*>(Data + Last), sizeof(T));
+				}
+			}
+			else
+			{
+				if (Index != Last)
+				{
+					Data[Index] = std::move(Data[Last]);
+				}
+				Data[Last].~T();
+			}
+			Size = Last;
+		}
+
+		/**
+		 * @brief Elimina Count elementos a partir de Index conservando el orden.
+		 *
+		 * Los elementos siguientes se desplazan una sola vez. Un rango fuera del array termina el programa.
+		 *
+		 * @param Index La posicin del primer elemento a eliminar.
+		 * @param Count El nmero de elementos a eliminar.
+		 */
+		void RemoveRange(size_t Index, size_t Count)
+		{
+			if (Index > Size || Count > Size - Index)
+			{
+				std::cerr << "Index out of range" << std::endl;
+				exit(1);
+			}
+			if (Count == 0)
+			{
+				return;
+			}
+			size_t Tail = Size - Index - Count;
+			if constexpr (bTriviallyRelocatable)
+			{
+				for (size_t i = Index; i < Index + Count; ++i)
+				{
+					Data[i].~T();
+				}
+				if (Tail > 0)
+				{
+					std::memmove(static_cast<void*>(Data + Index), static_cast<const void*>(Data + Index + Count), Tail * sizeof(T));
+				}
+			}
+			else
+			{
+				for (size_t i = Index; i < Index + Tail; ++i)
+				{
+					Data[i] = std::move(Data[i + Count]);
+				}
+				for (size_t i = Index + Tail; i < Size; ++i)
+				{
+					Data[i].~T();
+				}
+			}
+			Size -= Count;
+		}
+
+		/**
+		 * @brief Elimina todos los elementos que cumplen Pred en una sola pasada, conservando el orden.
+		 *
+		 * Cada elemento que se queda se mueve como mucho una vez.
+		 *
+		 * @param Pred Predicado bool(const T&).
+		 * @return El nmero de elementos eliminados.
+		 */
+		template<typename Predicate>
+		size_t RemoveAllMatching(Predicate Pred)
+		{
+			size_t Write = 0;
+			for (size_t Read = 0; Read < Size; ++Read)
+			{
+				if (!Pred(static_cast<const T&>(Data[Read])))
+				{
+					if (Write != Read)
+					{
+						Data[Write] = std::move(Data[Read]);
+					}
+					++Write;
+				}
+			}
+			size_t Removed = Size - Write;
+			for (size_t i = Write; i < Size; ++i)
+			{
+				Data[i].~T();
+			}
+			Size = Write;
+			return Removed;
+		}
+
+		/**
+		 * @brief Asegura capacidad para al menos NewCapacity elementos sin ms reservas.
+		 *
+		 * @param NewCapacity La capacidad mnima deseada.
+		 */
+		void Reserve(size_t NewCapacity)
+		{
+			if (NewCapacity > Capacity)
+			{
+				Resize(NewCapacity);
+			}
+		}
+
+		/**
+		 * @brief Ajusta la capacidad al nmero de elementos; si caben en el bfer interno, vuelven a l.
+		 */
+		void Shrink()
+		{
+			if (Size != Capacity)
+			{
+				Resize(Size);
+			}
+		}
+
+		/**
+		 * @brief Elimina todos los elementos.
+		 *
+		 * @param bKeepCapacity Si es true conserva el bloque de la poltica para volver a llenar
+		 *        el array sin reservas; si no, lo libera y vuelve al bfer interno.
+		 */
+		void Empty(bool bKeepCapacity = false)
+		{
+			DestroyElements(Size);
+			Size = 0;
+			if (!bKeepCapacity)
+			{
+				ReleaseHeap();
+				Data = GetInlineData();
+				Capacity = N;
+			}
+		}
+
+		/**
+		 * @brief Sobrecarga del operador [] para acceder a elementos por ndice.
+		 *
+		 * Slo comprueba el ndice si ENGINEUTILITIES_CHECK_BOUNDS est activo (compilaciones de
+		 * depuracin); en las dems es un acceso directo que no impide vectorizar los bucles.
+		 *
+		 * @param Index La posicin del elemento a acceder.
+		 * @return Referencia al elemento en la posicin especificada.
+		 */
+		T& operator[](size_t Index)
+		{
+#if ENGINEUTILITIES_CHECK_BOUNDS
+			CheckIndex(Index);
+#endif
+			return Data[Index];
+		}
+
+		/**
+		 * @brief Versin constante de la sobrecarga del operador [] para acceder a elementos por ndice.
+		 *
+		 * @param Index La posicin del elemento a acceder.
+		 * @return Referencia constante al elemento en la posicin especificada.
+		 */
+		const T& operator[](size_t Index) const
+		{
+#if ENGINEUTILITIES_CHECK_BOUNDS
+			CheckIndex(Index);
+#endif
+			return Data[Index];
+		}
+
+		/**
+		 * @brief Acceso por ndice comprobado siempre. Un ndice fuera de rango termina el programa.
+		 *
+		 * @param Index La posicin del elemento a acceder.
+		 * @return Referencia al elemento en la posicin especificada.
+		 */
+		T& At(size_t Index)
+		{
+			CheckIndex(Index);
+			return Data[Index];
+		}
+
+		const T& At(size_t Index) const
+		{
+			CheckIndex(Index);
+			return Data[Index];
+		}
+
+		/**
+		 * @brief Devuelve un puntero a los elementos, contiguos en memoria.
+		 */
+		T* GetData()
+		{
+			return Data;
+		}
+
+		const T* GetData() const
+		{
+			return Data;
+		}
+
+		/**
+		 * @brief Iteradores de acceso aleatorio sobre los elementos (punteros, al ser memoria contigua).
+		 *
+		 * Permiten el for por rango y los algoritmos de la STL (std::sort, std::find...). Se
+		 * invalidan al aadir o eliminar elementos.
+		 */
+		T* begin() { return Data; }
+		T* end() { return Data + Size; }
+		const T* begin() const { return Data; }
+		const T* end() const { return Data + Size; }
+
+		/**
+		 * @brief Devuelve el nmero de elementos actualmente en el array.
+		 */
+		size_t Num() const
+		{
+			return Size;
+		}
+
+		/**
+		 * @brief Devuelve la capacidad actual del array (al menos N).
+		 */
+		size_t GetCapacity() const
+		{
+			return Capacity;
+		}
+
+		/**
+		 * @brief Indica si los elementos siguen en el bfer interno (sin memoria de la poltica).
+		 */
+		bool IsInline() const
+		{
+			return Data == reinterpret_cast<const T*>(InlineStorage);
+		}
+
+		/**
+		 * @brief Devuelve la poltica de memoria del array.
+		 */
+		Alloc& GetAllocator()
+		{
+			return *this;
+		}
+
+		const Alloc& GetAllocator() const
+		{
+			return *this;
+		}
+	};
+}
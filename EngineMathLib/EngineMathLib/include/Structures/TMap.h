@@ -27,18 +27,26 @@
  * SOFTWARE.
 */
 #pragma once
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include "THashTable.h"
+
 namespace EngineUtilities {
 	/**
 	 * @brief TMap es una clase de mapa (diccionario) dinmica para almacenar pares clave-valor.
 	 *
 	 * Esta implementacin de TMap proporciona una forma sencilla de almacenar y gestionar
 	 * colecciones de pares clave-valor, con operaciones bsicas como agregar, eliminar y acceder a valores.
-	 * La memoria se gestiona dinmicamente, aumentando la capacidad del mapa segn sea necesario.
+	 * Los pares se guardan en una tabla hash de direccionamiento abierto (THashTable), por lo que
+	 * la insercin, la bsqueda y el borrado cuestan O(1) de media.
 	 *
 	 * @tparam K El tipo de las claves.
 	 * @tparam V El tipo de los valores.
+	 * @tparam HashFunc Functor de hash de las claves (por defecto THash<K>).
+	 * @tparam Alloc La poltica de memoria de la tabla (por defecto FHeapAllocator).
 	 */
-	template<typename K, typename V>
+	template<typename K, typename V, typename HashFunc = THash<K>, typename Alloc = FHeapAllocator>
 	class TMap
 	{
 	private:
@@ -49,44 +57,36 @@ namespace EngineUtilities {
 
 			Pair() : Key(), Value() {}
 			Pair(const K& Key, const V& Value) : Key(Key), Value(Value) {}
+			Pair(K&& Key, V&& Value) : Key(std::move(Key)), Value(std::move(Value)) {}
 		};
 
-		Pair* Data;        ///< Puntero a la memoria donde se almacenan los pares clave-valor.
-		size_t Capacity;   ///< Capacidad actual del mapa (nmero de pares que puede almacenar).
-		size_t Size;       ///< Nmero de pares actualmente en el mapa.
-
 		/**
-		 * @brief Redimensiona el mapa para tener una nueva capacidad.
-		 *
-		 * @param NewCapacity La nueva capacidad del mapa.
+		 * @brief Describe a THashTable cmo obtener la clave de un par.
 		 */
-		void Resize(size_t NewCapacity)
+		struct PairKeyFuncs
 		{
-			Pair* NewData = new Pair[NewCapacity];  ///< Crear un nuevo bloque de memoria con la nueva capacidad.
-			for (size_t i = 0; i < Size; ++i)
-			{
-				NewData[i] = Data[i];  ///< Copiar los pares existentes al nuevo bloque de memoria.
-			}
-			delete[] Data;  ///< Liberar la memoria del mapa antiguo.
-			Data = NewData; ///< Actualizar el puntero Data para que apunte al nuevo bloque de memoria.
-			Capacity = NewCapacity;  ///< Actualizar la capacidad del mapa.
-		}
+			using KeyType = K;
+			using HashType = HashFunc;
+			static const K& GetKey(const Pair& Element) { return Element.Key; }
+		};
+
+		THashTable<Pair, PairKeyFuncs, Alloc> Table; ///< Tabla hash que almacena los pares clave-valor.
 
 	public:
 		/**
-		 * @brief Constructor por defecto que inicializa el mapa con capacidad y tamao cero.
+		 * @brief Constructor por defecto que crea un mapa vaco sin reservar memoria.
 		 */
 		TMap()
-			: Data(nullptr), Capacity(0), Size(0)
 		{
 		}
 
 		/**
-		 * @brief Destructor que libera la memoria asignada al mapa.
+		 * @brief Constructor que crea un mapa vaco que pedir la memoria a InAllocator.
+		 *
+		 * @param InAllocator La poltica de memoria a utilizar.
 		 */
-		~TMap()
+		explicit TMap(const Alloc& InAllocator) : Table(InAllocator)
 		{
-			delete[] Data;  ///< Liberar la memoria del mapa.
 		}
 
 		/**
@@ -97,43 +97,67 @@ namespace EngineUtilities {
 		 */
 		void Add(const K& Key, const V& Value)
 		{
-			for (size_t i = 0; i < Size; ++i)
-			{
-				if (Data[i].Key == Key)
-				{
-					Data[i].Value = Value;  ///< Actualizar el valor si la clave ya existe.
-					return;
-				}
-			}
-			if (Size == Capacity)
+			size_t Hash = Table.HashKey(Key);
+			size_t Index = Table.FindHashed(Key, Hash);
+			if (Index != Table.INDEX_NONE)
 			{
-				Resize(Capacity == 0 ? 1 : Capacity * 2);  ///< Redimensionar si es necesario.
+				Table.GetElement(Index).Value = Value;  ///< Actualizar el valor si la clave ya existe.
+				return;
 			}
-			Data[Size++] = Pair(Key, Value);  ///< Aadir el nuevo par y aumentar el tamao.
+			Table.EmplaceNew(Hash, Key, Value);  ///< Aadir el nuevo par.
 		}
 
 		/**
-		 * @brief Elimina el par clave-valor en la posicin especificada.
+		 * @brief Elimina el par clave-valor con la clave especificada.
 		 *
 		 * @param Key La clave del par a eliminar.
 		 */
 		void Remove(const K& Key)
 		{
-			for (size_t i = 0; i < Size; ++i)
+			size_t Index = Table.Find(Key);
+			if (Index != Table.INDEX_NONE)
 			{
-				if (Data[i].Key == Key)
-				{
-					for (size_t j = i; j < Size - 1; ++j)
-					{
-						Data[j] = Data[j + 1];  ///< Desplazar los pares hacia la izquierda para llenar el hueco.
-					}
-					--Size;  ///< Disminuir el tamao del mapa.
-					return;
-				}
+				Table.RemoveAt(Index);
+				return;
 			}
 			std::cerr << "Key not found" << std::endl;  ///< Manejar el caso de clave no encontrada.
 		}
 
+		/**
+		 * @brief Busca el valor asociado a una clave.
+		 *
+		 * @param Key La clave a buscar.
+		 * @return Puntero al valor, o nullptr si la clave no existe.
+		 */
+		V* Find(const K& Key)
+		{
+			size_t Index = Table.Find(Key);
+			return Index != Table.INDEX_NONE ? &Table.GetElement(Index).Value : nullptr;
+		}
+
+		/**
+		 * @brief Versin constante de Find.
+		 *
+		 * @param Key La clave a buscar.
+		 * @return Puntero constante al valor, o nullptr si la clave no existe.
+		 */
+		const V* Find(const K& Key) const
+		{
+			size_t Index = Table.Find(Key);
+			return Index != Table.INDEX_NONE ? &Table.GetElement(Index).Value : nullptr;
+		}
+
+		/**
+		 * @brief Verifica si el mapa contiene la clave especificada.
+		 *
+		 * @param Key La clave a verificar.
+		 * @return true si la clave existe, false en caso contrario.
+		 */
+		bool Contains(const K& Key) const
+		{
+			return Table.Find(Key) != Table.INDEX_NONE;
+		}
+
 		/**
 		 * @brief Sobrecarga del operador [] para acceder a valores por clave.
 		 *
@@ -142,15 +166,13 @@ namespace EngineUtilities {
 		 */
 		V& operator[](const K& Key)
 		{
-			for (size_t i = 0; i < Size; ++i)
+			V* Value = Find(Key);
+			if (Value == nullptr)
 			{
-				if (Data[i].Key == Key)
-				{
-					return Data[i].Value;  ///< Devolver el valor si la clave se encuentra.
-				}
+				std::cerr << "Key not found" << std::endl;  ///< Manejar el caso de clave no encontrada.
+				exit(1);  ///< Salir del programa en caso de error.
 			}
-			std::cerr << "Key not found" << std::endl;  ///< Manejar el caso de clave no encontrada.
-			exit(1);  ///< Salir del programa en caso de error.
+			return *Value;  ///< Devolver el valor si la clave se encuentra.
 		}
 
 		/**
@@ -161,15 +183,33 @@ namespace EngineUtilities {
 		 */
 		const V& operator[](const K& Key) const
 		{
-			for (size_t i = 0; i < Size; ++i)
+			const V* Value = Find(Key);
+			if (Value == nullptr)
 			{
-				if (Data[i].Key == Key)
-				{
-					return Data[i].Value;  ///< Devolver el valor si la clave se encuentra.
-				}
+				std::cerr << "Key not found" << std::endl;  ///< Manejar el caso de clave no encontrada.
+				exit(1);  ///< Salir del programa en caso de error.
 			}
-			std::cerr << "Key not found" << std::endl;  ///< Manejar el caso de clave no encontrada.
-			exit(1);  ///< Salir del programa en caso de error.
+			return *Value;  ///< Devolver el valor si la clave se encuentra.
+		}
+
+		/**
+		 * @brief Reserva espacio para Count pares sin volver a redimensionar.
+		 *
+		 * @param Count Nmero de pares esperado.
+		 */
+		void Reserve(size_t Count)
+		{
+			Table.Reserve(Count);
+		}
+
+		/**
+		 * @brief Cambia el factor de carga mximo de la tabla (por defecto 0.75).
+		 *
+		 * @param LoadFactor Fraccin mxima de ranuras ocupadas, entre 0.25 y 0.95.
+		 */
+		void SetMaxLoadFactor(float LoadFactor)
+		{
+			Table.SetMaxLoadFactor(LoadFactor);
 		}
 
 		/**
@@ -179,17 +219,30 @@ namespace EngineUtilities {
 		 */
 		size_t Num() const
 		{
-			return Size;  ///< Devolver el tamao actual del mapa.
+			return Table.Num();  ///< Devolver el tamao actual del mapa.
+		}
+
+		/**
+		 * @brief Devuelve la poltica de memoria del mapa.
+		 */
+		Alloc& GetAllocator()
+		{
+			return Table.GetAllocator();
+		}
+
+		const Alloc& GetAllocator() const
+		{
+			return Table.GetAllocator();
 		}
 
 		/**
 		 * @brief Devuelve la capacidad actual del mapa.
 		 *
-		 * @return La capacidad del mapa.
+		 * @return La capacidad del mapa (nmero de ranuras de la tabla).
 		 */
 		size_t GetCapacity() const
 		{
-			return Capacity;  ///< Devolver la capacidad actual del mapa.
+			return Table.GetCapacity();  ///< Devolver la capacidad actual del mapa.
 		}
 	};
 
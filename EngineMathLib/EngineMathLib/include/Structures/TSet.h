@@ -27,6 +27,9 @@
  * SOFTWARE.
 */
 #pragma once
+#include <iostream>
+#include <utility>
+#include "THashTable.h"
 
 namespace EngineUtilities {
 	/**
@@ -34,50 +37,44 @@ namespace EngineUtilities {
 	 *
 	 * Esta implementacin de TSet proporciona una forma sencilla de almacenar y gestionar
 	 * colecciones de elementos nicos, con operaciones bsicas como agregar, eliminar y verificar la existencia de elementos.
-	 * La memoria se gestiona dinmicamente, aumentando la capacidad del conjunto segn sea necesario.
+	 * Los elementos se guardan en la misma tabla hash que TMap (THashTable) y usan el mismo rasgo
+	 * THash, por lo que Add, Remove y Contains cuestan O(1) de media.
 	 *
 	 * @tparam T El tipo de los elementos almacenados en el conjunto.
+	 * @tparam HashFunc Functor de hash de los elementos (por defecto THash<T>).
+	 * @tparam Alloc La poltica de memoria de la tabla (por defecto FHeapAllocator).
 	 */
-	template<typename T>
+	template<typename T, typename HashFunc = THash<T>, typename Alloc = FHeapAllocator>
 	class TSet
 	{
 	private:
-		T* Data;        ///< Puntero a la memoria donde se almacenan los elementos.
-		size_t Capacity;   ///< Capacidad actual del conjunto (nmero de elementos que puede almacenar).
-		size_t Size;       ///< Nmero de elementos actualmente en el conjunto.
-
 		/**
-		 * @brief Redimensiona el conjunto para tener una nueva capacidad.
-		 *
-		 * @param NewCapacity La nueva capacidad del conjunto.
+		 * @brief Describe a THashTable que la clave de cada elemento es el propio elemento.
 		 */
-		void Resize(size_t NewCapacity)
+		struct ElementKeyFuncs
 		{
-			T* NewData = new T[NewCapacity];  ///< Crear un nuevo bloque de memoria con la nueva capacidad.
-			for (size_t i = 0; i < Size; ++i)
-			{
-				NewData[i] = Data[i];  ///< Copiar los elementos existentes al nuevo bloque de memoria.
-			}
-			delete[] Data;  ///< Liberar la memoria del conjunto antiguo.
-			Data = NewData; ///< Actualizar el puntero Data para que apunte al nuevo bloque de memoria.
-			Capacity = NewCapacity;  ///< Actualizar la capacidad del conjunto.
-		}
+			using KeyType = T;
+			using HashType = HashFunc;
+			static const T& GetKey(const T& Element) { return Element; }
+		};
+
+		THashTable<T, ElementKeyFuncs, Alloc> Table; ///< Tabla hash que almacena los elementos.
 
 	public:
 		/**
-		 * @brief Constructor por defecto que inicializa el conjunto con capacidad y tamao cero.
+		 * @brief Constructor por defecto que crea un conjunto vaco sin reservar memoria.
 		 */
 		TSet()
-			: Data(nullptr), Capacity(0), Size(0)
 		{
 		}
 
 		/**
-		 * @brief Destructor que libera la memoria asignada al conjunto.
+		 * @brief Constructor que crea un conjunto vaco que pedir la memoria a InAllocator.
+		 *
+		 * @param InAllocator La poltica de memoria a utilizar.
 		 */
-		~TSet()
+		explicit TSet(const Alloc& InAllocator) : Table(InAllocator)
 		{
-			delete[] Data;  ///< Liberar la memoria del conjunto.
 		}
 
 		/**
@@ -87,15 +84,27 @@ namespace EngineUtilities {
 		 */
 		void Add(const T& Element)
 		{
-			if (Contains(Element))
+			size_t Hash = Table.HashKey(Element);
+			if (Table.FindHashed(Element, Hash) != Table.INDEX_NONE)
 			{
 				return;  ///< No aadir duplicados.
 			}
-			if (Size == Capacity)
+			Table.EmplaceNew(Hash, Element);  ///< Aadir el nuevo elemento.
+		}
+
+		/**
+		 * @brief Aade un nuevo elemento al conjunto movindolo.
+		 *
+		 * @param Element El elemento a mover al conjunto.
+		 */
+		void Add(T&& Element)
+		{
+			size_t Hash = Table.HashKey(Element);
+			if (Table.FindHashed(Element, Hash) != Table.INDEX_NONE)
 			{
-				Resize(Capacity == 0 ? 1 : Capacity * 2);  ///< Redimensionar si es necesario.
+				return;  ///< No aadir duplicados.
 			}
-			Data[Size++] = Element;  ///< Aadir el nuevo elemento y aumentar el tamao.
+			Table.EmplaceNew(Hash, std::move(Element));  ///< Aadir el nuevo elemento.
 		}
 
 		/**
@@ -105,17 +114,11 @@ namespace EngineUtilities {
 		 */
 		void Remove(const T& Element)
 		{
-			for (size_t i = 0; i < Size; ++i)
+			size_t Index = Table.Find(Element);
+			if (Index != Table.INDEX_NONE)
 			{
-				if (Data[i] == Element)
-				{
-					for (size_t j = i; j < Size - 1; ++j)
-					{
-						Data[j] = Data[j + 1];  ///< Desplazar los elementos hacia la izquierda para llenar el hueco.
-					}
-					--Size;  ///< Disminuir el tamao del conjunto.
-					return;
-				}
+				Table.RemoveAt(Index);
+				return;
 			}
 			std::cerr << "Element not found" << std::endl;  ///< Manejar el caso de elemento no encontrado.
 		}
@@ -129,14 +132,129 @@ namespace EngineUtilities {
 		 */
 		bool Contains(const T& Element) const
 		{
-			for (size_t i = 0; i < Size; ++i)
+			return Table.Find(Element) != Table.INDEX_NONE;
+		}
+
+		/**
+		 * @brief Aade al conjunto todos los elementos de otro (unin en el sitio).
+		 *
+		 * Cuenta primero (sin reservar) los elementos de Other que faltan en este conjunto y
+		 * reserva slo para ellos, de modo que una unin con elementos ya presentes reutiliza
+		 * la capacidad existente. Despus inserta en O(1) cada elemento.
+		 *
+		 * @param Other El conjunto cuyos elementos se aaden.
+		 */
+		void Union(const TSet& Other)
+		{
+			if (this == &Other)
+			{
+				return;
+			}
+			size_t Missing = 0;
+			for (size_t i = 0; i < Other.Table.GetCapacity(); ++i)
+			{
+				if (Other.Table.IsValidIndex(i) && !Contains(Other.Table.GetElement(i)))
+				{
+					++Missing;
+				}
+			}
+			if (Missing == 0)
+			{
+				return;
+			}
+			Table.Reserve(Table.Num() + Missing);
+			for (size_t i = 0; i < Other.Table.GetCapacity(); ++i)
+			{
+				if (Other.Table.IsValidIndex(i))
+				{
+					Add(Other.Table.GetElement(i));
+				}
+			}
+		}
+
+		/**
+		 * @brief Conserva slo los elementos que tambin estn en otro conjunto (interseccin en el sitio).
+		 *
+		 * Recorre este conjunto una vez y no reserva memoria.
+		 *
+		 * @param Other El conjunto con el que se intersecta.
+		 */
+		void Intersect(const TSet& Other)
+		{
+			if (this == &Other)
 			{
-				if (Data[i] == Element)
+				return;
+			}
+			Table.RemoveIf([&Other](const T& Element) { return !Other.Contains(Element); });
+		}
+
+		/**
+		 * @brief Elimina los elementos que estn en otro conjunto (diferencia en el sitio).
+		 *
+		 * Recorre el menor de los dos conjuntos y no reserva memoria.
+		 *
+		 * @param Other El conjunto cuyos elementos se eliminan.
+		 */
+		void Difference(const TSet& Other)
+		{
+			if (this == &Other)
+			{
+				Table.Empty();
+				return;
+			}
+			if (Other.Table.Num() < Table.Num())
+			{
+				for (size_t i = 0; i < Other.Table.GetCapacity(); ++i)
+				{
+					if (Other.Table.IsValidIndex(i))
+					{
+						size_t Index = Table.Find(Other.Table.GetElement(i));
+						if (Index != Table.INDEX_NONE)
+						{
+							Table.RemoveAt(Index);
+						}
+					}
+				}
+			}
+			else
+			{
+				Table.RemoveIf([&Other](const T& Element) { return Other.Contains(Element); });
+			}
+		}
+
+		/**
+		 * @brief Llama a una funcin por cada elemento del conjunto (en orden no especificado).
+		 *
+		 * @param Func Functor void(const T&).
+		 */
+		template<typename Fn>
+		void ForEach(Fn&& Func) const
+		{
+			for (size_t i = 0; i < Table.GetCapacity(); ++i)
+			{
+				if (Table.IsValidIndex(i))
 				{
-					return true;  ///< Devolver true si el elemento se encuentra.
+					Func(Table.GetElement(i));
 				}
 			}
-			return false;  ///< Devolver false si el elemento no se encuentra.
+		}
+
+		/**
+		 * @brief Elimina todos los elementos conservando la capacidad.
+		 */
+		void Empty()
+		{
+			Table.Empty();
+		}
+
+		/**
+		 * @brief Reserva espacio para Count elementos sin volver a redimensionar.
+		 *
+		 * @param Count Nmero de elementos esperado.
+		 */
+		void Reserve(size_t Count)
+		{
+			Table.Reserve(Count);
 		}
 
 		/**
@@ -146,17 +264,30 @@ namespace EngineUtilities {
 		 */
 		size_t Num() const
 		{
-			return Size;  ///< Devolver el tamao actual del conjunto.
+			return Table.Num();  ///< Devolver el tamao actual del conjunto.
+		}
+
+		/**
+		 * @brief Devuelve la poltica de memoria del conjunto.
+		 */
+		Alloc& GetAllocator()
+		{
+			return Table.GetAllocator();
+		}
+
+		const Alloc& GetAllocator() const
+		{
+			return Table.GetAllocator();
 		}
 
 		/**
 		 * @brief Devuelve la capacidad actual del conjunto.
 		 *
-		 * @return La capacidad del conjunto.
+		 * @return La capacidad del conjunto (nmero de ranuras de la tabla).
 		 */
 		size_t GetCapacity() const
 		{
-			return Capacity;  ///< Devolver la capacidad actual del conjunto.
+			return Table.GetCapacity();  ///< Devolver la capacidad actual del conjunto.
 		}
 	};
 
@@ -0,0 +1,456 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include "Sort.h"
+#include "TArray.h"
+#include "TPair.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace EngineUtilities {
+	/**
+	 * @brief Orden en el que TSortedMap guarda sus pares.
+	 *
+	 * Sorted los guarda ordenados por clave. Eytzinger los guarda en el orden de recorrido en
+	 * anchura del rbol binario de bsqueda equivalente (la raz primero y los hijos del nodo
+	 * k, contando desde 1, en 2k y 2k + 1): los primeros niveles comparten lneas de cach y
+	 * la direccin de los niveles siguientes se conoce a tiempo para precargarla, as que en
+	 * tablas que no caben en cach la bsqueda espera mucho menos a memoria. A cambio, el
+	 * recorrido con begin()/end() deja de seguir el orden de clave y cada modificacin
+	 * reordena todo el array.
+	 */
+	enum class ESortedMapLayout
+	{
+		Sorted,
+		Eytzinger
+	};
+
+	/**
+	 * @brief Mapa ordenado sobre un array contiguo de TPair<K, V>.
+	 *
+	 * Pensado para tablas que se construyen una vez y se consultan mucho: la bsqueda es
+	 * O(log n) sin ramas y sin la memoria extra de una tabla hash. Add y Remove desplazan o
+	 * reordenan los elementos y cuestan O(n); para cargar muchos pares de golpe conviene
+	 * BuildFrom.
+	 *
+	 * Las claves se comparan slo con operator<, el mismo orden que usa TPair para su clave.
+	 * Con Layout Eytzinger K y V deben poder construirse por defecto.
+	 *
+	 * @tparam K Tipo de la clave.
+	 * @tparam V Tipo del valor.
+	 * @tparam Layout Orden de almacenamiento (ver ESortedMapLayout).
+	 * @tparam Alloc Poltica de asignacin de memoria.
+	 */
+	template<typename K, typename V, ESortedMapLayout Layout = ESortedMapLayout::Sorted, typename Alloc = FHeapAllocator>
+	class TSortedMap
+	{
+	public:
+		using PairType = TPair<K, V>;
+
+		TSortedMap()
+		{
+		}
+
+		/**
+		 * @brief Constructor con una instancia concreta del asignador.
+		 */
+		explicit TSortedMap(const Alloc& InAllocator) : Pairs(InAllocator)
+		{
+		}
+
+		/**
+		 * @brief Sustituye el contenido del mapa por los pares de InPairs en O(n log n).
+		 *
+		 * Ordena con Sort un array de posiciones por (clave, posicin en InPairs) y recorre cada
+		 * grupo de claves iguales quedndose con su ltimo par, de modo que, como con Add
+		 * repetido, gana el ltimo valor de cada clave.
+		 *
+		 * @param InPairs Pares en cualquier orden. Queda vaco.
+		 */
+		void BuildFrom(TArray<PairType, Alloc>&& InPairs)
+		{
+			TArray<PairType, Alloc> Source(std::move(InPairs));
+			const size_t Count = Source.Num();
+
+			TArray<size_t, Alloc> Order(Source.GetAllocator());
+			Order.Reserve(Count);
+			for (size_t i = 0; i < Count; ++i)
+			{
+				Order.Add(i);
+			}
+			Sort(Order, [&Source](size_t A, size_t B)
+			{
+				if (Source[A].Key < Source[B].Key)
+				{
+					return true;
+				}
+				return !(Source[B].Key < Source[A].Key) && A < B;
+			});
+
+			TArray<PairType, Alloc> Unique(Source.GetAllocator());
+			Unique.Reserve(Count);
+			for (size_t i = 0; i < Count; ++i)
+			{
+				if (i + 1 == Count || Source[Order[i]].Key < Source[Order[i + 1]].Key)
+				{
+					Unique.Add(std::move(Source[Order[i]]));
+				}
+			}
+			Pairs = std::move(Unique);
+			if constexpr (Layout == ESortedMapLayout::Eytzinger)
+			{
+				SortedToEytzinger();
+			}
+		}
+
+		/**
+		 * @brief Aade un par o actualiza el valor si la clave ya existe. O(n) si la clave es nueva.
+		 */
+		void Add(const K& Key, const V& Value)
+		{
+			V* Existing = Find(Key);
+			if (Existing != nullptr)
+			{
+				*Existing = Value;  ///< Actualizar el valor si la clave ya existe.
+				return;
+			}
+			if constexpr (Layout == ESortedMapLayout::Eytzinger)
+			{
+				EytzingerToSorted();
+			}
+			size_t Index = SortedLowerBound(Key);
+			Pairs.Emplace(Key, Value);
+			// Llevar el par nuevo desde el final hasta su posicin.
+			for (size_t i = Pairs.Num() - 1; i > Index; --i)
+			{
+				std::swap(Pairs[i], Pairs[i - 1]);
+			}
+			if constexpr (Layout == ESortedMapLayout::Eytzinger)
+			{
+				SortedToEytzinger();
+			}
+		}
+
+		/**
+		 * @brief Elimina el par con la clave dada. O(n).
+		 */
+		void Remove(const K& Key)
+		{
+			if (!Contains(Key))
+			{
+				std::cerr << "Key not found" << std::endl;  ///< Manejar el caso de clave no encontrada.
+				return;
+			}
+			if constexpr (Layout == ESortedMapLayout::Eytzinger)
+			{
+				EytzingerToSorted();
+			}
+			Pairs.RemoveAt(SortedLowerBound(Key));
+			if constexpr (Layout == ESortedMapLayout::Eytzinger)
+			{
+				SortedToEytzinger();
+			}
+		}
+
+		/**
+		 * @brief Posicin en el almacenamiento del primer par cuya clave no es menor que Key.
+		 *
+		 * Con Layout Sorted los pares siguientes en orden de clave estn justo a continuacin.
+		 *
+		 * @return Una posicin en [0, Num()); Num() si todas las claves son menores.
+		 */
+		size_t LowerBound(const K& Key) const
+		{
+			if constexpr (Layout == ESortedMapLayout::Eytzinger)
+			{
+				return EytzingerLowerBound(Key);
+			}
+			else
+			{
+				return SortedLowerBound(Key);
+			}
+		}
+
+		/**
+		 * @brief Posicin en el almacenamiento del par con la clave dada, o INDEX_NONE.
+		 */
+		size_t FindIndex(const K& Key) const
+		{
+			size_t Index = LowerBound(Key);
+			return Index < Pairs.Num() && !(Key < Pairs[Index].Key) ? Index : INDEX_NONE;
+		}
+
+		V* Find(const K& Key)
+		{
+			size_t Index = FindIndex(Key);
+			return Index != INDEX_NONE ? &Pairs[Index].Value : nullptr;
+		}
+
+		const V* Find(const K& Key) const
+		{
+			size_t Index = FindIndex(Key);
+			return Index != INDEX_NONE ? &Pairs[Index].Value : nullptr;
+		}
+
+		bool Contains(const K& Key) const
+		{
+			return FindIndex(Key) != INDEX_NONE;
+		}
+
+		V& operator[](const K& Key)
+		{
+			V* Value = Find(Key);
+			if (Value == nullptr)
+			{
+				std::cerr << "Key not found" << std::endl;  ///< Manejar el caso de clave no encontrada.
+				exit(1);  ///< Salir del programa en caso de error.
+			}
+			return *Value;
+		}
+
+		const V& operator[](const K& Key) const
+		{
+			const V* Value = Find(Key);
+			if (Value == nullptr)
+			{
+				std::cerr << "Key not found" << std::endl;  ///< Manejar el caso de clave no encontrada.
+				exit(1);  ///< Salir del programa en caso de error.
+			}
+			return *Value;
+		}
+
+		/**
+		 * @brief Par en la posicin Index del almacenamiento (el orden de clave con Layout Sorted).
+		 */
+		const PairType& GetPair(size_t Index) const
+		{
+			return Pairs.At(Index);
+		}
+
+		/**
+		 * @brief Recorrido de los pares en el orden de almacenamiento. Slo lectura: cambiar una clave rompera la bsqueda.
+		 */
+		const PairType* begin() const
+		{
+			return Pairs.begin();
+		}
+
+		const PairType* end() const
+		{
+			return Pairs.end();
+		}
+
+		void Reserve(size_t Count)
+		{
+			Pairs.Reserve(Count);
+		}
+
+		void Empty()
+		{
+			Pairs.Empty();
+		}
+
+		size_t Num() const
+		{
+			return Pairs.Num();
+		}
+
+		Alloc& GetAllocator()
+		{
+			return Pairs.GetAllocator();
+		}
+
+		const Alloc& GetAllocator() const
+		{
+			return Pairs.GetAllocator();
+		}
+
+		static constexpr size_t INDEX_NONE = static_cast<size_t>(-1); ///< Resultado de FindIndex sin coincidencia.
+
+	private:
+		/**
+		 * @brief lower_bound sin ramas sobre Pairs ordenado.
+		 *
+		 * El rango candidato se parte siempre por la mitad y slo cambia su base, con una
+		 * seleccin que el compilador traduce a un movimiento condicional; el nmero de
+		 * iteraciones depende slo de Num(), as que no hay saltos que predecir.
+		 */
+		size_t SortedLowerBound(const K& Key) const
+		{
+			size_t Count = Pairs.Num();
+			if (Count == 0)
+			{
+				return 0;
+			}
+			const PairType* Base = Pairs.GetData();
+			while (Count > 1)
+			{
+				size_t Half = Count / 2;
+				Base = Base[Half].Key < Key ? Base + Half : Base;
+				Count -= Half;
+			}
+			return static_cast<size_t>(Base - Pairs.GetData()) + (Base->Key < Key ? 1 : 0);
+		}
+
+		/**
+		 * @brief lower_bound sobre Pairs en orden de Eytzinger.
+		 *
+		 * Se baja por el rbol sin ramas hasta salir de l, precargando los descendientes
+		 * de cuatro niveles ms abajo: son 16 pares consecutivos, as que se piden todas las
+		 * lneas de cach que ocupan (recortadas al final del array; en los ltimos niveles
+		 * no hay nada que precargar). El ltimo giro a la izquierda es el resultado y se
+		 * recupera quitando de Node los giros a la derecha finales (sus unos bajos) y uno ms.
+		 */
+		size_t EytzingerLowerBound(const K& Key) const
+		{
+			const size_t Count = Pairs.Num();
+			const PairType* Data = Pairs.GetData();
+			size_t Node = 1;
+			while (Node <= Count)
+			{
+				const size_t Descendant = 16 * Node - 1;
+				if (Descendant < Count)
+				{
+					const size_t Group = Count - Descendant < 16 ? Count - Descendant : 16;
+					PrefetchRange(Data + Descendant, Group * sizeof(PairType));
+				}
+				Node = 2 * Node + (Data[Node - 1].Key < Key ? 1 : 0);
+			}
+			Node >>= CountTrailingOnes(Node) + 1;
+			return Node == 0 ? Count : Node - 1;
+		}
+
+		/**
+		 * @brief Pide a la cach la lnea de Address sin esperarla.
+		 */
+		static void Prefetch(const void* Address)
+		{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			_mm_prefetch(static_cast<const char*>(Address), _MM_HINT_T0);
+#elif defined(__GNUC__)
+			__builtin_prefetch(Address);
+#else
+			(void)Address;
+#endif
+		}
+
+		/**
+		 * @brief Precarga todas las lneas de cach de [Address, Address + Bytes). Bytes debe ser mayor que 0.
+		 */
+		static void PrefetchRange(const void* Address, size_t Bytes)
+		{
+			const char* Begin = static_cast<const char*>(Address);
+			for (size_t Offset = 0; Offset < Bytes; Offset += 64)
+			{
+				Prefetch(Begin + Offset);
+			}
+			Prefetch(Begin + Bytes - 1);
+		}
+
+		/**
+		 * @brief Nmero de unos consecutivos en los bits bajos de Value.
+		 */
+		static size_t CountTrailingOnes(size_t Value)
+		{
+#if defined(_MSC_VER)
+			unsigned long Index;
+#if defined(_WIN64)
+			_BitScanForward64(&Index, ~static_cast<unsigned __int64>(Value));
+#else
+			_BitScanForward(&Index, ~static_cast<unsigned long>(Value));
+#endif
+			return static_cast<size_t>(Index);
+#else
+			return static_cast<size_t>(__builtin_ctzll(~static_cast<unsigned long long>(Value)));
+#endif
+		}
+
+		/**
+		 * @brief Recorre en orden el subrbol Node de Eytzinger, que vive en Pairs, llevando cada par a Sorted.
+		 */
+		void GatherInOrder(size_t Node, TArray<PairType, Alloc>& Sorted)
+		{
+			if (Node > Pairs.Num())
+			{
+				return;
+			}
+			GatherInOrder(2 * Node, Sorted);
+			Sorted.Add(std::move(Pairs[Node - 1]));
+			GatherInOrder(2 * Node + 1, Sorted);
+		}
+
+		/**
+		 * @brief Recorre en orden el subrbol Node de Eytzinger, asignndole los pares de Sorted.
+		 */
+		void ScatterInOrder(size_t Node, TArray<PairType, Alloc>& Sorted, size_t& Next)
+		{
+			if (Node > Pairs.Num())
+			{
+				return;
+			}
+			ScatterInOrder(2 * Node, Sorted, Next);
+			Pairs[Node - 1] = std::move(Sorted[Next++]);
+			ScatterInOrder(2 * Node + 1, Sorted, Next);
+		}
+
+		/**
+		 * @brief Pasa Pairs de orden de Eytzinger a orden de clave.
+		 */
+		void EytzingerToSorted()
+		{
+			TArray<PairType, Alloc> Sorted(Pairs.GetAllocator());
+			Sorted.Reserve(Pairs.Num() + 1);
+			GatherInOrder(1, Sorted);
+			Pairs = std::move(Sorted);
+		}
+
+		/**
+		 * @brief Pasa Pairs de orden de clave a orden de Eytzinger.
+		 */
+		void SortedToEytzinger()
+		{
+			TArray<PairType, Alloc> Sorted(std::move(Pairs));
+			Pairs = TArray<PairType, Alloc>(Sorted.GetAllocator());
+			Pairs.Reserve(Sorted.Num());
+			for (size_t i = 0; i < Sorted.Num(); ++i)
+			{
+				Pairs.Emplace();
+			}
+			size_t Next = 0;
+			ScatterInOrder(1, Sorted, Next);
+		}
+
+		TArray<PairType, Alloc> Pairs;  ///< Pares sin claves repetidas, en el orden de Layout.
+	};
+}
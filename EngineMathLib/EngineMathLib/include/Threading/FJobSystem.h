@@ -0,0 +1,318 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "Threading/TWorkStealingDeque.h"
+
+namespace EngineUtilities {
+	/**
+	 * @brief Unidad de trabajo que ejecuta el sistema de trabajos.
+	 *
+	 * No es propiedad del sistema: quien la enva la mantiene viva hasta que se ejecuta.
+	 */
+	struct FJob
+	{
+		void (*Execute)(FJob& Job);  ///< Funcin que ejecuta el trabajo.
+		void* Context;               ///< Datos propios de quien enva el trabajo.
+		size_t Begin;                ///< Inicio del rango que procesa el trabajo.
+		size_t End;                  ///< Fin (exclusivo) del rango que procesa el trabajo.
+	};
+
+	/**
+	 * @brief Pool de hilos con robo de trabajo.
+	 *
+	 * Cada hilo trabajador tiene su propia TWorkStealingDeque: los trabajos que enva un
+	 * trabajador van a su cola (LIFO, buena localidad de cach) y los trabajadores ociosos
+	 * roban de las colas de los dems. Los hilos externos envan a una cola de inyeccin
+	 * compartida. Quien espera con WaitFor ejecuta trabajos mientras tanto, de modo que un
+	 * sistema sin trabajadores sigue funcionando (en serie) y los bucles paralelos anidados
+	 * no bloquean el pool.
+	 */
+	class FJobSystem
+	{
+	public:
+		/**
+		 * @brief Crea el sistema con NumWorkers hilos trabajadores.
+		 *
+		 * @param NumWorkers Nmero de hilos que se crean. El hilo que espera tambin ejecuta
+		 *                   trabajos, as que suele usarse el nmero de ncleos menos uno.
+		 */
+		explicit FJobSystem(size_t NumWorkers)
+			: Workers(NumWorkers > 0 ? new FWorker[NumWorkers] : nullptr), WorkerCount(NumWorkers),
+			  WorkEpoch(0), NumSleeping(0), bStopping(false)
+		{
+			for (size_t i = 0; i < WorkerCount; ++i)
+			{
+				Workers[i].Thread = std::thread([this, i]() { WorkerMain(i); });
+			}
+		}
+
+		FJobSystem(const FJobSystem&) = delete;
+		FJobSystem& operator=(const FJobSystem&) = delete;
+
+		/**
+		 * @brief Detiene y une todos los hilos trabajadores.
+		 */
+		~FJobSystem()
+		{
+			{
+				std::lock_guard<std::mutex> Lock(SleepMutex);
+				bStopping.store(true);
+			}
+			WakeCondition.notify_all();
+			for (size_t i = 0; i < WorkerCount; ++i)
+			{
+				Workers[i].Thread.join();
+			}
+			delete[] Workers;
+		}
+
+		/**
+		 * @brief Sistema global con un trabajador por ncleo, sin contar el del hilo que espera.
+		 */
+		static FJobSystem& Get()
+		{
+			static FJobSystem Instance(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+			return Instance;
+		}
+
+		/**
+		 * @brief Devuelve el nmero de hilos trabajadores.
+		 */
+		size_t GetNumWorkers() const
+		{
+			return WorkerCount;
+		}
+
+		/**
+		 * @brief Devuelve el nmero de hilos que ejecutan trabajos durante una espera (trabajadores ms el que espera).
+		 */
+		size_t GetNumThreads() const
+		{
+			return WorkerCount + 1;
+		}
+
+		/**
+		 * @brief Enva un trabajo para que lo ejecute cualquier hilo del sistema.
+		 *
+		 * @param Job El trabajo. Debe seguir vivo hasta que termine de ejecutarse.
+		 */
+		void Submit(FJob* Job)
+		{
+			FThreadState& State = CurrentThread();
+			if (State.System == this)
+			{
+				Workers[State.WorkerIndex].Queue.Push(Job);
+			}
+			else
+			{
+				std::lock_guard<std::mutex> Lock(InjectMutex);
+				InjectQueue.Push(Job);
+			}
+			WakeWorker();
+		}
+
+		/**
+		 * @brief Ejecuta trabajos pendientes hasta que Pending llega a cero.
+		 *
+		 * @param Pending Contador de trabajos sin terminar que decrementan los propios trabajos.
+		 */
+		void WaitFor(const std::atomic<size_t>& Pending)
+		{
+			FThreadState& State = CurrentThread();
+			size_t Self = State.System == this ? State.WorkerIndex : NoWorker;
+			while (Pending.load(std::memory_order_acquire) != 0)
+			{
+				FJob* Job = nullptr;
+				if (FindJob(Self, Job))
+				{
+					Job->Execute(*Job);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+	private:
+		static constexpr size_t NoWorker = ~static_cast<size_t>(0);  ///< ndice de un hilo que no es trabajador.
+		static constexpr int SpinRounds = 64;                        ///< Intentos fallidos antes de dormir.
+
+		using ESteal = TWorkStealingDeque<FJob*>::ESteal;
+
+		/**
+		 * @brief Estado de un hilo trabajador, en su propia lnea de cach.
+		 */
+		struct alignas(64) FWorker
+		{
+			TWorkStealingDeque<FJob*> Queue;
+			std::thread Thread;
+		};
+
+		/**
+		 * @brief Estado por hilo: a qu sistema pertenece y generador para elegir vctimas.
+		 */
+		struct FThreadState
+		{
+			FJobSystem* System = nullptr;
+			size_t WorkerIndex = NoWorker;
+			uint32_t RandomState = 0x9E3779B9u;
+		};
+
+		static FThreadState& CurrentThread()
+		{
+			static thread_local FThreadState State;
+			return State;
+		}
+
+		/**
+		 * @brief Nmero pseudoaleatorio (xorshift32) para repartir los robos entre vctimas.
+		 */
+		static uint32_t NextRandom(FThreadState& State)
+		{
+			uint32_t Value = State.RandomState;
+			Value ^= Value << 13;
+			Value ^= Value >> 17;
+			Value ^= Value << 5;
+			State.RandomState = Value;
+			return Value;
+		}
+
+		/**
+		 * @brief Busca un trabajo: primero en la cola propia, luego en la de inyeccin y por ltimo robando.
+		 *
+		 * @param Self ndice del trabajador que busca, o NoWorker.
+		 * @param OutJob Recibe el trabajo encontrado.
+		 * @return true si se encontr un trabajo.
+		 */
+		bool FindJob(size_t Self, FJob*& OutJob)
+		{
+			if (Self != NoWorker && Workers[Self].Queue.Pop(OutJob))
+			{
+				return true;
+			}
+
+			bool bRetry = true;
+			while (bRetry)
+			{
+				bRetry = false;
+				ESteal Result = InjectQueue.Steal(OutJob);
+				if (Result == ESteal::Success)
+				{
+					return true;
+				}
+				bRetry = Result == ESteal::Abort;
+
+				size_t Start = WorkerCount > 0 ? NextRandom(CurrentThread()) % WorkerCount : 0;
+				for (size_t i = 0; i < WorkerCount; ++i)
+				{
+					size_t Victim = (Start + i) % WorkerCount;
+					if (Victim == Self)
+					{
+						continue;
+					}
+					Result = Workers[Victim].Queue.Steal(OutJob);
+					if (Result == ESteal::Success)
+					{
+						return true;
+					}
+					bRetry = bRetry || Result == ESteal::Abort;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * @brief Despierta a un trabajador dormido, si lo hay, tras publicar un trabajo.
+		 *
+		 * WorkEpoch y NumSleeping usan orden secuencial: o quien enva ve al trabajador dormido,
+		 * o el trabajador ve el nuevo epoch antes de dormirse.
+		 */
+		void WakeWorker()
+		{
+			WorkEpoch.fetch_add(1);
+			if (NumSleeping.load() > 0)
+			{
+				std::lock_guard<std::mutex> Lock(SleepMutex);
+				WakeCondition.notify_one();
+			}
+		}
+
+		/**
+		 * @brief Bucle de cada hilo trabajador.
+		 */
+		void WorkerMain(size_t Index)
+		{
+			FThreadState& State = CurrentThread();
+			State.System = this;
+			State.WorkerIndex = Index;
+			State.RandomState = static_cast<uint32_t>(Index + 1) * 0x9E3779B9u;
+
+			int IdleRounds = 0;
+			while (!bStopping.load(std::memory_order_relaxed))
+			{
+				uint64_t Epoch = WorkEpoch.load();
+				FJob* Job = nullptr;
+				if (FindJob(Index, Job))
+				{
+					Job->Execute(*Job);
+					IdleRounds = 0;
+					continue;
+				}
+				if (++IdleRounds < SpinRounds)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				std::unique_lock<std::mutex> Lock(SleepMutex);
+				NumSleeping.fetch_add(1);
+				WakeCondition.wait(Lock, [&]() { return WorkEpoch.load() != Epoch || bStopping.load(); });
+				NumSleeping.fetch_sub(1);
+				IdleRounds = 0;
+			}
+		}
+
+		FWorker* Workers;                        ///< Trabajadores con sus colas.
+		size_t WorkerCount;                      ///< Nmero de trabajadores.
+		TWorkStealingDeque<FJob*> InjectQueue;   ///< Trabajos enviados desde hilos externos.
+		std::mutex InjectMutex;                  ///< Serializa los Push en la cola de inyeccin.
+		std::atomic<uint64_t> WorkEpoch;         ///< Se incrementa con cada trabajo enviado.
+		std::atomic<size_t> NumSleeping;         ///< Trabajadores esperando en WakeCondition.
+		std::mutex SleepMutex;                   ///< Protege la espera de los trabajadores.
+		std::condition_variable WakeCondition;   ///< Despierta a los trabajadores dormidos.
+		std::atomic<bool> bStopping;             ///< Indica a los trabajadores que deben terminar.
+	};
+}
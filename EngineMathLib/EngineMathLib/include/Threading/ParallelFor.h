@@ -0,0 +1,254 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include "Structures/TArray.h"
+#include "Threading/FJobSystem.h"
+
+namespace EngineUtilities {
+	/**
+	 * @brief Calcula el tamao de bloque de un bucle paralelo.
+	 *
+	 * Reparte Count elementos en unos ocho bloques por hilo: suficientes para que el robo de
+	 * trabajo compense bloques desiguales y pocos para que el coste de cada trabajo sea
+	 * despreciable. MinGrain permite subir el mnimo cuando el cuerpo del bucle es muy barato.
+	 *
+	 * @param Count Nmero de elementos.
+	 * @param NumThreads Nmero de hilos que participan.
+	 * @param MinGrain Tamao mnimo de bloque (al menos 1).
+	 * @return El tamao de bloque.
+	 */
+	inline size_t ComputeParallelGrain(size_t Count, size_t NumThreads, size_t MinGrain)
+	{
+		size_t Chunks = NumThreads * 8;
+		size_t Grain = (Count + Chunks - 1) / Chunks;
+		if (MinGrain < 1)
+		{
+			MinGrain = 1;
+		}
+		return Grain < MinGrain ? MinGrain : Grain;
+	}
+
+	/**
+	 * @brief Estado compartido de un bucle paralelo sobre [0, Count).
+	 *
+	 * El rango se divide de forma perezosa: quien ejecuta un trabajo mayor que Grain enva la
+	 * mitad derecha como trabajo nuevo y sigue con la izquierda, as que los ladrones se llevan
+	 * siempre los trozos ms grandes. Los cortes caen en mltiplos de Grain, por lo que cada
+	 * bloque final es [k * Grain, min((k + 1) * Grain, Count)). Como cada corte crea exactamente
+	 * un bloque ms, todos los trabajos caben en un nico array reservado de antemano.
+	 *
+	 * @tparam RangeFn Funcin con la firma void(size_t Begin, size_t End).
+	 */
+	template<typename RangeFn>
+	class TParallelRange
+	{
+	public:
+		TParallelRange(size_t InCount, size_t InGrain, RangeFn& InFunc, FJobSystem& InSystem)
+			: Func(InFunc), System(InSystem), Count(InCount), Grain(InGrain),
+			  Jobs(new FJob[(InCount + InGrain - 1) / InGrain]), NextJob(0), Pending(0)
+		{
+		}
+
+		TParallelRange(const TParallelRange&) = delete;
+		TParallelRange& operator=(const TParallelRange&) = delete;
+
+		~TParallelRange()
+		{
+			delete[] Jobs;
+		}
+
+		/**
+		 * @brief Ejecuta el bucle completo y vuelve cuando han terminado todos los bloques.
+		 */
+		void Run()
+		{
+			Pending.store(1, std::memory_order_relaxed);
+			Execute(*NewJob(0, Count));
+			System.WaitFor(Pending);
+		}
+
+	private:
+		FJob* NewJob(size_t Begin, size_t End)
+		{
+			FJob* Job = &Jobs[NextJob.fetch_add(1, std::memory_order_relaxed)];
+			Job->Execute = &TParallelRange::Execute;
+			Job->Context = this;
+			Job->Begin = Begin;
+			Job->End = End;
+			return Job;
+		}
+
+		static void Execute(FJob& Job)
+		{
+			TParallelRange* Range = static_cast<TParallelRange*>(Job.Context);
+			size_t Begin = Job.Begin;
+			size_t End = Job.End;
+			while (End - Begin > Range->Grain)
+			{
+				size_t Blocks = (End - Begin + Range->Grain - 1) / Range->Grain;
+				size_t Middle = Begin + (Blocks / 2) * Range->Grain;
+				Range->Pending.fetch_add(1, std::memory_order_relaxed);
+				Range->System.Submit(Range->NewJob(Middle, End));
+				End = Middle;
+			}
+			Range->Func(Begin, End);
+			// ltimo acceso a Range: en cuanto Pending llega a cero, Run puede volver y destruirlo.
+			Range->Pending.fetch_sub(1, std::memory_order_acq_rel);
+		}
+
+		RangeFn& Func;                   ///< Cuerpo del bucle.
+		FJobSystem& System;              ///< Sistema que ejecuta los trabajos.
+		size_t Count;                    ///< Nmero total de elementos.
+		size_t Grain;                    ///< Tamao de bloque.
+		FJob* Jobs;                      ///< Un trabajo por bloque.
+		std::atomic<size_t> NextJob;     ///< Siguiente trabajo libre de Jobs.
+		std::atomic<size_t> Pending;     ///< Trabajos enviados y an sin terminar.
+	};
+
+	/**
+	 * @brief Ejecuta Func sobre [0, Count) en bloques de Grain elementos repartidos entre los hilos de System.
+	 *
+	 * @param Count Nmero de elementos.
+	 * @param Grain Tamao exacto de bloque (al menos 1).
+	 * @param Func Funcin con la firma void(size_t Begin, size_t End).
+	 * @param System Sistema de trabajos.
+	 */
+	template<typename RangeFn>
+	void ParallelForGrain(size_t Count, size_t Grain, RangeFn& Func, FJobSystem& System)
+	{
+		if (Count == 0)
+		{
+			return;
+		}
+		if (Count <= Grain || System.GetNumWorkers() == 0)
+		{
+			// Un solo bloque o ningn trabajador: en serie y sin coste de planificacin.
+			for (size_t Begin = 0; Begin < Count; Begin += Grain)
+			{
+				Func(Begin, Begin + Grain < Count ? Begin + Grain : Count);
+			}
+			return;
+		}
+		TParallelRange<RangeFn> Range(Count, Grain, Func, System);
+		Range.Run();
+	}
+
+	/**
+	 * @brief Ejecuta Func sobre los rangos de [0, Count) en paralelo, con tamao de bloque automtico.
+	 *
+	 * @param Count Nmero de elementos.
+	 * @param Func Funcin con la firma void(size_t Begin, size_t End).
+	 * @param MinGrain Tamao mnimo de bloque.
+	 * @param System Sistema de trabajos (por defecto el global).
+	 */
+	template<typename RangeFn>
+	void ParallelForRange(size_t Count, RangeFn&& Func, size_t MinGrain = 1, FJobSystem& System = FJobSystem::Get())
+	{
+		ParallelForGrain(Count, ComputeParallelGrain(Count, System.GetNumThreads(), MinGrain), Func, System);
+	}
+
+	/**
+	 * @brief Ejecuta Func(Element) sobre cada elemento de un TArray en paralelo.
+	 *
+	 * @param Array El array a recorrer. No debe cambiar de tamao durante el bucle.
+	 * @param Func Funcin con la firma void(T& Element).
+	 * @param MinGrain Tamao mnimo de bloque.
+	 * @param System Sistema de trabajos (por defecto el global).
+	 */
+	template<typename T, typename Alloc, typename Fn>
+	void ParallelFor(TArray<T, Alloc>& Array, Fn&& Func, size_t MinGrain = 1, FJobSystem& System = FJobSystem::Get())
+	{
+		if (Array.Num() == 0)
+		{
+			return;
+		}
+		T* Data = &Array[0];
+		auto Body = [Data, &Func](size_t Begin, size_t End) {
+			for (size_t i = Begin; i < End; ++i)
+			{
+				Func(Data[i]);
+			}
+		};
+		ParallelForRange(Array.Num(), Body, MinGrain, System);
+	}
+
+	/**
+	 * @brief Reduce un TArray en paralelo.
+	 *
+	 * Cada bloque acumula sus elementos partiendo de Identity y los resultados parciales se
+	 * combinan en el orden de los bloques, as que Combine slo necesita ser asociativa.
+	 *
+	 * @param Array El array a reducir.
+	 * @param Identity Valor neutro de Combine.
+	 * @param Accumulate Funcin con la firma R(const R& Partial, const T& Element).
+	 * @param Combine Funcin con la firma R(const R& Left, const R& Right).
+	 * @param MinGrain Tamao mnimo de bloque.
+	 * @param System Sistema de trabajos (por defecto el global).
+	 * @return El resultado de la reduccin, o Identity si el array est vaco.
+	 */
+	template<typename T, typename Alloc, typename R, typename AccumulateFn, typename CombineFn>
+	R ParallelReduce(const TArray<T, Alloc>& Array, const R& Identity, AccumulateFn&& Accumulate, CombineFn&& Combine,
+		size_t MinGrain = 1, FJobSystem& System = FJobSystem::Get())
+	{
+		size_t Count = Array.Num();
+		if (Count == 0)
+		{
+			return Identity;
+		}
+		size_t Grain = ComputeParallelGrain(Count, System.GetNumThreads(), MinGrain);
+		size_t Blocks = (Count + Grain - 1) / Grain;
+
+		TArray<R> Partials;
+		for (size_t i = 0; i < Blocks; ++i)
+		{
+			Partials.Add(Identity);
+		}
+		const T* Data = &Array[0];
+		R* PartialData = &Partials[0];
+		auto Body = [Data, PartialData, Grain, &Accumulate](size_t Begin, size_t End) {
+			R Partial = PartialData[Begin / Grain];
+			for (size_t i = Begin; i < End; ++i)
+			{
+				Partial = Accumulate(Partial, Data[i]);
+			}
+			PartialData[Begin / Grain] = std::move(Partial);
+		};
+		ParallelForGrain(Count, Grain, Body, System);
+
+		R Result = std::move(PartialData[0]);
+		for (size_t i = 1; i < Blocks; ++i)
+		{
+			Result = Combine(Result, PartialData[i]);
+		}
+		return Result;
+	}
+}
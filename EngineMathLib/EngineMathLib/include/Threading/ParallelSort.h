@@ -0,0 +1,308 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Structures/Sort.h"
+#include "Structures/TArray.h"
+#include "Threading/FJobSystem.h"
+#include "Threading/ParallelFor.h"
+
+namespace EngineUtilities {
+	/**
+	 * @brief Nmero de elementos de A que aportan los Diagonal primeros elementos de la mezcla estable de A y B.
+	 *
+	 * Bsqueda binaria sobre la diagonal del camino de mezcla: permite cortar una mezcla en
+	 * trozos independientes sin recorrerla. En caso de empate los elementos de A van primero.
+	 */
+	template<typename T, typename LessFn>
+	size_t MergePathSplit(const T* A, size_t CountA, const T* B, size_t CountB, size_t Diagonal, LessFn& Less)
+	{
+		size_t Low = Diagonal > CountB ? Diagonal - CountB : 0;
+		size_t High = Diagonal < CountA ? Diagonal : CountA;
+		while (Low < High)
+		{
+			size_t i = Low + (High - Low) / 2;
+			size_t j = Diagonal - i;
+			if (!Less(B[j - 1], A[i]))
+			{
+				Low = i + 1;
+			}
+			else
+			{
+				High = i;
+			}
+		}
+		return Low;
+	}
+
+	/**
+	 * @brief Mezcla de forma estable A y B en la memoria sin construir de Destination.
+	 *
+	 * Los elementos se reubican: se construyen por movimiento en Destination y se destruyen en
+	 * el origen, de modo que tras cada nivel slo uno de los dos bferes tiene objetos vivos.
+	 */
+	template<typename T, typename LessFn>
+	void RelocateMerge(T* A, T* EndA, T* B, T* EndB, T* Destination, LessFn& Less)
+	{
+		while (A < EndA && B < EndB)
+		{
+			T* Next = Less(*B, *A) ? B++ : A++;
+			new (Destination++) T(std::move(*Next));
+			Next->~T();
+		}
+		for (; A < EndA; ++A)
+		{
+			new (Destination++) T(std::move(*A));
+			A->~T();
+		}
+		for (; B < EndB; ++B)
+		{
+			new (Destination++) T(std::move(*B));
+			B->~T();
+		}
+	}
+
+	/**
+	 * @brief Ordena un TArray con una ordenacin por mezcla paralela.
+	 *
+	 * El array se corta en unas dos secuencias por hilo que se ordenan en paralelo con
+	 * introsort; despus se mezclan por parejas, nivel a nivel, entre el array y un bfer
+	 * auxiliar. Cada mezcla se trocea con MergePathSplit en bloques de tamao fijo, as que
+	 * todos los hilos trabajan tambin en los ltimos niveles, cuando quedan pocas parejas.
+	 * La ordenacin por trozos no es estable. Sin trabajadores, o con menos de MinParallelCount
+	 * elementos, equivale a Sort.
+	 *
+	 * Less no debe lanzar excepciones.
+	 *
+	 * @param Array El array a ordenar.
+	 * @param Less Comparador con la firma bool(const T&, const T&); por defecto operator<.
+	 * @param System Sistema de trabajos (por defecto el global).
+	 */
+	template<typename T, typename Alloc, typename LessFn = TLess<T>>
+	void ParallelSort(TArray<T, Alloc>& Array, LessFn Less = LessFn(), FJobSystem& System = FJobSystem::Get())
+	{
+		const size_t MinParallelCount = 16384;
+		const size_t MergeBlock = 8192;
+		const size_t Count = Array.Num();
+		const size_t NumThreads = System.GetNumThreads();
+		if (Count < MinParallelCount || System.GetNumWorkers() == 0)
+		{
+			Sort(Array, Less);
+			return;
+		}
+
+		size_t NumRuns = 1;
+		while (NumRuns < NumThreads * 2 && Count / (NumRuns * 2) >= MergeBlock)
+		{
+			NumRuns *= 2;
+		}
+		const size_t RunSize = (Count + NumRuns - 1) / NumRuns;
+		T* Data = Array.GetData();
+
+		auto SortRuns = [Data, Count, RunSize, &Less](size_t Begin, size_t End) {
+			for (size_t Run = Begin; Run < End; ++Run)
+			{
+				size_t First = Run * RunSize;
+				size_t Last = First + RunSize < Count ? First + RunSize : Count;
+				SortRange(Data + First, Data + Last, Less);
+			}
+		};
+		ParallelForGrain(NumRuns, 1, SortRuns, System);
+
+		Alloc Allocator(Array.GetAllocator());
+		T* Scratch = static_cast<T*>(Allocator.Allocate(Count * sizeof(T), alignof(T)));
+		T* Source = Data;
+		T* Destination = Scratch;
+		TArray<size_t> Splits;
+		for (size_t Width = RunSize; Width < Count; Width *= 2)
+		{
+			const size_t PairSize = 2 * Width;
+			const size_t BlocksPerPair = (PairSize + MergeBlock - 1) / MergeBlock;
+			const size_t NumBlocks = ((Count + PairSize - 1) / PairSize) * BlocksPerPair;
+			Splits.Empty(true);
+			for (size_t Block = 0; Block < NumBlocks; ++Block)
+			{
+				Splits.Add(0);
+			}
+			size_t* SplitData = Splits.GetData();
+
+			// Los cortes se calculan antes de mover nada: la bsqueda de un bloque lee
+			// elementos que la mezcla de otro bloque ya podra haber reubicado.
+			auto FindSplits = [=, &Less](size_t Begin, size_t End) {
+				for (size_t Block = Begin; Block < End; ++Block)
+				{
+					size_t PairBegin = (Block / BlocksPerPair) * PairSize;
+					size_t PairMiddle = PairBegin + Width < Count ? PairBegin + Width : Count;
+					size_t PairEnd = PairBegin + PairSize < Count ? PairBegin + PairSize : Count;
+					size_t Diagonal = (Block % BlocksPerPair) * MergeBlock;
+					if (PairBegin + Diagonal < PairEnd)
+					{
+						SplitData[Block] = MergePathSplit(Source + PairBegin, PairMiddle - PairBegin,
+							Source + PairMiddle, PairEnd - PairMiddle, Diagonal, Less);
+					}
+				}
+			};
+			ParallelForGrain(NumBlocks, 64, FindSplits, System);
+
+			auto MergeBlocks = [=, &Less](size_t Begin, size_t End) {
+				for (size_t Block = Begin; Block < End; ++Block)
+				{
+					size_t PairBegin = (Block / BlocksPerPair) * PairSize;
+					size_t PairMiddle = PairBegin + Width < Count ? PairBegin + Width : Count;
+					size_t PairEnd = PairBegin + PairSize < Count ? PairBegin + PairSize : Count;
+					size_t OutBegin = PairBegin + (Block % BlocksPerPair) * MergeBlock;
+					if (OutBegin >= PairEnd)
+					{
+						continue;
+					}
+					size_t OutEnd = OutBegin + MergeBlock < PairEnd ? OutBegin + MergeBlock : PairEnd;
+					size_t SplitBegin = SplitData[Block];
+					size_t SplitEnd = OutEnd == PairEnd ? PairMiddle - PairBegin : SplitData[Block + 1];
+
+					T* A = Source + PairBegin;
+					T* B = Source + PairMiddle;
+					RelocateMerge(A + SplitBegin, A + SplitEnd,
+						B + (OutBegin - PairBegin - SplitBegin), B + (OutEnd - PairBegin - SplitEnd),
+						Destination + OutBegin, Less);
+				}
+			};
+			ParallelForGrain(NumBlocks, 1, MergeBlocks, System);
+			std::swap(Source, Destination);
+		}
+		if (Source != Data)
+		{
+			auto CopyBack = [Source, Data](size_t Begin, size_t End) {
+				for (size_t i = Begin; i < End; ++i)
+				{
+					new (Data + i) T(std::move(Source[i]));
+					Source[i].~T();
+				}
+			};
+			ParallelForGrain(Count, MergeBlock, CopyBack, System);
+		}
+		Allocator.Deallocate(Scratch, Count * sizeof(T), alignof(T));
+	}
+
+	/**
+	 * @brief Ordena un TArray de forma estable por radix LSD en paralelo.
+	 *
+	 * Mismo algoritmo que RadixSort, con el array cortado en trozos contiguos de tamao fijo.
+	 * En cada pasada cada trozo cuenta su histograma en paralelo; una suma prefija en serie
+	 * (256 casillas por trozo) da a cada trozo su posicin de escritura dentro de cada cubeta
+	 * y el reparto se hace tambin en paralelo. Al escribir los trozos en orden dentro de cada
+	 * cubeta la ordenacin sigue siendo estable. Sin trabajadores, o con menos de
+	 * MinParallelCount elementos, equivale a RadixSort.
+	 *
+	 * @param Array El array a ordenar. Sus elementos deben ser trivialmente copiables.
+	 * @param Key Funcin con la firma K(const T&), donde K es entero, float o double; por defecto el propio elemento.
+	 * @param System Sistema de trabajos (por defecto el global).
+	 */
+	template<typename T, typename Alloc, typename KeyFn = TIdentityKey<T>>
+	void ParallelRadixSort(TArray<T, Alloc>& Array, KeyFn Key = KeyFn(), FJobSystem& System = FJobSystem::Get())
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "ParallelRadixSort requiere elementos trivialmente copiables.");
+		using KeyType = TRadixKey<T, KeyFn>;
+		const size_t NumPasses = sizeof(KeyType);
+		const size_t MinParallelCount = 16384;
+		const size_t Count = Array.Num();
+		if (Count < MinParallelCount || System.GetNumWorkers() == 0)
+		{
+			RadixSort(Array, Key);
+			return;
+		}
+
+		const size_t ChunkSize = ComputeParallelGrain(Count, System.GetNumThreads(), 4096);
+		const size_t NumChunks = (Count + ChunkSize - 1) / ChunkSize;
+		TArray<size_t> Histograms;
+		Histograms.Reserve(NumChunks * 256);
+		for (size_t i = 0; i < NumChunks * 256; ++i)
+		{
+			Histograms.Add(0);
+		}
+		size_t* Offsets = Histograms.GetData();
+
+		Alloc Allocator(Array.GetAllocator());
+		T* Scratch = static_cast<T*>(Allocator.Allocate(Count * sizeof(T), alignof(T)));
+		T* Data = Array.GetData();
+		T* Source = Data;
+		T* Destination = Scratch;
+		for (size_t Pass = 0; Pass < NumPasses; ++Pass)
+		{
+			const size_t Shift = Pass * 8;
+			auto CountDigits = [=, &Key](size_t Begin, size_t End) {
+				size_t* ChunkCounts = Offsets + (Begin / ChunkSize) * 256;
+				std::memset(ChunkCounts, 0, 256 * sizeof(size_t));
+				for (size_t i = Begin; i < End; ++i)
+				{
+					++ChunkCounts[(ToRadixKey(Key(Source[i])) >> Shift) & 0xFF];
+				}
+			};
+			ParallelForGrain(Count, ChunkSize, CountDigits, System);
+
+			// Cubeta a cubeta y, dentro de cada una, trozo a trozo: el orden de salida estable.
+			size_t Sum = 0;
+			bool bSkip = false;
+			for (size_t Digit = 0; Digit < 256; ++Digit)
+			{
+				size_t DigitBegin = Sum;
+				for (size_t Chunk = 0; Chunk < NumChunks; ++Chunk)
+				{
+					size_t Bucket = Offsets[Chunk * 256 + Digit];
+					Offsets[Chunk * 256 + Digit] = Sum;
+					Sum += Bucket;
+				}
+				bSkip = bSkip || Sum - DigitBegin == Count;
+			}
+			if (bSkip)
+			{
+				continue;
+			}
+
+			auto Scatter = [=, &Key](size_t Begin, size_t End) {
+				size_t* ChunkOffsets = Offsets + (Begin / ChunkSize) * 256;
+				for (size_t i = Begin; i < End; ++i)
+				{
+					size_t Digit = (ToRadixKey(Key(Source[i])) >> Shift) & 0xFF;
+					Destination[ChunkOffsets[Digit]++] = Source[i];
+				}
+			};
+			ParallelForGrain(Count, ChunkSize, Scatter, System);
+			std::swap(Source, Destination);
+		}
+		if (Source != Data)
+		{
+			std::memcpy(static_cast<void*>(Data), Source, Count * sizeof(T));
+		}
+		Allocator.Deallocate(Scratch, Count * sizeof(T), alignof(T));
+	}
+}
@@ -0,0 +1,231 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace EngineUtilities {
+	/**
+	 * @brief Cola doble de robo de trabajo de Chase-Lev (versin de L et al., 2013).
+	 *
+	 * El hilo propietario aade y saca elementos por abajo (Push/Pop, orden LIFO; Pop slo
+	 * usa compare-exchange cuando queda un elemento), y el resto de hilos
+	 * roban por arriba (Steal, orden FIFO) con un nico compare-exchange. Las barreras del
+	 * algoritmo original se expresan como operaciones secuenciales sobre Top y Bottom, que en
+	 * x86 generan el mismo cdigo y que ThreadSanitizer s entiende. El buffer circular
+	 * crece al doble cuando se llena; los buffers antiguos se conservan hasta destruir la cola
+	 * porque un ladrn podra estar leyndolos todava.
+	 *
+	 * @tparam T Tipo de los elementos. Debe ser trivialmente copiable y caber en un atmico
+	 *           sin bloqueo (normalmente un puntero a un trabajo).
+	 */
+	template<typename T>
+	class TWorkStealingDeque
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "TWorkStealingDeque requires trivially copyable elements");
+
+	private:
+		/**
+		 * @brief Buffer circular de tamao potencia de dos.
+		 */
+		struct FRing
+		{
+			int64_t Capacity;               ///< Nmero de ranuras (potencia de dos).
+			int64_t Mask;                   ///< Capacity - 1.
+			std::atomic<T>* Slots;          ///< Ranuras; atmicas para que los ladrones lean sin carreras.
+			FRing* Previous;                ///< Buffer al que sustituy (se libera en el destructor).
+
+			explicit FRing(int64_t InCapacity)
+				: Capacity(InCapacity), Mask(InCapacity - 1), Slots(new std::atomic<T>[static_cast<size_t>(InCapacity)]), Previous(nullptr)
+			{
+			}
+
+			~FRing()
+			{
+				delete[] Slots;
+			}
+
+			void Put(int64_t Index, T Value)
+			{
+				Slots[Index & Mask].store(Value, std::memory_order_relaxed);
+			}
+
+			T Get(int64_t Index) const
+			{
+				return Slots[Index & Mask].load(std::memory_order_relaxed);
+			}
+		};
+
+		alignas(64) std::atomic<int64_t> Top;     ///< Siguiente posicin que roban los ladrones.
+		alignas(64) std::atomic<int64_t> Bottom;  ///< Siguiente posicin libre del propietario.
+		std::atomic<FRing*> Ring;                 ///< Buffer actual.
+
+		/**
+		 * @brief Sustituye el buffer por uno del doble de tamao con los elementos [TopIndex, BottomIndex).
+		 */
+		FRing* Grow(FRing* Old, int64_t TopIndex, int64_t BottomIndex)
+		{
+			FRing* NewRing = new FRing(Old->Capacity * 2);
+			for (int64_t i = TopIndex; i < BottomIndex; ++i)
+			{
+				NewRing->Put(i, Old->Get(i));
+			}
+			NewRing->Previous = Old;
+			Ring.store(NewRing, std::memory_order_release);
+			return NewRing;
+		}
+
+	public:
+		/**
+		 * @brief Resultado de un intento de robo.
+		 */
+		enum class ESteal
+		{
+			Success,  ///< Se obtuvo un elemento.
+			Empty,    ///< La cola estaba vaca.
+			Abort     ///< Otro hilo gan la carrera; se puede reintentar.
+		};
+
+		/**
+		 * @brief Crea una cola con capacidad inicial para Capacity elementos (se redondea a potencia de dos).
+		 */
+		explicit TWorkStealingDeque(int64_t Capacity = 1024)
+			: Top(0), Bottom(0), Ring(nullptr)
+		{
+			int64_t RoundedCapacity = 2;
+			while (RoundedCapacity < Capacity)
+			{
+				RoundedCapacity *= 2;
+			}
+			Ring.store(new FRing(RoundedCapacity), std::memory_order_relaxed);
+		}
+
+		TWorkStealingDeque(const TWorkStealingDeque&) = delete;
+		TWorkStealingDeque& operator=(const TWorkStealingDeque&) = delete;
+
+		/**
+		 * @brief Destructor que libera el buffer actual y todos los antiguos.
+		 */
+		~TWorkStealingDeque()
+		{
+			FRing* Current = Ring.load(std::memory_order_relaxed);
+			while (Current != nullptr)
+			{
+				FRing* Previous = Current->Previous;
+				delete Current;
+				Current = Previous;
+			}
+		}
+
+		/**
+		 * @brief Aade un elemento por abajo. Slo lo puede llamar el hilo propietario.
+		 *
+		 * @param Value El elemento a aadir.
+		 */
+		void Push(T Value)
+		{
+			int64_t BottomIndex = Bottom.load(std::memory_order_relaxed);
+			int64_t TopIndex = Top.load(std::memory_order_acquire);
+			FRing* Current = Ring.load(std::memory_order_relaxed);
+			if (BottomIndex - TopIndex > Current->Capacity - 1)
+			{
+				Current = Grow(Current, TopIndex, BottomIndex);
+			}
+			Current->Put(BottomIndex, Value);
+			Bottom.store(BottomIndex + 1, std::memory_order_release);
+		}
+
+		/**
+		 * @brief Saca el ltimo elemento aadido. Slo lo puede llamar el hilo propietario.
+		 *
+		 * @param OutValue Recibe el elemento si lo hay.
+		 * @return true si se obtuvo un elemento.
+		 */
+		bool Pop(T& OutValue)
+		{
+			int64_t BottomIndex = Bottom.load(std::memory_order_relaxed) - 1;
+			FRing* Current = Ring.load(std::memory_order_relaxed);
+			Bottom.store(BottomIndex, std::memory_order_seq_cst);
+			int64_t TopIndex = Top.load(std::memory_order_seq_cst);
+
+			if (TopIndex > BottomIndex)
+			{
+				Bottom.store(BottomIndex + 1, std::memory_order_relaxed);  ///< Estaba vaca.
+				return false;
+			}
+
+			OutValue = Current->Get(BottomIndex);
+			if (TopIndex == BottomIndex)
+			{
+				// ltimo elemento: se disputa con los ladrones.
+				bool bWon = Top.compare_exchange_strong(TopIndex, TopIndex + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				Bottom.store(BottomIndex + 1, std::memory_order_relaxed);
+				return bWon;
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Roba el elemento ms antiguo. Lo puede llamar cualquier hilo.
+		 *
+		 * @param OutValue Recibe el elemento si el robo tiene xito.
+		 * @return El resultado del intento.
+		 */
+		ESteal Steal(T& OutValue)
+		{
+			int64_t TopIndex = Top.load(std::memory_order_seq_cst);
+			int64_t BottomIndex = Bottom.load(std::memory_order_seq_cst);
+			if (TopIndex >= BottomIndex)
+			{
+				return ESteal::Empty;
+			}
+
+			FRing* Current = Ring.load(std::memory_order_acquire);
+			T Value = Current->Get(TopIndex);
+			if (!Top.compare_exchange_strong(TopIndex, TopIndex + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return ESteal::Abort;
+			}
+			OutValue = Value;
+			return ESteal::Success;
+		}
+
+		/**
+		 * @brief Nmero aproximado de elementos (exacto slo si no hay accesos concurrentes).
+		 */
+		size_t Num() const
+		{
+			int64_t BottomIndex = Bottom.load(std::memory_order_relaxed);
+			int64_t TopIndex = Top.load(std::memory_order_relaxed);
+			return BottomIndex > TopIndex ? static_cast<size_t>(BottomIndex - TopIndex) : 0;
+		}
+	};
+}
@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ENGINEUTILITIES_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#else
+#define ENGINEUTILITIES_X86 0
+#endif
+
+// Marks a function as compiled for an instruction set the rest of the build does not
+// assume. It may only be called after checking cpuFeatures().
+#if ENGINEUTILITIES_X86 && (defined(__GNUC__) || defined(__clang__))
+#define ENGINEUTILITIES_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define ENGINEUTILITIES_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#else
+#define ENGINEUTILITIES_TARGET_AVX2
+#define ENGINEUTILITIES_TARGET_AVX512
+#endif
+
+namespace EngineUtilities {
+  /**
+   * @brief Instruction set extensions usable on the running CPU.
+   *
+   * Only extensions that both the CPU and the operating system support are reported
+   * (AVX state must be saved by the OS on context switches).
+   */
+  struct CPUFeatures {
+    bool sse41 = false;   /**< SSE4.1. */
+    bool avx = false;     /**< AVX (256-bit float registers). */
+    bool avx2 = false;    /**< AVX2 (256-bit integer operations). */
+    bool fma = false;     /**< Fused multiply-add (FMA3). */
+    bool avx512f = false; /**< AVX-512 Foundation. */
+  };
+
+#if ENGINEUTILITIES_X86
+  /**
+   * @brief Executes cpuid for a leaf and sub-leaf.
+   *
+   * @param leaf The cpuid leaf.
+   * @param subLeaf The cpuid sub-leaf.
+   * @param regs Receives eax, ebx, ecx and edx.
+   */
+  inline void cpuid(unsigned int leaf, unsigned int subLeaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subLeaf));
+    for (int i = 0; i < 4; ++i) {
+      regs[i] = static_cast<unsigned int>(info[i]);
+    }
+#else
+    __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+  }
+
+  /**
+   * @brief Reads the XCR0 register, which tells which register states the OS saves.
+   */
+  inline unsigned long long readXCR0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+  }
+#endif
+
+  /**
+   * @brief Detects the CPU features once and caches the result.
+   *
+   * @return The features of the running CPU.
+   */
+  inline const CPUFeatures& cpuFeatures() {
+    static const CPUFeatures features = []() {
+      CPUFeatures result;
+#if ENGINEUTILITIES_X86 && !defined(ENGINEUTILITIES_FORCE_SCALAR)
+      unsigned int regs[4];
+      cpuid(0, 0, regs);
+      unsigned int maxLeaf = regs[0];
+      if (maxLeaf < 1) {
+        return result;
+      }
+      cpuid(1, 0, regs);
+      result.sse41 = (regs[2] & (1u << 19)) != 0;
+      bool osxsave = (regs[2] & (1u << 27)) != 0;
+      bool cpuAvx = (regs[2] & (1u << 28)) != 0;
+      bool cpuFma = (regs[2] & (1u << 12)) != 0;
+      unsigned long long xcr0 = osxsave ? readXCR0() : 0;
+      bool osYmm = (xcr0 & 0x6) == 0x6;    // XMM and YMM state.
+      bool osZmm = (xcr0 & 0xE6) == 0xE6;  // Plus opmask and ZMM state.
+      result.avx = cpuAvx && osYmm;
+      result.fma = cpuFma && osYmm;
+      if (maxLeaf >= 7) {
+        cpuid(7, 0, regs);
+        result.avx2 = result.avx && (regs[1] & (1u << 5)) != 0;
+        result.avx512f = osZmm && (regs[1] & (1u << 16)) != 0;
+      }
+#endif
+      return result;
+    }();
+    return features;
+  }
+}
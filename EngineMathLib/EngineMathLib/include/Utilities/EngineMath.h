@@ -27,31 +27,145 @@
  * SOFTWARE.
 */
 #pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if !defined(ENGINEUTILITIES_FORCE_SCALAR) && \
+  (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define ENGINEUTILITIES_MATH_SSE 1
+#include <xmmintrin.h>
+#else
+#define ENGINEUTILITIES_MATH_SSE 0
+#endif
+
 namespace EngineUtilities {
 
   // Constantes matemticas
   constexpr float PI = 3.14159265358979323846f;
   constexpr float E = 2.71828182845904523536f;
 
-	/**
-		 * @brief Computes the square root using the Newton-Raphson method.
-		 *
-		 * @param value The value to compute the square root of.
-		 * @return The computed square root.
-		 */
-	inline float sqrt(float value) {
-		if (value < 0) {
-			return 0; // Handle negative input gracefully.
-		}
-		float x = value;
-		float y = 1.0f;
-		float epsilon = 0.00001f; // Desired precision.
-		while (x - y > epsilon) {
-			x = (x + y) / 2.0f;
-			y = value / x;
-		}
-		return x;
-	}
+  /**
+   * @brief Reinterprets the bits of a float as a 32-bit integer.
+   */
+  inline uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  /**
+   * @brief Reinterprets a 32-bit integer as a float.
+   */
+  inline float floatFromBits(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  /**
+   * @brief Computes an approximate reciprocal square root, 1 / sqrt(value).
+   *
+   * Uses the SSE rsqrtss estimate (12 bits) refined by one Newton-Raphson step, or a
+   * bit-trick seed refined by three steps when SSE is not available. The relative error
+   * is below 5e-7 for every positive finite float. Intended for normalization, where the
+   * reciprocal is what is needed anyway.
+   *
+   * Values outside the normal positive range give the same result as IEEE 1 / sqrt(value)
+   * on both paths: +0 gives +infinity, +infinity gives 0, and negative or NaN input gives NaN.
+   *
+   * @param value The value to compute the reciprocal square root of.
+   * @return The approximate reciprocal square root.
+   */
+  inline float rsqrt(float value) {
+    if (!(value >= std::numeric_limits<float>::min() && value <= std::numeric_limits<float>::max())) {
+      if (value > 0.0f && value < std::numeric_limits<float>::min()) {
+        // Denormals are scaled by 2^48 into the normal range (the estimate flushes them to 0).
+        return rsqrt(value * 281474976710656.0f) * 16777216.0f;
+      }
+      return 1.0f / std::sqrt(value); // Zero, infinity, negative and NaN: the exact IEEE result.
+    }
+#if ENGINEUTILITIES_MATH_SSE
+    float r = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+    r = r * (1.5f - 0.5f * value * r * r);
+#else
+    float r = floatFromBits(0x5F375A86u - (floatBits(value) >> 1));
+    float half = 0.5f * value;
+    r = r * (1.5f - half * r * r);
+    r = r * (1.5f - half * r * r);
+    r = r * (1.5f - half * r * r);
+#endif
+    return r;
+  }
+
+  /**
+   * @brief Computes the factor that scales a vector to unit length.
+   *
+   * Shared by every normalize in the library so that they agree on all inputs. When
+   * lengthSquared is a normal float the components are left as they are and the factor is
+   * rsqrt(lengthSquared). When it overflowed to infinity or fell below the normal range, the
+   * components are first divided by the power of two just above their largest magnitude
+   * (exact, so the direction is kept) and the factor is taken from the rescaled length.
+   *
+   * @param components The vector components; rescaled in place when needed.
+   * @param count Number of components.
+   * @param lengthSquared Sum of the squared components.
+   * @param scale Receives the factor to multiply the (possibly rescaled) components by.
+   * @return false for a zero vector or one with an infinite or NaN component; scale is then 0.
+   */
+  inline bool unitLengthScale(float* components, int count, float lengthSquared, float& scale) {
+    if (lengthSquared >= std::numeric_limits<float>::min() && lengthSquared <= std::numeric_limits<float>::max()) {
+      scale = rsqrt(lengthSquared);
+      return true;
+    }
+    scale = 0.0f;
+    float largest = 0.0f;
+    for (int i = 0; i < count; ++i) {
+      if (!std::isfinite(components[i])) {
+        return false;
+      }
+      largest = std::fmax(largest, std::fabs(components[i]));
+    }
+    if (largest == 0.0f) {
+      return false;
+    }
+    int exponent;
+    std::frexp(largest, &exponent);
+    float rescaledSquared = 0.0f;
+    for (int i = 0; i < count; ++i) {
+      components[i] = std::ldexp(components[i], -exponent);
+      rescaledSquared += components[i] * components[i];
+    }
+    scale = rsqrt(rescaledSquared); // The largest component is now in [0.5, 1).
+    return true;
+  }
+
+  /**
+   * @brief Computes the square root in constant time.
+   *
+   * Uses the hardware square root instruction (correctly rounded) when SSE is available.
+   * Otherwise it refines a bit-trick reciprocal square root seed with a fixed number of
+   * Newton-Raphson steps and multiplies back by the input.
+   *
+   * @param value The value to compute the square root of.
+   * @return The computed square root, or 0 for negative input.
+   */
+  inline float sqrt(float value) {
+    if (value < 0) {
+      return 0; // Handle negative input gracefully.
+    }
+#if ENGINEUTILITIES_MATH_SSE
+    return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(value)));
+#else
+    if (value == 0.0f || !(value <= std::numeric_limits<float>::max())) {
+      return value; // 0, infinity and NaN are their own square roots.
+    }
+    float r = rsqrt(value);
+    float y = value * r;
+    return y + 0.5f * r * (value - y * y); // Final correction step on the root itself.
+#endif
+  }
 
   /**
    * @brief Calcula el cuadrado de un nmero.
@@ -166,31 +280,110 @@ namespace EngineUtilities {
   }
 
   // Funciones Trigonomtricas
+
+  /**
+   * Reduce un ngulo al intervalo [-PI/4, PI/4] restando el mltiplo de PI/2 ms cercano.
+   * La resta se hace en double con PI/2 partido en dos trminos (Cody-Waite), as que el
+   * resultado conserva todos los bits del float para |angle| < 2^20 * PI/2.
+   * @param angle ngulo en radianes.
+   * @param quadrant Recibe el mltiplo de PI/2 restado, mdulo 4.
+   * @return ngulo reducido en radianes.
+   */
+  inline double reduceHalfPi(float angle, int& quadrant) {
+    const double twoOverPi = 6.36619772367581382433e-01;
+    const double halfPi1 = 1.57079632673412561417e+00;   // 33 bits altos de PI/2
+    const double halfPi2 = 6.07710050650619224932e-11;   // PI/2 - halfPi1
+    const double roundMagic = 6755399441055744.0;         // 1.5 * 2^52: redondea al entero ms cercano
+    double x = angle;
+    double shifted = x * twoOverPi + roundMagic;
+    double k = shifted - roundMagic;
+    int64_t bits;
+    std::memcpy(&bits, &shifted, sizeof(bits));
+    quadrant = static_cast<int>(bits & 3);                 // El entero queda en los bits bajos.
+    return (x - k * halfPi1) - k * halfPi2;
+  }
+
+  /**
+   * Polinomio minimax del seno en [-PI/4, PI/4], evaluado en double.
+   * @param r ngulo reducido.
+   * @return Seno de r.
+   */
+  inline double sinKernel(double r) {
+    double r2 = r * r;
+    return r + r * r2 * (-1.6666654611e-1 + r2 * (8.3321608736e-3 + r2 * -1.9515295891e-4));
+  }
+
   /**
-   * Calcula el seno de un ngulo en radianes.
+   * Polinomio minimax del coseno en [-PI/4, PI/4], evaluado en double.
+   * @param r ngulo reducido.
+   * @return Coseno de r.
+   */
+  inline double cosKernel(double r) {
+    double r2 = r * r;
+    return 1.0 - 0.5 * r2 +
+      r2 * r2 * (4.166664568298827e-2 + r2 * (-1.388731625493765e-3 + r2 * 2.443315711809948e-5));
+  }
+
+  // Algo menos de 2^20 * PI/2: hasta aqu k cabe en 20 bits y k * halfPi1 (33 bits) es exacto en
+  // double, as que la reduccin Cody-Waite de dos trminos de reduceHalfPi no pierde bits.
+  // Por encima se delega en la libm.
+  constexpr float TRIG_REDUCTION_LIMIT = 1.6e6f;
+
+  /**
+   * Calcula el seno de un ngulo en radianes con coste fijo.
    * @param angle ngulo en radianes.
    * @return Valor del seno del ngulo.
    */
   inline float sin(float angle) {
-    float result = 0.0f;
-    float term = angle;
-    float angle_squared = angle * angle;
-    int n = 1;
-    while (term > 1e-6f || term < -1e-6f) {
-      result += term;
-      term *= -angle_squared / ((2 * n) * (2 * n + 1));
-      ++n;
+    if (!(fabs(angle) < TRIG_REDUCTION_LIMIT)) {
+      return std::sin(angle); // ngulos enormes, infinito o NaN.
     }
-    return result;
+    int quadrant;
+    double r = reduceHalfPi(angle, quadrant);
+    // Se evalan ambos polinomios y se selecciona sin saltos: el cuadrante es impredecible.
+    double s = sinKernel(r);
+    double c = cosKernel(r);
+    double result = (quadrant & 1) ? c : s;
+    return static_cast<float>((quadrant & 2) ? -result : result);
   }
 
   /**
-   * Calcula el coseno de un ngulo en radianes.
+   * Calcula el coseno de un ngulo en radianes con coste fijo.
    * @param angle ngulo en radianes.
    * @return Valor del coseno del ngulo.
    */
   inline float cos(float angle) {
-    return sin(angle + PI / 2);
+    if (!(fabs(angle) < TRIG_REDUCTION_LIMIT)) {
+      return std::cos(angle); // ngulos enormes, infinito o NaN.
+    }
+    int quadrant;
+    double r = reduceHalfPi(angle, quadrant);
+    double s = sinKernel(r);
+    double c = cosKernel(r);
+    double result = (quadrant & 1) ? s : c;
+    return static_cast<float>(((quadrant + 1) & 2) ? -result : result);
+  }
+
+  /**
+   * Calcula el seno y el coseno de un ngulo compartiendo la reduccin de rango.
+   * @param angle ngulo en radianes.
+   * @param outSin Recibe el seno del ngulo.
+   * @param outCos Recibe el coseno del ngulo.
+   */
+  inline void sincos(float angle, float& outSin, float& outCos) {
+    if (!(fabs(angle) < TRIG_REDUCTION_LIMIT)) {
+      outSin = std::sin(angle); // ngulos enormes, infinito o NaN.
+      outCos = std::cos(angle);
+      return;
+    }
+    int quadrant;
+    double r = reduceHalfPi(angle, quadrant);
+    double s = sinKernel(r);
+    double c = cosKernel(r);
+    double sinResult = (quadrant & 1) ? c : s;
+    double cosResult = (quadrant & 1) ? s : c;
+    outSin = static_cast<float>((quadrant & 2) ? -sinResult : sinResult);
+    outCos = static_cast<float>(((quadrant + 1) & 2) ? -cosResult : cosResult);
   }
 
   /**
@@ -0,0 +1,263 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+
+#include "Utilities/EngineMath.h"
+
+#if !defined(ENGINEUTILITIES_FORCE_SCALAR) && \
+  (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define ENGINEUTILITIES_SIMD_SSE 1
+#define ENGINEUTILITIES_SIMD_NEON 0
+#include <xmmintrin.h>
+#if defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#elif !defined(ENGINEUTILITIES_FORCE_SCALAR) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define ENGINEUTILITIES_SIMD_SSE 0
+#define ENGINEUTILITIES_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define ENGINEUTILITIES_SIMD_SSE 0
+#define ENGINEUTILITIES_SIMD_NEON 0
+#endif
+
+namespace EngineUtilities {
+  /**
+   * @brief A register holding four floats.
+   *
+   * Maps to __m128 on SSE and float32x4_t on NEON. The scalar fallback is a plain
+   * 16-byte aligned array so the same code paths compile everywhere. Define
+   * ENGINEUTILITIES_FORCE_SCALAR to use the fallback on SIMD hardware.
+   */
+#if ENGINEUTILITIES_SIMD_SSE
+  using VectorRegister = __m128;
+#elif ENGINEUTILITIES_SIMD_NEON
+  using VectorRegister = float32x4_t;
+#else
+  struct alignas(16) VectorRegister {
+    float v[4];
+  };
+#endif
+
+  /**
+   * @brief Loads four floats from a 16-byte aligned address.
+   */
+  inline VectorRegister vectorLoadAligned(const float* src) {
+#if ENGINEUTILITIES_SIMD_SSE
+    return _mm_load_ps(src);
+#elif ENGINEUTILITIES_SIMD_NEON
+    return vld1q_f32(src);
+#else
+    return VectorRegister{ { src[0], src[1], src[2], src[3] } };
+#endif
+  }
+
+  /**
+   * @brief Stores four floats to a 16-byte aligned address.
+   */
+  inline void vectorStoreAligned(float* dst, VectorRegister v) {
+#if ENGINEUTILITIES_SIMD_SSE
+    _mm_store_ps(dst, v);
+#elif ENGINEUTILITIES_SIMD_NEON
+    vst1q_f32(dst, v);
+#else
+    dst[0] = v.v[0]; dst[1] = v.v[1]; dst[2] = v.v[2]; dst[3] = v.v[3];
+#endif
+  }
+
+  /**
+   * @brief Builds a register from four lanes.
+   */
+  inline VectorRegister vectorSet(float x, float y, float z, float w) {
+#if ENGINEUTILITIES_SIMD_SSE
+    return _mm_setr_ps(x, y, z, w);
+#elif ENGINEUTILITIES_SIMD_NEON
+    float32x4_t v = { x, y, z, w };
+    return v;
+#else
+    return VectorRegister{ { x, y, z, w } };
+#endif
+  }
+
+  /**
+   * @brief Copies a scalar into all four lanes.
+   */
+  inline VectorRegister vectorReplicate(float value) {
+#if ENGINEUTILITIES_SIMD_SSE
+    return _mm_set1_ps(value);
+#elif ENGINEUTILITIES_SIMD_NEON
+    return vdupq_n_f32(value);
+#else
+    return VectorRegister{ { value, value, value, value } };
+#endif
+  }
+
+  /**
+   * @brief Returns the first lane.
+   */
+  inline float vectorGetX(VectorRegister v) {
+#if ENGINEUTILITIES_SIMD_SSE
+    return _mm_cvtss_f32(v);
+#elif ENGINEUTILITIES_SIMD_NEON
+    return vgetq_lane_f32(v, 0);
+#else
+    return v.v[0];
+#endif
+  }
+
+  /**
+   * @brief Lane-wise a + b.
+   */
+  inline VectorRegister vectorAdd(VectorRegister a, VectorRegister b) {
+#if ENGINEUTILITIES_SIMD_SSE
+    return _mm_add_ps(a, b);
+#elif ENGINEUTILITIES_SIMD_NEON
+    return vaddq_f32(a, b);
+#else
+    return VectorRegister{ { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+#endif
+  }
+
+  /**
+   * @brief Lane-wise a - b.
+   */
+  inline VectorRegister vectorSubtract(VectorRegister a, VectorRegister b) {
+#if ENGINEUTILITIES_SIMD_SSE
+    return _mm_sub_ps(a, b);
+#elif ENGINEUTILITIES_SIMD_NEON
+    return vsubq_f32(a, b);
+#else
+    return VectorRegister{ { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } };
+#endif
+  }
+
+  /**
+   * @brief Lane-wise a * b.
+   */
+  inline VectorRegister vectorMultiply(VectorRegister a, VectorRegister b) {
+#if ENGINEUTILITIES_SIMD_SSE
+    return _mm_mul_ps(a, b);
+#elif ENGINEUTILITIES_SIMD_NEON
+    return vmulq_f32(a, b);
+#else
+    return VectorRegister{ { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+#endif
+  }
+
+  /**
+   * @brief Lane-wise a * b + c.
+   */
+  inline VectorRegister vectorMultiplyAdd(VectorRegister a, VectorRegister b, VectorRegister c) {
+#if ENGINEUTILITIES_SIMD_SSE && defined(__FMA__)
+    return _mm_fmadd_ps(a, b, c);
+#elif ENGINEUTILITIES_SIMD_NEON
+    return vmlaq_f32(c, a, b);
+#else
+    return vectorAdd(vectorMultiply(a, b), c);
+#endif
+  }
+
+  /**
+   * @brief Lane-wise reciprocal square root, 1 / sqrt(v).
+   *
+   * Only valid for lanes in [FLT_MIN, FLT_MAX]; callers handle zero, subnormal, infinite
+   * and NaN inputs themselves. On SSE it is the hardware estimate plus one Newton-Raphson
+   * step in the same order as EngineUtilities::rsqrt, so both give identical results.
+   */
+  inline VectorRegister vectorReciprocalSqrt(VectorRegister v) {
+#if ENGINEUTILITIES_SIMD_SSE
+    __m128 r = _mm_rsqrt_ps(v);
+    __m128 t = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), v), r), r);
+    return _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), t));
+#elif ENGINEUTILITIES_SIMD_NEON
+    // The NEON estimate has 8 bits; two steps bring it to float precision.
+    float32x4_t r = vrsqrteq_f32(v);
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(v, r), r));
+    return vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(v, r), r));
+#else
+    return VectorRegister{ { rsqrt(v.v[0]), rsqrt(v.v[1]), rsqrt(v.v[2]), rsqrt(v.v[3]) } };
+#endif
+  }
+
+  /**
+   * @brief Rearranges the lanes of a register: result = (v[X], v[Y], v[Z], v[W]).
+   */
+  template<int X, int Y, int Z, int W>
+  inline VectorRegister vectorSwizzle(VectorRegister v) {
+#if ENGINEUTILITIES_SIMD_SSE
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+#elif ENGINEUTILITIES_SIMD_NEON
+    float32x4_t r = { vgetq_lane_f32(v, X), vgetq_lane_f32(v, Y), vgetq_lane_f32(v, Z), vgetq_lane_f32(v, W) };
+    return r;
+#else
+    return VectorRegister{ { v.v[X], v.v[Y], v.v[Z], v.v[W] } };
+#endif
+  }
+
+  /**
+   * @brief Picks two lanes from each register: result = (a[X], a[Y], b[Z], b[W]).
+   */
+  template<int X, int Y, int Z, int W>
+  inline VectorRegister vectorShuffle(VectorRegister a, VectorRegister b) {
+#if ENGINEUTILITIES_SIMD_SSE
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+#elif ENGINEUTILITIES_SIMD_NEON
+    float32x4_t r = { vgetq_lane_f32(a, X), vgetq_lane_f32(a, Y), vgetq_lane_f32(b, Z), vgetq_lane_f32(b, W) };
+    return r;
+#else
+    return VectorRegister{ { a.v[X], a.v[Y], b.v[Z], b.v[W] } };
+#endif
+  }
+
+  /**
+   * @brief Four-lane dot product, broadcast to every lane.
+   */
+  inline VectorRegister vectorDot4(VectorRegister a, VectorRegister b) {
+#if ENGINEUTILITIES_SIMD_SSE && defined(__SSE4_1__)
+    return _mm_dp_ps(a, b, 0xFF);
+#elif ENGINEUTILITIES_SIMD_SSE
+    __m128 product = _mm_mul_ps(a, b);
+    __m128 swapped = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)); // (y, x, w, z)
+    __m128 pairs = _mm_add_ps(product, swapped);                                 // (x+y, x+y, z+w, z+w)
+    swapped = _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm_add_ps(pairs, swapped);
+#elif ENGINEUTILITIES_SIMD_NEON && defined(__aarch64__)
+    return vdupq_n_f32(vaddvq_f32(vmulq_f32(a, b)));
+#elif ENGINEUTILITIES_SIMD_NEON
+    float32x4_t product = vmulq_f32(a, b);
+    float32x2_t pairs = vadd_f32(vget_low_f32(product), vget_high_f32(product));
+    return vdupq_lane_f32(vpadd_f32(pairs, pairs), 0);
+#else
+    float dot = a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3];
+    return VectorRegister{ { dot, dot, dot, dot } };
+#endif
+  }
+}
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "Utilities/EngineMath.h"
+#include "Utilities/VectorRegister.h"
 #include "Vector3.h"
 namespace EngineUtilities {
 	/**
@@ -36,8 +37,11 @@ namespace EngineUtilities {
  *
  * This class represents a quaternion, providing operations such as addition,
  * subtraction, scalar multiplication, normalization, and quaternion multiplication.
+ *
+ * The components are 16-byte aligned in (w, x, y, z) order so every operation works
+ * on a single VectorRegister (SSE, NEON or the scalar fallback).
  */
-	class Quaternion {
+	class alignas(16) Quaternion {
 	public:
 		float w; /**< The real part of the quaternion. */
 		float x; /**< The i component of the quaternion. */
@@ -63,6 +67,24 @@ namespace EngineUtilities {
 		 */
 		Quaternion(float w, float x, float y, float z) : w(w), x(x), y(y), z(z) {}
 
+		/**
+		 * @brief Constructs the quaternion from a register holding (w, x, y, z).
+		 *
+		 * @param v The register to store.
+		 */
+		explicit Quaternion(VectorRegister v) {
+			vectorStoreAligned(&w, v);
+		}
+
+		/**
+		 * @brief Loads the quaternion into a register.
+		 *
+		 * @return A register holding (w, x, y, z).
+		 */
+		VectorRegister toRegister() const {
+			return vectorLoadAligned(&w);
+		}
+
 		/**
 		 * @brief Adds another quaternion to this quaternion.
 		 *
@@ -70,7 +92,7 @@ namespace EngineUtilities {
 		 * @return The result of the addition.
 		 */
 		Quaternion operator+(const Quaternion& other) const {
-			return Quaternion(w + other.w, x + other.x, y + other.y, z + other.z);
+			return Quaternion(vectorAdd(toRegister(), other.toRegister()));
 		}
 
 		/**
@@ -80,7 +102,7 @@ namespace EngineUtilities {
 		 * @return The result of the subtraction.
 		 */
 		Quaternion operator-(const Quaternion& other) const {
-			return Quaternion(w - other.w, x - other.x, y - other.y, z - other.z);
+			return Quaternion(vectorSubtract(toRegister(), other.toRegister()));
 		}
 
 		/**
@@ -90,7 +112,7 @@ namespace EngineUtilities {
 		 * @return The result of the multiplication.
 		 */
 		Quaternion operator*(float scalar) const {
-			return Quaternion(w * scalar, x * scalar, y * scalar, z * scalar);
+			return Quaternion(vectorMultiply(toRegister(), vectorReplicate(scalar)));
 		}
 
 		/**
@@ -100,12 +122,17 @@ namespace EngineUtilities {
 		 * @return The result of the multiplication.
 		 */
 		Quaternion operator*(const Quaternion& other) const {
-			return Quaternion(
-				w * other.w - x * other.x - y * other.y - z * other.z,
-				w * other.x + x * other.w + y * other.z - z * other.y,
-				w * other.y - x * other.z + y * other.w + z * other.x,
-				w * other.z + x * other.y - y * other.x + z * other.w
-			);
+			// Each lane of this quaternion scales a signed permutation of the other one:
+			// r = w * (w', x', y', z') + x * (-x', w', -z', y') + y * (-y', z', w', -x') + z * (-z', -y', x', w')
+			VectorRegister b = other.toRegister();
+			VectorRegister result = vectorMultiply(vectorReplicate(w), b);
+			result = vectorMultiplyAdd(vectorReplicate(x),
+				vectorMultiply(vectorSwizzle<1, 0, 3, 2>(b), vectorSet(-1, 1, -1, 1)), result);
+			result = vectorMultiplyAdd(vectorReplicate(y),
+				vectorMultiply(vectorSwizzle<2, 3, 0, 1>(b), vectorSet(-1, 1, 1, -1)), result);
+			result = vectorMultiplyAdd(vectorReplicate(z),
+				vectorMultiply(vectorSwizzle<3, 2, 1, 0>(b), vectorSet(-1, -1, 1, 1)), result);
+			return Quaternion(result);
 		}
 
 		/**
@@ -128,26 +155,44 @@ namespace EngineUtilities {
 			return !(*this == other);
 		}
 
+		/**
+		 * @brief Calculates the dot product with another quaternion.
+		 *
+		 * @param other The other quaternion.
+		 * @return The dot product.
+		 */
+		float dot(const Quaternion& other) const {
+			return vectorGetX(vectorDot4(toRegister(), other.toRegister()));
+		}
+
 		/**
 		 * @brief Calculates the magnitude (length) of the quaternion.
 		 *
 		 * @return The magnitude of the quaternion.
 		 */
 		float magnitude() const {
-			return EngineUtilities::sqrt(w * w + x * x + y * y + z * z);
+			return EngineUtilities::sqrt(dot(*this));
 		}
 
 		/**
 		 * @brief Normalizes the quaternion.
 		 *
-		 * @return The normalized quaternion.
+		 * @return The normalized quaternion, or the identity for a zero or non-finite quaternion.
 		 */
 		Quaternion normalize() const {
-			float mag = magnitude();
-			if (mag == 0) {
+			VectorRegister v = toRegister();
+			VectorRegister lengthSquared = vectorDot4(v, v);
+			float lengthSquaredX = vectorGetX(lengthSquared);
+			if (lengthSquaredX >= std::numeric_limits<float>::min() && lengthSquaredX <= std::numeric_limits<float>::max()) {
+				return Quaternion(vectorMultiply(v, vectorReciprocalSqrt(lengthSquared)));
+			}
+			// Zero, subnormal, overflowed or non-finite: rescale through the shared scalar path.
+			alignas(16) float components[4] = { w, x, y, z };
+			float scale;
+			if (!EngineUtilities::unitLengthScale(components, 4, lengthSquaredX, scale)) {
 				return Quaternion(1, 0, 0, 0);
 			}
-			return Quaternion(w / mag, x / mag, y / mag, z / mag);
+			return Quaternion(vectorMultiply(vectorLoadAligned(components), vectorReplicate(scale)));
 		}
 
 		/**
@@ -165,7 +210,7 @@ namespace EngineUtilities {
 		 * @return The inverted quaternion.
 		 */
 		Quaternion inverse() const {
-			float magSquared = w * w + x * x + y * y + z * z;
+			float magSquared = dot(*this);
 			if (magSquared == 0) {
 				// Handling division by zero
 				return Quaternion(1, 0, 0, 0);
@@ -193,10 +238,11 @@ namespace EngineUtilities {
 		 * @return The quaternion representing the rotation.
 		 */
 		static Quaternion fromAxisAngle(const Vector3& axis, float angle) {
-			float halfAngle = angle * 0.5f;
-			float sinHalfAngle = EngineUtilities::sin(halfAngle);
+			float sinHalfAngle;
+			float cosHalfAngle;
+			EngineUtilities::sincos(angle * 0.5f, sinHalfAngle, cosHalfAngle);
 			return Quaternion(
-				EngineUtilities::cos(halfAngle),
+				cosHalfAngle,
 				axis.x * sinHalfAngle,
 				axis.y * sinHalfAngle,
 				axis.z * sinHalfAngle
@@ -0,0 +1,455 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <utility>
+#include "Matrix/Matrix4x4.h"
+#include "Structures/TArray.h"
+#include "Vector3.h"
+#include "Vector3StreamKernels.h"
+
+namespace EngineUtilities {
+	/**
+	 * @brief TVector3Stream guarda una coleccin de Vector3 como estructura de arrays (SoA).
+	 *
+	 * Las componentes x, y y z viven en tres arrays de floats separados, alineados a 64 bytes
+	 * y con la capacidad redondeada a mltiplos de 16, de modo que las operaciones en bloque
+	 * procesan 8 (AVX2) o 16 (AVX-512) vectores por instruccin. El conjunto de instrucciones se
+	 * elige una sola vez en tiempo de ejecucin (ver Vector3StreamKernels.h).
+	 *
+	 * Las operaciones en bloque son estticas y escriben en un stream de salida, que puede ser
+	 * uno de los de entrada para operar en el sitio.
+	 */
+	class TVector3Stream
+	{
+	public:
+		static constexpr size_t Alignment = 64;  ///< Alineacin en bytes de cada array (una lnea de cach, un registro AVX-512).
+		static constexpr size_t LaneBlock = 16;  ///< La capacidad es siempre mltiplo de este nmero de floats.
+
+	private:
+		float* Data;       ///< Bloque nico con los arrays x, y, z, uno tras otro.
+		size_t Size;       ///< Nmero de vectores en el stream.
+		size_t Capacity;   ///< Nmero de vectores que caben en cada array.
+
+		/**
+		 * @brief Reserva un bloque alineado para tres arrays de Count floats, a cero.
+		 */
+		static float* Allocate(size_t Count)
+		{
+			size_t Bytes = 3 * Count * sizeof(float);
+			float* Block = static_cast<float*>(::operator new(Bytes, std::align_val_t(Alignment)));
+			std::memset(Block, 0, Bytes);
+			return Block;
+		}
+
+		/**
+		 * @brief Libera un bloque obtenido con Allocate.
+		 */
+		static void Deallocate(float* Block)
+		{
+			if (Block != nullptr)
+			{
+				::operator delete(Block, std::align_val_t(Alignment));
+			}
+		}
+
+		/**
+		 * @brief Cambia la capacidad conservando los vectores actuales.
+		 *
+		 * @param NewCapacity Nueva capacidad, mltiplo de LaneBlock y no menor que Size.
+		 */
+		void Reallocate(size_t NewCapacity)
+		{
+			float* NewData = Allocate(NewCapacity);
+			if (Size > 0)
+			{
+				std::memcpy(NewData, GetX(), Size * sizeof(float));
+				std::memcpy(NewData + NewCapacity, GetY(), Size * sizeof(float));
+				std::memcpy(NewData + 2 * NewCapacity, GetZ(), Size * sizeof(float));
+			}
+			Deallocate(Data);
+			Data = NewData;
+			Capacity = NewCapacity;
+		}
+
+		/**
+		 * @brief Asegura capacidad para Count vectores, creciendo un 50% como mnimo.
+		 */
+		void Grow(size_t Count)
+		{
+			if (Count > Capacity)
+			{
+				size_t Grown = Capacity + Capacity / 2;
+				Reallocate(RoundUpCapacity(Count > Grown ? Count : Grown));
+			}
+		}
+
+		/**
+		 * @brief Redondea Count hacia arriba al siguiente mltiplo de LaneBlock.
+		 */
+		static size_t RoundUpCapacity(size_t Count)
+		{
+			return (Count + LaneBlock - 1) / LaneBlock * LaneBlock;
+		}
+
+		/**
+		 * @brief Termina el programa si dos streams no tienen el mismo nmero de vectores.
+		 */
+		static void CheckSameNum(const TVector3Stream& A, const TVector3Stream& B)
+		{
+			if (A.Size != B.Size)
+			{
+				std::cerr << "Stream size mismatch" << std::endl;  ///< Manejar streams de distinto tamao.
+				exit(1);  ///< Salir del programa en caso de error.
+			}
+		}
+
+		/**
+		 * @brief Vista de slo lectura de los tres arrays para los kernels.
+		 */
+		Vector3StreamIn AsInput() const
+		{
+			return Vector3StreamIn{ GetX(), GetY(), GetZ() };
+		}
+
+		/**
+		 * @brief Vista de escritura de los tres arrays para los kernels.
+		 */
+		Vector3StreamOut AsOutput()
+		{
+			return Vector3StreamOut{ GetX(), GetY(), GetZ() };
+		}
+
+	public:
+		/**
+		 * @brief Constructor por defecto que crea un stream vaco sin reservar memoria.
+		 */
+		TVector3Stream() : Data(nullptr), Size(0), Capacity(0)
+		{
+		}
+
+		/**
+		 * @brief Crea un stream de Count vectores nulos.
+		 *
+		 * @param Count Nmero de vectores.
+		 */
+		explicit TVector3Stream(size_t Count) : Data(nullptr), Size(0), Capacity(0)
+		{
+			SetNum(Count);
+		}
+
+		/**
+		 * @brief Convierte un array de Vector3 (AoS) en un stream (SoA).
+		 *
+		 * @param Vectors Los vectores a copiar.
+		 */
+		explicit TVector3Stream(const TArray<Vector3>& Vectors) : Data(nullptr), Size(0), Capacity(0)
+		{
+			SetNum(Vectors.Num());
+			float* X = GetX();
+			float* Y = GetY();
+			float* Z = GetZ();
+			for (size_t i = 0; i < Size; ++i)
+			{
+				const Vector3& V = Vectors[i];
+				X[i] = V.x;
+				Y[i] = V.y;
+				Z[i] = V.z;
+			}
+		}
+
+		/**
+		 * @brief Constructor de copia.
+		 */
+		TVector3Stream(const TVector3Stream& Other) : Data(nullptr), Size(0), Capacity(0)
+		{
+			*this = Other;
+		}
+
+		/**
+		 * @brief Constructor de movimiento. Other queda vaco.
+		 */
+		TVector3Stream(TVector3Stream&& Other) noexcept : Data(Other.Data), Size(Other.Size), Capacity(Other.Capacity)
+		{
+			Other.Data = nullptr;
+			Other.Size = 0;
+			Other.Capacity = 0;
+		}
+
+		/**
+		 * @brief Destructor que libera la memoria de los tres arrays.
+		 */
+		~TVector3Stream()
+		{
+			Deallocate(Data);
+		}
+
+		/**
+		 * @brief Asignacin por copia.
+		 */
+		TVector3Stream& operator=(const TVector3Stream& Other)
+		{
+			if (this != &Other)
+			{
+				SetNum(0);
+				SetNum(Other.Size);
+				if (Size > 0)
+				{
+					std::memcpy(GetX(), Other.GetX(), Size * sizeof(float));
+					std::memcpy(GetY(), Other.GetY(), Size * sizeof(float));
+					std::memcpy(GetZ(), Other.GetZ(), Size * sizeof(float));
+				}
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Asignacin por movimiento. Other queda vaco.
+		 */
+		TVector3Stream& operator=(TVector3Stream&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				Deallocate(Data);
+				Data = Other.Data;
+				Size = Other.Size;
+				Capacity = Other.Capacity;
+				Other.Data = nullptr;
+				Other.Size = 0;
+				Other.Capacity = 0;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Convierte el stream en un array de Vector3 (AoS).
+		 *
+		 * @return Un TArray con una copia de los vectores.
+		 */
+		TArray<Vector3> ToArray() const
+		{
+			TArray<Vector3> Result;
+			for (size_t i = 0; i < Size; ++i)
+			{
+				Result.Emplace(GetX()[i], GetY()[i], GetZ()[i]);
+			}
+			return Result;
+		}
+
+		/**
+		 * @brief Cambia el nmero de vectores. Los vectores nuevos son nulos.
+		 *
+		 * @param NewNum Nuevo nmero de vectores.
+		 */
+		void SetNum(size_t NewNum)
+		{
+			Grow(NewNum);
+			if (NewNum < Size)
+			{
+				// Mantiene a cero todo lo que queda tras Size para que crecer no exponga valores viejos.
+				size_t Removed = (Size - NewNum) * sizeof(float);
+				std::memset(GetX() + NewNum, 0, Removed);
+				std::memset(GetY() + NewNum, 0, Removed);
+				std::memset(GetZ() + NewNum, 0, Removed);
+			}
+			Size = NewNum;
+		}
+
+		/**
+		 * @brief Reserva capacidad para Count vectores sin cambiar Num().
+		 *
+		 * @param Count Nmero de vectores esperado.
+		 */
+		void Reserve(size_t Count)
+		{
+			if (Count > Capacity)
+			{
+				Reallocate(RoundUpCapacity(Count));
+			}
+		}
+
+		/**
+		 * @brief Aade un vector al final del stream.
+		 *
+		 * @param V El vector a aadir.
+		 */
+		void Add(const Vector3& V)
+		{
+			Grow(Size + 1);
+			GetX()[Size] = V.x;
+			GetY()[Size] = V.y;
+			GetZ()[Size] = V.z;
+			++Size;
+		}
+
+		/**
+		 * @brief Devuelve el vector en la posicin Index.
+		 *
+		 * @param Index ndice del vector.
+		 * @return Una copia del vector.
+		 */
+		Vector3 Get(size_t Index) const
+		{
+			if (Index >= Size)
+			{
+				std::cerr << "Index out of range" << std::endl;  ///< Manejar el caso de ndice fuera de rango.
+				exit(1);  ///< Salir del programa en caso de error.
+			}
+			return Vector3(GetX()[Index], GetY()[Index], GetZ()[Index]);
+		}
+
+		/**
+		 * @brief Sustituye el vector en la posicin Index.
+		 *
+		 * @param Index ndice del vector.
+		 * @param V El nuevo valor.
+		 */
+		void Set(size_t Index, const Vector3& V)
+		{
+			if (Index >= Size)
+			{
+				std::cerr << "Index out of range" << std::endl;  ///< Manejar el caso de ndice fuera de rango.
+				exit(1);  ///< Salir del programa en caso de error.
+			}
+			GetX()[Index] = V.x;
+			GetY()[Index] = V.y;
+			GetZ()[Index] = V.z;
+		}
+
+		/**
+		 * @brief Array de componentes x (alineado a Alignment).
+		 */
+		float* GetX() { return Data; }
+		const float* GetX() const { return Data; }
+
+		/**
+		 * @brief Array de componentes y (alineado a Alignment).
+		 */
+		float* GetY() { return Data + Capacity; }
+		const float* GetY() const { return Data + Capacity; }
+
+		/**
+		 * @brief Array de componentes z (alineado a Alignment).
+		 */
+		float* GetZ() { return Data + 2 * Capacity; }
+		const float* GetZ() const { return Data + 2 * Capacity; }
+
+		/**
+		 * @brief Devuelve el nmero de vectores en el stream.
+		 */
+		size_t Num() const
+		{
+			return Size;
+		}
+
+		/**
+		 * @brief Devuelve la capacidad actual del stream (vectores por array).
+		 */
+		size_t GetCapacity() const
+		{
+			return Capacity;
+		}
+
+		/**
+		 * @brief Suma vector a vector: Out[i] = A[i] + B[i].
+		 */
+		static void AddStreams(const TVector3Stream& A, const TVector3Stream& B, TVector3Stream& Out)
+		{
+			CheckSameNum(A, B);
+			Out.SetNum(A.Size);
+			selectVector3StreamKernels().add(A.AsInput(), B.AsInput(), Out.AsOutput(), A.Size);
+		}
+
+		/**
+		 * @brief Escala todos los vectores: Out[i] = A[i] * Factor.
+		 */
+		static void Scale(const TVector3Stream& A, float Factor, TVector3Stream& Out)
+		{
+			Out.SetNum(A.Size);
+			selectVector3StreamKernels().scale(A.AsInput(), Factor, Out.AsOutput(), A.Size);
+		}
+
+		/**
+		 * @brief Producto escalar vector a vector: Out[i] = dot(A[i], B[i]).
+		 *
+		 * @param Out Array de al menos A.Num() floats (sin requisitos de alineacin).
+		 */
+		static void Dot(const TVector3Stream& A, const TVector3Stream& B, float* Out)
+		{
+			CheckSameNum(A, B);
+			selectVector3StreamKernels().dot(A.AsInput(), B.AsInput(), Out, A.Size);
+		}
+
+		/**
+		 * @brief Producto vectorial vector a vector: Out[i] = cross(A[i], B[i]).
+		 */
+		static void Cross(const TVector3Stream& A, const TVector3Stream& B, TVector3Stream& Out)
+		{
+			CheckSameNum(A, B);
+			Out.SetNum(A.Size);
+			selectVector3StreamKernels().cross(A.AsInput(), B.AsInput(), Out.AsOutput(), A.Size);
+		}
+
+		/**
+		 * @brief Normaliza todos los vectores. Con cualquier conjunto de instrucciones sigue el
+		 *        contrato de Vector3::normalize (salvo el redondeo de rsqrt): los vectores nulos o
+		 *        con componentes infinitas o NaN dan el vector nulo.
+		 */
+		static void Normalize(const TVector3Stream& A, TVector3Stream& Out)
+		{
+			Out.SetNum(A.Size);
+			selectVector3StreamKernels().normalize(A.AsInput(), Out.AsOutput(), A.Size);
+		}
+
+		/**
+		 * @brief Longitud de cada vector: Out[i] = |A[i]|.
+		 *
+		 * @param Out Array de al menos A.Num() floats (sin requisitos de alineacin).
+		 */
+		static void Length(const TVector3Stream& A, float* Out)
+		{
+			selectVector3StreamKernels().length(A.AsInput(), Out, A.Size);
+		}
+
+		/**
+		 * @brief Transforma todos los vectores como puntos (w = 1): Out[i] = M * A[i].
+		 *
+		 * Usa la convencin de vectores columna de Matrix4x4 (la traslacin est en la
+		 * ltima columna) y descarta la fila w, es decir, supone una transformacin afn.
+		 */
+		static void Transform(const Matrix4x4& M, const TVector3Stream& A, TVector3Stream& Out)
+		{
+			Out.SetNum(A.Size);
+			selectVector3StreamKernels().transform(M, A.AsInput(), Out.AsOutput(), A.Size);
+		}
+	};
+}
@@ -101,14 +101,15 @@ namespace EngineUtilities {
     /**
      * @brief Normalizes the vector.
      *
-     * @return The normalized vector.
+     * @return The normalized vector, or the zero vector for a zero or non-finite vector.
      */
     Vector2 normalize() const {
-      float mag = magnitude();
-      if (mag == 0) {
+      float components[2] = { x, y };
+      float scale;
+      if (!EngineUtilities::unitLengthScale(components, 2, x * x + y * y, scale)) {
         return Vector2(0, 0);
       }
-      return Vector2(x / mag, y / mag);
+      return Vector2(components[0] * scale, components[1] * scale);
     }
   };
 }
@@ -103,14 +103,15 @@ namespace EngineUtilities {
 		/**
 		 * @brief Normalizes the vector.
 		 *
-		 * @return The normalized vector.
+		 * @return The normalized vector, or the zero vector for a zero or non-finite vector.
 		 */
 		Vector3 normalize() const {
-			float mag = magnitude();
-			if (mag == 0) {
+			float components[3] = { x, y, z };
+			float scale;
+			if (!EngineUtilities::unitLengthScale(components, 3, x * x + y * y + z * z, scale)) {
 				return Vector3(0, 0, 0);
 			}
-			return Vector3(x / mag, y / mag, z / mag);
+			return Vector3(components[0] * scale, components[1] * scale, components[2] * scale);
 		}
 
 		// Mtodo para obtener un puntero a los datos como un arreglo
@@ -0,0 +1,382 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#pragma once
+#include <cstddef>
+#include <limits>
+#include "Matrix/Matrix4x4.h"
+#include "Utilities/CPUFeatures.h"
+#include "Utilities/EngineMath.h"
+
+#if ENGINEUTILITIES_X86 && !defined(ENGINEUTILITIES_FORCE_SCALAR)
+#define ENGINEUTILITIES_STREAM_AVX 1
+#include <immintrin.h>
+#else
+#define ENGINEUTILITIES_STREAM_AVX 0
+#endif
+
+namespace EngineUtilities {
+  /**
+   * @brief Read-only view of n Vector3 stored as three float arrays.
+   */
+  struct Vector3StreamIn {
+    const float* x;
+    const float* y;
+    const float* z;
+
+    Vector3StreamIn offset(size_t i) const { return Vector3StreamIn{ x + i, y + i, z + i }; }
+  };
+
+  /**
+   * @brief Writable view of n Vector3 stored as three float arrays.
+   */
+  struct Vector3StreamOut {
+    float* x;
+    float* y;
+    float* z;
+
+    Vector3StreamOut offset(size_t i) const { return Vector3StreamOut{ x + i, y + i, z + i }; }
+  };
+
+  // Portable kernels. Plain loops that the compiler can vectorize with the baseline ISA;
+  // also used for the tails of the AVX kernels. Outputs may alias inputs index by index.
+
+  inline void addVector3StreamScalar(Vector3StreamIn a, Vector3StreamIn b, Vector3StreamOut out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      out.x[i] = a.x[i] + b.x[i];
+      out.y[i] = a.y[i] + b.y[i];
+      out.z[i] = a.z[i] + b.z[i];
+    }
+  }
+
+  inline void scaleVector3StreamScalar(Vector3StreamIn a, float scale, Vector3StreamOut out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      out.x[i] = a.x[i] * scale;
+      out.y[i] = a.y[i] * scale;
+      out.z[i] = a.z[i] * scale;
+    }
+  }
+
+  inline void dotVector3StreamScalar(Vector3StreamIn a, Vector3StreamIn b, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+    }
+  }
+
+  inline void crossVector3StreamScalar(Vector3StreamIn a, Vector3StreamIn b, Vector3StreamOut out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      float x = a.y[i] * b.z[i] - a.z[i] * b.y[i];
+      float y = a.z[i] * b.x[i] - a.x[i] * b.z[i];
+      float z = a.x[i] * b.y[i] - a.y[i] * b.x[i];
+      out.x[i] = x;
+      out.y[i] = y;
+      out.z[i] = z;
+    }
+  }
+
+  // Every normalize kernel follows Vector3::normalize (see unitLengthScale): finite non-zero
+  // vectors get unit length, zero and non-finite vectors give the zero vector. The SIMD
+  // kernels hand any block with a squared length outside the normal float range to this one.
+  inline void normalizeVector3StreamScalar(Vector3StreamIn a, Vector3StreamOut out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      float components[3] = { a.x[i], a.y[i], a.z[i] };
+      float lengthSquared = components[0] * components[0] + components[1] * components[1] + components[2] * components[2];
+      float scale;
+      if (!EngineUtilities::unitLengthScale(components, 3, lengthSquared, scale)) {
+        components[0] = components[1] = components[2] = 0.0f;
+      }
+      out.x[i] = components[0] * scale;
+      out.y[i] = components[1] * scale;
+      out.z[i] = components[2] * scale;
+    }
+  }
+
+  inline void lengthVector3StreamScalar(Vector3StreamIn a, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = EngineUtilities::sqrt(a.x[i] * a.x[i] + a.y[i] * a.y[i] + a.z[i] * a.z[i]);
+    }
+  }
+
+  inline void transformVector3StreamScalar(const Matrix4x4& m, Vector3StreamIn a, Vector3StreamOut out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      float x = a.x[i], y = a.y[i], z = a.z[i];
+      out.x[i] = m.m[0][0] * x + m.m[0][1] * y + m.m[0][2] * z + m.m[0][3];
+      out.y[i] = m.m[1][0] * x + m.m[1][1] * y + m.m[1][2] * z + m.m[1][3];
+      out.z[i] = m.m[2][0] * x + m.m[2][1] * y + m.m[2][2] * z + m.m[2][3];
+    }
+  }
+
+#if ENGINEUTILITIES_STREAM_AVX
+  // AVX2/FMA kernels: 8 vectors per iteration. Only call them when cpuFeatures()
+  // reports avx2 and fma.
+
+  ENGINEUTILITIES_TARGET_AVX2 inline void addVector3StreamAVX2(Vector3StreamIn a, Vector3StreamIn b, Vector3StreamOut out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      _mm256_storeu_ps(out.x + i, _mm256_add_ps(_mm256_loadu_ps(a.x + i), _mm256_loadu_ps(b.x + i)));
+      _mm256_storeu_ps(out.y + i, _mm256_add_ps(_mm256_loadu_ps(a.y + i), _mm256_loadu_ps(b.y + i)));
+      _mm256_storeu_ps(out.z + i, _mm256_add_ps(_mm256_loadu_ps(a.z + i), _mm256_loadu_ps(b.z + i)));
+    }
+    addVector3StreamScalar(a.offset(i), b.offset(i), out.offset(i), n - i);
+  }
+
+  ENGINEUTILITIES_TARGET_AVX2 inline void scaleVector3StreamAVX2(Vector3StreamIn a, float scale, Vector3StreamOut out, size_t n) {
+    __m256 s = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      _mm256_storeu_ps(out.x + i, _mm256_mul_ps(_mm256_loadu_ps(a.x + i), s));
+      _mm256_storeu_ps(out.y + i, _mm256_mul_ps(_mm256_loadu_ps(a.y + i), s));
+      _mm256_storeu_ps(out.z + i, _mm256_mul_ps(_mm256_loadu_ps(a.z + i), s));
+    }
+    scaleVector3StreamScalar(a.offset(i), scale, out.offset(i), n - i);
+  }
+
+  ENGINEUTILITIES_TARGET_AVX2 inline void dotVector3StreamAVX2(Vector3StreamIn a, Vector3StreamIn b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256 dot = _mm256_mul_ps(_mm256_loadu_ps(a.x + i), _mm256_loadu_ps(b.x + i));
+      dot = _mm256_fmadd_ps(_mm256_loadu_ps(a.y + i), _mm256_loadu_ps(b.y + i), dot);
+      dot = _mm256_fmadd_ps(_mm256_loadu_ps(a.z + i), _mm256_loadu_ps(b.z + i), dot);
+      _mm256_storeu_ps(out + i, dot);
+    }
+    dotVector3StreamScalar(a.offset(i), b.offset(i), out + i, n - i);
+  }
+
+  ENGINEUTILITIES_TARGET_AVX2 inline void crossVector3StreamAVX2(Vector3StreamIn a, Vector3StreamIn b, Vector3StreamOut out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256 ax = _mm256_loadu_ps(a.x + i), ay = _mm256_loadu_ps(a.y + i), az = _mm256_loadu_ps(a.z + i);
+      __m256 bx = _mm256_loadu_ps(b.x + i), by = _mm256_loadu_ps(b.y + i), bz = _mm256_loadu_ps(b.z + i);
+      _mm256_storeu_ps(out.x + i, _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by)));
+      _mm256_storeu_ps(out.y + i, _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz)));
+      _mm256_storeu_ps(out.z + i, _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx)));
+    }
+    crossVector3StreamScalar(a.offset(i), b.offset(i), out.offset(i), n - i);
+  }
+
+  ENGINEUTILITIES_TARGET_AVX2 inline void normalizeVector3StreamAVX2(Vector3StreamIn a, Vector3StreamOut out, size_t n) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+    const __m256 minLengthSquared = _mm256_set1_ps(std::numeric_limits<float>::min());
+    const __m256 maxLengthSquared = _mm256_set1_ps(std::numeric_limits<float>::max());
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256 x = _mm256_loadu_ps(a.x + i), y = _mm256_loadu_ps(a.y + i), z = _mm256_loadu_ps(a.z + i);
+      __m256 lengthSquared = _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)));
+      // Zero, subnormal, infinite or NaN squared lengths: the estimate would give 0, inf or NaN.
+      __m256 normal = _mm256_and_ps(_mm256_cmp_ps(lengthSquared, minLengthSquared, _CMP_GE_OQ),
+        _mm256_cmp_ps(lengthSquared, maxLengthSquared, _CMP_LE_OQ));
+      if (_mm256_movemask_ps(normal) != 0xFF) {
+        normalizeVector3StreamScalar(a.offset(i), out.offset(i), 8);
+        continue;
+      }
+      // rsqrt estimate (12 bits) plus one Newton-Raphson step.
+      __m256 r = _mm256_rsqrt_ps(lengthSquared);
+      r = _mm256_mul_ps(r, _mm256_fnmadd_ps(_mm256_mul_ps(half, lengthSquared), _mm256_mul_ps(r, r), threeHalves));
+      _mm256_storeu_ps(out.x + i, _mm256_mul_ps(x, r));
+      _mm256_storeu_ps(out.y + i, _mm256_mul_ps(y, r));
+      _mm256_storeu_ps(out.z + i, _mm256_mul_ps(z, r));
+    }
+    normalizeVector3StreamScalar(a.offset(i), out.offset(i), n - i);
+  }
+
+  ENGINEUTILITIES_TARGET_AVX2 inline void lengthVector3StreamAVX2(Vector3StreamIn a, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256 x = _mm256_loadu_ps(a.x + i), y = _mm256_loadu_ps(a.y + i), z = _mm256_loadu_ps(a.z + i);
+      _mm256_storeu_ps(out + i, _mm256_sqrt_ps(_mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)))));
+    }
+    lengthVector3StreamScalar(a.offset(i), out + i, n - i);
+  }
+
+  ENGINEUTILITIES_TARGET_AVX2 inline void transformVector3StreamAVX2(const Matrix4x4& m, Vector3StreamIn a, Vector3StreamOut out, size_t n) {
+    __m256 c[3][4];
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 4; ++col) {
+        c[row][col] = _mm256_set1_ps(m.m[row][col]);
+      }
+    }
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256 x = _mm256_loadu_ps(a.x + i), y = _mm256_loadu_ps(a.y + i), z = _mm256_loadu_ps(a.z + i);
+      __m256 rows[3];
+      for (int row = 0; row < 3; ++row) {
+        rows[row] = _mm256_fmadd_ps(c[row][0], x, _mm256_fmadd_ps(c[row][1], y, _mm256_fmadd_ps(c[row][2], z, c[row][3])));
+      }
+      _mm256_storeu_ps(out.x + i, rows[0]);
+      _mm256_storeu_ps(out.y + i, rows[1]);
+      _mm256_storeu_ps(out.z + i, rows[2]);
+    }
+    transformVector3StreamScalar(m, a.offset(i), out.offset(i), n - i);
+  }
+
+  // AVX-512 kernels: 16 vectors per iteration, with a masked final iteration instead of
+  // a scalar tail. Only call them when cpuFeatures() reports avx512f.
+
+  /**
+   * @brief Mask with the lowest min(remaining, 16) lanes set.
+   */
+  ENGINEUTILITIES_TARGET_AVX512 inline __mmask16 tailMaskAVX512(size_t remaining) {
+    return remaining >= 16 ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << remaining) - 1);
+  }
+
+  ENGINEUTILITIES_TARGET_AVX512 inline void addVector3StreamAVX512(Vector3StreamIn a, Vector3StreamIn b, Vector3StreamOut out, size_t n) {
+    for (size_t i = 0; i < n; i += 16) {
+      __mmask16 k = tailMaskAVX512(n - i);
+      _mm512_mask_storeu_ps(out.x + i, k, _mm512_add_ps(_mm512_maskz_loadu_ps(k, a.x + i), _mm512_maskz_loadu_ps(k, b.x + i)));
+      _mm512_mask_storeu_ps(out.y + i, k, _mm512_add_ps(_mm512_maskz_loadu_ps(k, a.y + i), _mm512_maskz_loadu_ps(k, b.y + i)));
+      _mm512_mask_storeu_ps(out.z + i, k, _mm512_add_ps(_mm512_maskz_loadu_ps(k, a.z + i), _mm512_maskz_loadu_ps(k, b.z + i)));
+    }
+  }
+
+  ENGINEUTILITIES_TARGET_AVX512 inline void scaleVector3StreamAVX512(Vector3StreamIn a, float scale, Vector3StreamOut out, size_t n) {
+    __m512 s = _mm512_set1_ps(scale);
+    for (size_t i = 0; i < n; i += 16) {
+      __mmask16 k = tailMaskAVX512(n - i);
+      _mm512_mask_storeu_ps(out.x + i, k, _mm512_mul_ps(_mm512_maskz_loadu_ps(k, a.x + i), s));
+      _mm512_mask_storeu_ps(out.y + i, k, _mm512_mul_ps(_mm512_maskz_loadu_ps(k, a.y + i), s));
+      _mm512_mask_storeu_ps(out.z + i, k, _mm512_mul_ps(_mm512_maskz_loadu_ps(k, a.z + i), s));
+    }
+  }
+
+  ENGINEUTILITIES_TARGET_AVX512 inline void dotVector3StreamAVX512(Vector3StreamIn a, Vector3StreamIn b, float* out, size_t n) {
+    for (size_t i = 0; i < n; i += 16) {
+      __mmask16 k = tailMaskAVX512(n - i);
+      __m512 dot = _mm512_mul_ps(_mm512_maskz_loadu_ps(k, a.x + i), _mm512_maskz_loadu_ps(k, b.x + i));
+      dot = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(k, a.y + i), _mm512_maskz_loadu_ps(k, b.y + i), dot);
+      dot = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(k, a.z + i), _mm512_maskz_loadu_ps(k, b.z + i), dot);
+      _mm512_mask_storeu_ps(out + i, k, dot);
+    }
+  }
+
+  ENGINEUTILITIES_TARGET_AVX512 inline void crossVector3StreamAVX512(Vector3StreamIn a, Vector3StreamIn b, Vector3StreamOut out, size_t n) {
+    for (size_t i = 0; i < n; i += 16) {
+      __mmask16 k = tailMaskAVX512(n - i);
+      __m512 ax = _mm512_maskz_loadu_ps(k, a.x + i), ay = _mm512_maskz_loadu_ps(k, a.y + i), az = _mm512_maskz_loadu_ps(k, a.z + i);
+      __m512 bx = _mm512_maskz_loadu_ps(k, b.x + i), by = _mm512_maskz_loadu_ps(k, b.y + i), bz = _mm512_maskz_loadu_ps(k, b.z + i);
+      _mm512_mask_storeu_ps(out.x + i, k, _mm512_fmsub_ps(ay, bz, _mm512_mul_ps(az, by)));
+      _mm512_mask_storeu_ps(out.y + i, k, _mm512_fmsub_ps(az, bx, _mm512_mul_ps(ax, bz)));
+      _mm512_mask_storeu_ps(out.z + i, k, _mm512_fmsub_ps(ax, by, _mm512_mul_ps(ay, bx)));
+    }
+  }
+
+  ENGINEUTILITIES_TARGET_AVX512 inline void normalizeVector3StreamAVX512(Vector3StreamIn a, Vector3StreamOut out, size_t n) {
+    const __m512 half = _mm512_set1_ps(0.5f);
+    const __m512 threeHalves = _mm512_set1_ps(1.5f);
+    const __m512 minLengthSquared = _mm512_set1_ps(std::numeric_limits<float>::min());
+    const __m512 maxLengthSquared = _mm512_set1_ps(std::numeric_limits<float>::max());
+    for (size_t i = 0; i < n; i += 16) {
+      __mmask16 k = tailMaskAVX512(n - i);
+      __m512 x = _mm512_maskz_loadu_ps(k, a.x + i), y = _mm512_maskz_loadu_ps(k, a.y + i), z = _mm512_maskz_loadu_ps(k, a.z + i);
+      __m512 lengthSquared = _mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x)));
+      // Zero, subnormal, infinite or NaN squared lengths (in active lanes) go to the scalar kernel.
+      __mmask16 normal = _mm512_cmp_ps_mask(lengthSquared, minLengthSquared, _CMP_GE_OQ) &
+        _mm512_cmp_ps_mask(lengthSquared, maxLengthSquared, _CMP_LE_OQ);
+      if ((normal & k) != k) {
+        normalizeVector3StreamScalar(a.offset(i), out.offset(i), n - i < 16 ? n - i : 16);
+        continue;
+      }
+      // rsqrt14 estimate plus one Newton-Raphson step.
+      __m512 r = _mm512_maskz_rsqrt14_ps(k, lengthSquared);
+      r = _mm512_mul_ps(r, _mm512_fnmadd_ps(_mm512_mul_ps(half, lengthSquared), _mm512_mul_ps(r, r), threeHalves));
+      _mm512_mask_storeu_ps(out.x + i, k, _mm512_mul_ps(x, r));
+      _mm512_mask_storeu_ps(out.y + i, k, _mm512_mul_ps(y, r));
+      _mm512_mask_storeu_ps(out.z + i, k, _mm512_mul_ps(z, r));
+    }
+  }
+
+  ENGINEUTILITIES_TARGET_AVX512 inline void lengthVector3StreamAVX512(Vector3StreamIn a, float* out, size_t n) {
+    for (size_t i = 0; i < n; i += 16) {
+      __mmask16 k = tailMaskAVX512(n - i);
+      __m512 x = _mm512_maskz_loadu_ps(k, a.x + i), y = _mm512_maskz_loadu_ps(k, a.y + i), z = _mm512_maskz_loadu_ps(k, a.z + i);
+      _mm512_mask_storeu_ps(out + i, k, _mm512_maskz_sqrt_ps(k, _mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x)))));
+    }
+  }
+
+  ENGINEUTILITIES_TARGET_AVX512 inline void transformVector3StreamAVX512(const Matrix4x4& m, Vector3StreamIn a, Vector3StreamOut out, size_t n) {
+    __m512 c[3][4];
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 4; ++col) {
+        c[row][col] = _mm512_set1_ps(m.m[row][col]);
+      }
+    }
+    for (size_t i = 0; i < n; i += 16) {
+      __mmask16 k = tailMaskAVX512(n - i);
+      __m512 x = _mm512_maskz_loadu_ps(k, a.x + i), y = _mm512_maskz_loadu_ps(k, a.y + i), z = _mm512_maskz_loadu_ps(k, a.z + i);
+      __m512 rows[3];
+      for (int row = 0; row < 3; ++row) {
+        rows[row] = _mm512_fmadd_ps(c[row][0], x, _mm512_fmadd_ps(c[row][1], y, _mm512_fmadd_ps(c[row][2], z, c[row][3])));
+      }
+      _mm512_mask_storeu_ps(out.x + i, k, rows[0]);
+      _mm512_mask_storeu_ps(out.y + i, k, rows[1]);
+      _mm512_mask_storeu_ps(out.z + i, k, rows[2]);
+    }
+  }
+#endif
+
+  /**
+   * @brief Table of the Vector3 stream kernels for one instruction set.
+   */
+  struct Vector3StreamKernels {
+    void (*add)(Vector3StreamIn, Vector3StreamIn, Vector3StreamOut, size_t);
+    void (*scale)(Vector3StreamIn, float, Vector3StreamOut, size_t);
+    void (*dot)(Vector3StreamIn, Vector3StreamIn, float*, size_t);
+    void (*cross)(Vector3StreamIn, Vector3StreamIn, Vector3StreamOut, size_t);
+    void (*normalize)(Vector3StreamIn, Vector3StreamOut, size_t);
+    void (*length)(Vector3StreamIn, float*, size_t);
+    void (*transform)(const Matrix4x4&, Vector3StreamIn, Vector3StreamOut, size_t);
+    const char* name; /**< Instruction set, for logs and benchmarks. */
+  };
+
+  /**
+   * @brief Picks the widest kernel table the running CPU supports (once).
+   *
+   * @return AVX-512, AVX2 or the portable kernels.
+   */
+  inline const Vector3StreamKernels& selectVector3StreamKernels() {
+    static const Vector3StreamKernels scalarKernels = {
+      &addVector3StreamScalar, &scaleVector3StreamScalar, &dotVector3StreamScalar, &crossVector3StreamScalar,
+      &normalizeVector3StreamScalar, &lengthVector3StreamScalar, &transformVector3StreamScalar, "scalar" };
+#if ENGINEUTILITIES_STREAM_AVX
+    static const Vector3StreamKernels avx2Kernels = {
+      &addVector3StreamAVX2, &scaleVector3StreamAVX2, &dotVector3StreamAVX2, &crossVector3StreamAVX2,
+      &normalizeVector3StreamAVX2, &lengthVector3StreamAVX2, &transformVector3StreamAVX2, "avx2" };
+    static const Vector3StreamKernels avx512Kernels = {
+      &addVector3StreamAVX512, &scaleVector3StreamAVX512, &dotVector3StreamAVX512, &crossVector3StreamAVX512,
+      &normalizeVector3StreamAVX512, &lengthVector3StreamAVX512, &transformVector3StreamAVX512, "avx512" };
+    const CPUFeatures& features = cpuFeatures();
+    if (features.avx512f) {
+      return avx512Kernels;
+    }
+    if (features.avx2 && features.fma) {
+      return avx2Kernels;
+    }
+#endif
+    return scalarKernels;
+  }
+}
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "Utilities/EngineMath.h"
+#include "Utilities/VectorRegister.h"
 namespace EngineUtilities {
   /**
  * @brief A 4D vector class.
@@ -36,8 +37,11 @@ namespace EngineUtilities {
  * This class represents a vector in 4-dimensional space and provides
  * basic vector operations such as addition, subtraction, scalar multiplication,
  * and normalization.
+ *
+ * The four components are 16-byte aligned so every operation works on a single
+ * VectorRegister (SSE, NEON or the scalar fallback).
  */
-  class Vector4 {
+  class alignas(16) Vector4 {
   public:
     float x; /**< The x-coordinate of the vector. */
     float y; /**< The y-coordinate of the vector. */
@@ -63,6 +67,24 @@ namespace EngineUtilities {
      */
     Vector4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
 
+    /**
+     * @brief Constructs the vector from a register holding (x, y, z, w).
+     *
+     * @param v The register to store.
+     */
+    explicit Vector4(VectorRegister v) {
+      vectorStoreAligned(&x, v);
+    }
+
+    /**
+     * @brief Loads the vector into a register.
+     *
+     * @return A register holding (x, y, z, w).
+     */
+    VectorRegister toRegister() const {
+      return vectorLoadAligned(&x);
+    }
+
     /**
      * @brief Adds another vector to this vector.
      *
@@ -70,7 +92,7 @@ namespace EngineUtilities {
      * @return The result of the addition.
      */
     Vector4 operator+(const Vector4& other) const {
-      return Vector4(x + other.x, y + other.y, z + other.z, w + other.w);
+      return Vector4(vectorAdd(toRegister(), other.toRegister()));
     }
 
     /**
@@ -80,7 +102,7 @@ namespace EngineUtilities {
      * @return The result of the subtraction.
      */
     Vector4 operator-(const Vector4& other) const {
-      return Vector4(x - other.x, y - other.y, z - other.z, w - other.w);
+      return Vector4(vectorSubtract(toRegister(), other.toRegister()));
     }
 
     /**
@@ -90,7 +112,17 @@ namespace EngineUtilities {
      * @return The result of the multiplication.
      */
     Vector4 operator*(float scalar) const {
-      return Vector4(x * scalar, y * scalar, z * scalar, w * scalar);
+      return Vector4(vectorMultiply(toRegister(), vectorReplicate(scalar)));
+    }
+
+    /**
+     * @brief Calculates the dot product with another vector.
+     *
+     * @param other The other vector.
+     * @return The dot product.
+     */
+    float dot(const Vector4& other) const {
+      return vectorGetX(vectorDot4(toRegister(), other.toRegister()));
     }
 
     /**
@@ -99,20 +131,28 @@ namespace EngineUtilities {
      * @return The magnitude of the vector.
      */
     float magnitude() const {
-      return EngineUtilities::sqrt(x * x + y * y + z * z + w * w);
+      return EngineUtilities::sqrt(dot(*this));
     }
 
     /**
      * @brief Normalizes the vector.
      *
-     * @return The normalized vector.
+     * @return The normalized vector, or the zero vector for a zero or non-finite vector.
      */
     Vector4 normalize() const {
-      float mag = magnitude();
-      if (mag == 0) {
+      VectorRegister v = toRegister();
+      VectorRegister lengthSquared = vectorDot4(v, v);
+      float lengthSquaredX = vectorGetX(lengthSquared);
+      if (lengthSquaredX >= std::numeric_limits<float>::min() && lengthSquaredX <= std::numeric_limits<float>::max()) {
+        return Vector4(vectorMultiply(v, vectorReciprocalSqrt(lengthSquared)));
+      }
+      // Zero, subnormal, overflowed or non-finite: rescale through the shared scalar path.
+      alignas(16) float components[4] = { x, y, z, w };
+      float scale;
+      if (!EngineUtilities::unitLengthScale(components, 4, lengthSquaredX, scale)) {
         return Vector4(0, 0, 0, 0);
       }
-      return Vector4(x / mag, y / mag, z / mag, w / mag);
+      return Vector4(vectorMultiply(vectorLoadAligned(components), vectorReplicate(scale)));
     }
   };
 }
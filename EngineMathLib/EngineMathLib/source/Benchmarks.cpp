@@ -0,0 +1,1862 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Matrix/Matrix2x2.h"
+#include "Matrix/Matrix3x3.h"
+#include "Matrix/Matrix4x4.h"
+#include "Memory/TLinearArena.h"
+#include "Memory/TObjectPool.h"
+#include "Memory/TRefPtr.h"
+#include "Memory/TSharedPointer.h"
+#include "Memory/TUniquePtr.h"
+#include "Memory/TWeakPointer.h"
+#include "Structures/Sort.h"
+#include "Structures/TArray.h"
+#include "Structures/TConcurrentMap.h"
+#include "Structures/THandlePool.h"
+#include "Structures/TInlineArray.h"
+#include "Structures/TMap.h"
+#include "Structures/TSortedMap.h"
+#include "Threading/ParallelFor.h"
+#include "Threading/ParallelSort.h"
+#include "Utilities/CPUFeatures.h"
+#include "Utilities/EngineMath.h"
+#include "Vectors/Quaternion.h"
+#include "Vectors/TVector3Stream.h"
+#include "Vectors/Vector2.h"
+#include "Vectors/Vector3.h"
+#include "Vectors/Vector4.h"
+
+/**
+ * @brief Resultado de medir una operacin.
+ */
+struct FMeasurement
+{
+  double RealNs;       ///< Tiempo real medio por repeticin, en nanosegundos.
+  double CpuNs;        ///< Tiempo de CPU del proceso (todos sus hilos) por repeticin, en nanosegundos.
+  int64_t Iterations;  ///< Nmero de repeticiones medidas.
+};
+
+/**
+ * @brief Una lnea del informe: una medicin de tiempo o una mtrica (precisin, errores...).
+ */
+struct FBenchmarkResult
+{
+  std::string Name;
+  FMeasurement Measurement;
+  bool bIsMetric;      ///< Si es true, Value y Unit sustituyen a los tiempos.
+  double Value;
+  std::string Unit;
+};
+
+// Resultados acumulados para la salida JSON.
+std::vector<FBenchmarkResult> GResults;
+
+/**
+ * @brief Mide el tiempo medio (en nanosegundos) de ejecutar Func Iterations veces.
+ *
+ * @param Iterations Nmero de repeticiones.
+ * @param Func Funcin a medir.
+ * @return Tiempo real y de CPU medios por repeticin.
+ */
+template<typename Fn>
+FMeasurement Measure(int Iterations, Fn&& Func)
+{
+  std::clock_t CpuStart = std::clock();
+  auto Start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < Iterations; ++i)
+  {
+    Func();
+  }
+  auto End = std::chrono::high_resolution_clock::now();
+  std::clock_t CpuEnd = std::clock();
+  double RealNs = std::chrono::duration<double, std::nano>(End - Start).count();
+  double CpuNs = static_cast<double>(CpuEnd - CpuStart) * 1e9 / CLOCKS_PER_SEC;
+  return FMeasurement{ RealNs / Iterations, CpuNs / Iterations, Iterations };
+}
+
+/**
+ * @brief Reparte una medicin entre las Operations operaciones que hizo cada repeticin.
+ */
+FMeasurement PerOperation(const FMeasurement& Measurement, double Operations)
+{
+  return FMeasurement{ Measurement.RealNs / Operations, Measurement.CpuNs / Operations,
+    static_cast<int64_t>(Measurement.Iterations * Operations) };
+}
+
+/**
+ * @brief Imprime y guarda una lnea de resultados de benchmark.
+ */
+void Report(const char* Name, const FMeasurement& Measurement)
+{
+  if (Measurement.RealNs >= 1000.0)
+  {
+    std::cout << Name << ": " << Measurement.RealNs / 1000.0 << " us" << std::endl;
+  }
+  else
+  {
+    std::cout << Name << ": " << Measurement.RealNs << " ns" << std::endl;
+  }
+  GResults.push_back(FBenchmarkResult{ Name, Measurement, false, 0.0, "" });
+}
+
+void Report(const std::string& Name, const FMeasurement& Measurement)
+{
+  Report(Name.c_str(), Measurement);
+}
+
+/**
+ * @brief Imprime y guarda una mtrica que no es un tiempo (por ejemplo el error en ULPs).
+ */
+void ReportMetric(const char* Name, double Value, const char* Unit)
+{
+  std::cout << Name << ": " << Value << " " << Unit << std::endl;
+  GResults.push_back(FBenchmarkResult{ Name, FMeasurement{ 0.0, 0.0, 0 }, true, Value, Unit });
+}
+
+// Evita que el optimizador elimine el trabajo medido.
+volatile size_t GSink = 0;
+
+// Igual que GSink para los benchmarks con varios hilos: cada hilo acumula en una variable
+// local y la suma aqu una sola vez al terminar, sin compartir una lnea de cach al medir.
+std::atomic<size_t> GThreadSink{ 0 };
+
+/**
+ * @brief Nmero de bloques pedidos por FCountingHeapAllocator (para contar reservas evitadas).
+ */
+size_t GHeapAllocations = 0;
+
+/**
+ * @brief FHeapAllocator que cuenta los bloques nuevos que reserva.
+ */
+struct FCountingHeapAllocator : public EngineUtilities::FHeapAllocator
+{
+  void* Allocate(size_t Bytes, size_t Alignment)
+  {
+    ++GHeapAllocations;
+    return FHeapAllocator::Allocate(Bytes, Alignment);
+  }
+
+  void* Reallocate(void* Block, size_t OldBytes, size_t NewBytes, size_t Alignment)
+  {
+    ++GHeapAllocations;
+    return FHeapAllocator::Reallocate(Block, OldBytes, NewBytes, Alignment);
+  }
+};
+
+/**
+ * @brief Coste de crecer un TArray frente a std::vector sin reservar capacidad.
+ */
+void BenchArrayGrowth()
+{
+  const int Count = 100000;
+  const int Iterations = 20;
+
+  Report("TArray<int>::Add x100k", Measure(Iterations, [&]() {
+    EngineUtilities::TArray<int> Array;
+    for (int i = 0; i < Count; ++i) Array.Add(i);
+    GSink += Array.Num();
+  }));
+  Report("std::vector<int>::push_back x100k", Measure(Iterations, [&]() {
+    std::vector<int> Vector;
+    for (int i = 0; i < Count; ++i) Vector.push_back(i);
+    GSink += Vector.size();
+  }));
+
+  const std::string Name = "StaticMesh_Environment_Rock_LOD0";
+  Report("TArray<std::string>::Add x100k", Measure(Iterations, [&]() {
+    EngineUtilities::TArray<std::string> Array;
+    for (int i = 0; i < Count; ++i) Array.Add(Name);
+    GSink += Array.Num();
+  }));
+  Report("std::vector<std::string>::push_back x100k", Measure(Iterations, [&]() {
+    std::vector<std::string> Vector;
+    for (int i = 0; i < Count; ++i) Vector.push_back(Name);
+    GSink += Vector.size();
+  }));
+  Report("TArray<std::string>::Emplace x100k", Measure(Iterations, [&]() {
+    EngineUtilities::TArray<std::string> Array;
+    for (int i = 0; i < Count; ++i) Array.Emplace(32, 'x');
+    GSink += Array.Num();
+  }));
+  Report("std::vector<std::string>::emplace_back x100k", Measure(Iterations, [&]() {
+    std::vector<std::string> Vector;
+    for (int i = 0; i < Count; ++i) Vector.emplace_back(32, 'x');
+    GSink += Vector.size();
+  }));
+
+  // Arrays grandes de elementos trivialmente reubicables: TArray crece con realloc (mremap en glibc).
+  const int LargeCount = 1 << 23;
+  Report("TArray<uint64_t>::Add x8M", Measure(3, [&]() {
+    EngineUtilities::TArray<uint64_t> Array;
+    for (int i = 0; i < LargeCount; ++i) Array.Add(static_cast<uint64_t>(i));
+    GSink += Array.Num();
+  }));
+  Report("std::vector<uint64_t>::push_back x8M", Measure(3, [&]() {
+    std::vector<uint64_t> Vector;
+    for (int i = 0; i < LargeCount; ++i) Vector.push_back(static_cast<uint64_t>(i));
+    GSink += Vector.size();
+  }));
+}
+
+/**
+ * @brief Vaciado de un TArray de 20k enteros quitando por delante y por detrs, frente a std::vector,
+ *        filtrado en bloque y reconstruccin de listas por frame.
+ */
+void BenchArrayRemoveAt()
+{
+  const int Count = 20000;
+  const int Iterations = 5;
+
+  Report("TArray<int>::RemoveAt(0) x20k", Measure(Iterations, [&]() {
+    EngineUtilities::TArray<int> Array;
+    for (int i = 0; i < Count; ++i) Array.Add(i);
+    while (Array.Num() > 0) Array.RemoveAt(0);
+    GSink += Array.GetCapacity();
+  }));
+  Report("std::vector<int>::erase(begin) x20k", Measure(Iterations, [&]() {
+    std::vector<int> Vector;
+    for (int i = 0; i < Count; ++i) Vector.push_back(i);
+    while (!Vector.empty()) Vector.erase(Vector.begin());
+    GSink += Vector.capacity();
+  }));
+  Report("TArray<int>::RemoveAt(Num - 1) x20k", Measure(Iterations, [&]() {
+    EngineUtilities::TArray<int> Array;
+    for (int i = 0; i < Count; ++i) Array.Add(i);
+    while (Array.Num() > 0) Array.RemoveAt(Array.Num() - 1);
+    GSink += Array.GetCapacity();
+  }));
+  Report("std::vector<int>::pop_back x20k", Measure(Iterations, [&]() {
+    std::vector<int> Vector;
+    for (int i = 0; i < Count; ++i) Vector.push_back(i);
+    while (!Vector.empty()) Vector.pop_back();
+    GSink += Vector.capacity();
+  }));
+  Report("TArray<int>::RemoveAtSwap(0) x20k", Measure(Iterations, [&]() {
+    EngineUtilities::TArray<int> Array;
+    for (int i = 0; i < Count; ++i) Array.Add(i);
+    while (Array.Num() > 0) Array.RemoveAtSwap(0);
+    GSink += Array.GetCapacity();
+  }));
+
+  // Filtrado de una lista grande: una pasada de compactacin frente a borrar uno a uno.
+  const int FilterCount = 1000000;
+  EngineUtilities::TArray<int> Source;
+  std::vector<int> SourceVector;
+  for (int i = 0; i < FilterCount; ++i)
+  {
+    Source.Add((i % 1000) * 7919 % 1000);
+    SourceVector.push_back((i % 1000) * 7919 % 1000);
+  }
+  Report("TArray<int>::RemoveAllMatching 1M (50%)", Measure(Iterations, [&]() {
+    EngineUtilities::TArray<int> Array(Source);
+    GSink += Array.RemoveAllMatching([](int Value) { return Value < 500; });
+  }));
+  Report("std::vector<int> remove_if+erase 1M (50%)", Measure(Iterations, [&]() {
+    std::vector<int> Vector(SourceVector);
+    Vector.erase(std::remove_if(Vector.begin(), Vector.end(), [](int Value) { return Value < 500; }), Vector.end());
+    GSink += Vector.size();
+  }));
+
+  // Lista de visibles reconstruida cada frame: conservar la capacidad evita todas las reservas.
+  const int Frames = 100;
+  const int Visible = 10000;
+  Report("Culling list rebuild x100 frames (new TArray)", Measure(Iterations, [&]() {
+    for (int Frame = 0; Frame < Frames; ++Frame)
+    {
+      EngineUtilities::TArray<int> List;
+      for (int i = 0; i < Visible; ++i) List.Add(i);
+      GSink += List.Num();
+    }
+  }));
+  Report("Culling list rebuild x100 frames (Empty(true))", Measure(Iterations, [&]() {
+    EngineUtilities::TArray<int> List;
+    for (int Frame = 0; Frame < Frames; ++Frame)
+    {
+      List.Empty(true);
+      for (int i = 0; i < Visible; ++i) List.Add(i);
+      GSink += List.Num();
+    }
+  }));
+
+  GHeapAllocations = 0;
+  for (int Frame = 0; Frame < Frames; ++Frame)
+  {
+    EngineUtilities::TArray<int, FCountingHeapAllocator> List;
+    for (int i = 0; i < Visible; ++i) List.Add(i);
+  }
+  ReportMetric("Culling list allocations per frame (new TArray)", static_cast<double>(GHeapAllocations) / Frames, "allocations");
+  GHeapAllocations = 0;
+  {
+    EngineUtilities::TArray<int, FCountingHeapAllocator> List;
+    for (int Frame = 0; Frame < Frames; ++Frame)
+    {
+      List.Empty(true);
+      for (int i = 0; i < Visible; ++i) List.Add(i);
+    }
+  }
+  ReportMetric("Culling list allocations per frame (Empty(true))", static_cast<double>(GHeapAllocations) / Frames, "allocations");
+}
+
+/**
+ * @brief Bucles sobre los elementos de un TArray (ndice, for por rango, std::sort) frente a
+ *        std::vector. Sin la comprobacin de lmites el compilador puede vectorizarlos.
+ */
+void BenchArrayAccess()
+{
+  const int Count = 1 << 20;
+  const int Iterations = 20;
+  EngineUtilities::TArray<float> Array;
+  std::vector<float> Vector;
+  for (int i = 0; i < Count; ++i)
+  {
+    Array.Add(static_cast<float>(i % 1024) * 0.5f);
+    Vector.push_back(static_cast<float>(i % 1024) * 0.5f);
+  }
+
+  Report("TArray<float> scale operator[] x1M", Measure(Iterations, [&]() {
+    size_t Num = Array.Num();
+    for (size_t i = 0; i < Num; ++i) Array[i] = Array[i] * 0.999f + 0.25f;
+    GSink += static_cast<size_t>(Array[Num - 1]);
+  }));
+  Report("TArray<float> scale range-for x1M", Measure(Iterations, [&]() {
+    for (float& Value : Array) Value = Value * 0.999f + 0.25f;
+    GSink += static_cast<size_t>(Array[0]);
+  }));
+  Report("std::vector<float> scale operator[] x1M", Measure(Iterations, [&]() {
+    size_t Num = Vector.size();
+    for (size_t i = 0; i < Num; ++i) Vector[i] = Vector[i] * 0.999f + 0.25f;
+    GSink += static_cast<size_t>(Vector[Num - 1]);
+  }));
+
+  EngineUtilities::TArray<int> Keys;
+  std::vector<int> VectorKeys;
+  for (int i = 0; i < Count; ++i)
+  {
+    int Key = static_cast<int>((static_cast<uint32_t>(i) * 2654435761u) >> 8);
+    Keys.Add(Key);
+    VectorKeys.push_back(Key);
+  }
+  Report("std::sort TArray<int> x1M", Measure(5, [&]() {
+    EngineUtilities::TArray<int> Sorted(Keys);
+    std::sort(Sorted.begin(), Sorted.end());
+    GSink += static_cast<size_t>(Sorted[0]);
+  }));
+  Report("std::sort std::vector<int> x1M", Measure(5, [&]() {
+    std::vector<int> Sorted(VectorKeys);
+    std::sort(Sorted.begin(), Sorted.end());
+    GSink += static_cast<size_t>(Sorted[0]);
+  }));
+}
+
+/**
+ * @brief Listas cortas (hijos de un nodo, slots de material): TInlineArray frente a TArray y
+ *        std::vector, con el nmero de reservas por lista.
+ */
+void BenchInlineArray()
+{
+  using namespace EngineUtilities;
+  const int Lists = 100000;
+  const int Iterations = 10;
+
+  for (int Length : { 2, 6, 12 })
+  {
+    std::string Suffix = " x100k len:" + std::to_string(Length);
+    Report("TArray<int> list" + Suffix, Measure(Iterations, [&]() {
+      for (int l = 0; l < Lists; ++l)
+      {
+        TArray<int> List;
+        for (int i = 0; i < Length; ++i) List.Add(i);
+        GSink += List.Num();
+      }
+    }));
+    Report("std::vector<int> list" + Suffix, Measure(Iterations, [&]() {
+      for (int l = 0; l < Lists; ++l)
+      {
+        std::vector<int> List;
+        for (int i = 0; i < Length; ++i) List.push_back(i);
+        GSink += List.size();
+      }
+    }));
+    Report("TInlineArray<int, 8> list" + Suffix, Measure(Iterations, [&]() {
+      for (int l = 0; l < Lists; ++l)
+      {
+        TInlineArray<int, 8> List;
+        for (int i = 0; i < Length; ++i) List.Add(i);
+        GSink += List.Num();
+      }
+    }));
+
+    GHeapAllocations = 0;
+    {
+      TArray<int, FCountingHeapAllocator> List;
+      for (int i = 0; i < Length; ++i) List.Add(i);
+    }
+    std::string ArrayMetric = "TArray<int> allocations per list len:" + std::to_string(Length);
+    ReportMetric(ArrayMetric.c_str(), static_cast<double>(GHeapAllocations), "allocations");
+    GHeapAllocations = 0;
+    {
+      TInlineArray<int, 8, FCountingHeapAllocator> List;
+      for (int i = 0; i < Length; ++i) List.Add(i);
+    }
+    std::string InlineMetric = "TInlineArray<int, 8> allocations per list len:" + std::to_string(Length);
+    ReportMetric(InlineMetric.c_str(), static_cast<double>(GHeapAllocations), "allocations");
+  }
+}
+
+/**
+ * @brief Insercin y bsqueda de 50k claves enteras en TMap frente a std::unordered_map.
+ */
+void BenchMapLookup()
+{
+  const int Count = 50000;
+  const int Iterations = 10;
+
+  EngineUtilities::TMap<int, int> Map;
+  std::unordered_map<int, int> StdMap;
+  Report("TMap<int, int>::Add x50k", Measure(Iterations, [&]() {
+    EngineUtilities::TMap<int, int> Local;
+    for (int i = 0; i < Count; ++i) Local.Add(i * 7919, i);
+    GSink += Local.Num();
+  }));
+  Report("std::unordered_map<int, int>::insert x50k", Measure(Iterations, [&]() {
+    std::unordered_map<int, int> Local;
+    for (int i = 0; i < Count; ++i) Local[i * 7919] = i;
+    GSink += Local.size();
+  }));
+
+  for (int i = 0; i < Count; ++i)
+  {
+    Map.Add(i * 7919, i);
+    StdMap[i * 7919] = i;
+  }
+  Report("TMap<int, int>::operator[] x50k", Measure(Iterations, [&]() {
+    size_t Sum = 0;
+    for (int i = 0; i < Count; ++i) Sum += Map[i * 7919];
+    GSink += Sum;
+  }));
+  Report("std::unordered_map<int, int>::find x50k", Measure(Iterations, [&]() {
+    size_t Sum = 0;
+    for (int i = 0; i < Count; ++i) Sum += StdMap.find(i * 7919)->second;
+    GSink += Sum;
+  }));
+}
+
+/**
+ * @brief Consultas aleatorias en TSortedMap (orden plano y de Eytzinger) frente a TMap y
+ *        std::lower_bound, y construccin con BuildFrom frente a Add uno a uno.
+ */
+void BenchSortedMap()
+{
+  using namespace EngineUtilities;
+  const int Iterations = 10;
+  const size_t Lookups = 1000000;
+
+  for (size_t Count : { size_t(1000), size_t(1000000) })
+  {
+    TArray<TPair<uint32_t, uint32_t>> Pairs;
+    TArray<uint32_t> Queries;
+    uint32_t State = 12345;
+    for (size_t i = 0; i < Count; ++i)
+    {
+      State = State * 1664525u + 1013904223u;
+      Pairs.Add(TPair<uint32_t, uint32_t>(State, static_cast<uint32_t>(i)));
+    }
+    for (size_t i = 0; i < Lookups; ++i)
+    {
+      State = State * 1664525u + 1013904223u;
+      Queries.Add(Pairs[State % Count].Key);
+    }
+
+    TMap<uint32_t, uint32_t> Map;
+    for (const TPair<uint32_t, uint32_t>& Pair : Pairs) Map.Add(Pair.Key, Pair.Value);
+    TSortedMap<uint32_t, uint32_t> Sorted;
+    Sorted.BuildFrom(TArray<TPair<uint32_t, uint32_t>>(Pairs));
+    TSortedMap<uint32_t, uint32_t, ESortedMapLayout::Eytzinger> Eytzinger;
+    Eytzinger.BuildFrom(TArray<TPair<uint32_t, uint32_t>>(Pairs));
+    TArray<TPair<uint32_t, uint32_t>> Plain(Pairs);
+    Sort(Plain, [](const TPair<uint32_t, uint32_t>& A, const TPair<uint32_t, uint32_t>& B) { return A.Key < B.Key; });
+
+    std::string Suffix = " x1M in " + std::to_string(Count / 1000) + "k";
+    Report("TMap::Find" + Suffix, Measure(Iterations, [&]() {
+      size_t Sum = 0;
+      for (uint32_t Key : Queries) Sum += *Map.Find(Key);
+      GSink = GSink + Sum;
+    }));
+    Report("std::lower_bound" + Suffix, Measure(Iterations, [&]() {
+      size_t Sum = 0;
+      for (uint32_t Key : Queries)
+      {
+        Sum += std::lower_bound(Plain.begin(), Plain.end(), Key,
+          [](const TPair<uint32_t, uint32_t>& Pair, uint32_t Value) { return Pair.Key < Value; })->Value;
+      }
+      GSink = GSink + Sum;
+    }));
+    Report("TSortedMap::Find" + Suffix, Measure(Iterations, [&]() {
+      size_t Sum = 0;
+      for (uint32_t Key : Queries) Sum += *Sorted.Find(Key);
+      GSink = GSink + Sum;
+    }));
+    Report("TSortedMap<Eytzinger>::Find" + Suffix, Measure(Iterations, [&]() {
+      size_t Sum = 0;
+      for (uint32_t Key : Queries) Sum += *Eytzinger.Find(Key);
+      GSink = GSink + Sum;
+    }));
+  }
+
+  const size_t BuildCount = 20000;
+  TArray<TPair<int, int>> Unsorted;
+  for (size_t i = 0; i < BuildCount; ++i)
+  {
+    int Key = static_cast<int>((i % 1000) * 7919 % 1000 * 1000 + i / 1000);
+    Unsorted.Add(TPair<int, int>(Key, static_cast<int>(i)));
+  }
+  Report("TSortedMap::Add x20k", Measure(Iterations, [&]() {
+    TSortedMap<int, int> Local;
+    for (const TPair<int, int>& Pair : Unsorted) Local.Add(Pair.Key, Pair.Value);
+    GSink = GSink + Local.Num();
+  }));
+  Report("TSortedMap::BuildFrom x20k", Measure(Iterations, [&]() {
+    TSortedMap<int, int> Local;
+    Local.BuildFrom(TArray<TPair<int, int>>(Unsorted));
+    GSink = GSink + Local.Num();
+  }));
+}
+
+/**
+ * @brief Ejecuta Func(ThreadIndex) en Threads hilos y devuelve el tiempo total (real y de CPU).
+ */
+template<typename Fn>
+FMeasurement MeasureThreads(int Threads, Fn&& Func)
+{
+  std::vector<std::thread> Workers;
+  std::clock_t CpuStart = std::clock();
+  auto Start = std::chrono::high_resolution_clock::now();
+  for (int t = 0; t < Threads; ++t)
+  {
+    Workers.emplace_back([&Func, t]() { Func(t); });
+  }
+  for (std::thread& Worker : Workers)
+  {
+    Worker.join();
+  }
+  auto End = std::chrono::high_resolution_clock::now();
+  std::clock_t CpuEnd = std::clock();
+  return FMeasurement{ std::chrono::duration<double, std::nano>(End - Start).count(),
+    static_cast<double>(CpuEnd - CpuStart) * 1e9 / CLOCKS_PER_SEC, 1 };
+}
+
+/**
+ * @brief Copia y destruye Copies veces un puntero compartido.
+ */
+template<typename SharedType>
+void CopyLoop(const SharedType& Source, int Copies)
+{
+  size_t Alive = 0;
+  for (int i = 0; i < Copies; ++i)
+  {
+    SharedType Copy(Source);
+    Alive += Copy.isNull() ? 0 : 1;
+  }
+  GThreadSink.fetch_add(Alive, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Coste de copiar un TSharedPointer en cada modo con 1 a 64 hilos.
+ *
+ * "shared" hace que todos los hilos copien el mismo puntero (contencin sobre el contador);
+ * "private" da a cada hilo su propio objeto. El modo NotThreadSafe slo se mide en privado,
+ * ya que compartirlo entre hilos sera una carrera de datos.
+ */
+void BenchSharedPointerContention()
+{
+  using namespace EngineUtilities;
+  const int Copies = 200000;
+
+  for (int Threads = 1; Threads <= 64; Threads *= 2)
+  {
+    TSharedPointer<int, ESPMode::ThreadSafe> Shared = MakeShared<int, ESPMode::ThreadSafe>(1);
+    FMeasurement SharedTime = MeasureThreads(Threads, [&](int) { CopyLoop(Shared, Copies); });
+
+    std::vector<TSharedPointer<int, ESPMode::ThreadSafe>> AtomicPrivate;
+    std::vector<TSharedPointer<int, ESPMode::NotThreadSafe>> PlainPrivate;
+    for (int t = 0; t < Threads; ++t)
+    {
+      AtomicPrivate.push_back(MakeShared<int, ESPMode::ThreadSafe>(t));
+      PlainPrivate.push_back(MakeShared<int, ESPMode::NotThreadSafe>(t));
+    }
+    FMeasurement AtomicTime = MeasureThreads(Threads, [&](int t) { CopyLoop(AtomicPrivate[t], Copies); });
+    FMeasurement PlainTime = MeasureThreads(Threads, [&](int t) { CopyLoop(PlainPrivate[t], Copies); });
+
+    double PerCopy = static_cast<double>(Copies) * Threads;
+    std::string Suffix = "/threads:" + std::to_string(Threads);
+    Report("TSharedPointer copy ThreadSafe shared" + Suffix, PerOperation(SharedTime, PerCopy));
+    Report("TSharedPointer copy ThreadSafe private" + Suffix, PerOperation(AtomicTime, PerCopy));
+    Report("TSharedPointer copy NotThreadSafe private" + Suffix, PerOperation(PlainTime, PerCopy));
+  }
+}
+
+/**
+ * @brief Registro compartido con mezcla de lecturas y escrituras: TConcurrentMap frente a un
+ *        TMap protegido por un nico std::mutex, de 1 a 32 hilos.
+ *
+ * Las escrituras alternan FindOrAdd y Remove sobre claves al azar, as que el tamao del
+ * mapa se mantiene estable durante la medida.
+ */
+void BenchConcurrentMap()
+{
+  using namespace EngineUtilities;
+  const int OpsPerThread = 100000;
+  const uint32_t KeySpace = 1 << 16;
+
+  for (int ReadPercent : { 95, 50 })
+  {
+    for (int Threads = 1; Threads <= 32; Threads *= 2)
+    {
+      TConcurrentMap<uint32_t, uint32_t> Sharded;
+      TMap<uint32_t, uint32_t> Locked;
+      std::mutex LockedMutex;
+      for (uint32_t Key = 0; Key < KeySpace; Key += 2)
+      {
+        Sharded.Add(Key, Key);
+        Locked.Add(Key, Key);
+      }
+
+      // Cada hilo recorre su propia secuencia pseudoaleatoria de operaciones y acumula sus
+      // resultados en local; slo al final los publica en GThreadSink.
+      auto RunOps = [&](int t, auto&& Read, auto&& Write, auto&& Erase) {
+        uint32_t State = 0x9E3779B9u * static_cast<uint32_t>(t + 1);
+        size_t Sum = 0;
+        for (int i = 0; i < OpsPerThread; ++i)
+        {
+          State ^= State << 13;
+          State ^= State >> 17;
+          State ^= State << 5;
+          uint32_t Key = State % KeySpace;
+          if (static_cast<int>((State >> 16) % 100) < ReadPercent)
+          {
+            Sum += Read(Key) ? 1 : 0;
+          }
+          else if (i & 1)
+          {
+            Sum += Write(Key);
+          }
+          else
+          {
+            Erase(Key);
+          }
+        }
+        GThreadSink.fetch_add(Sum, std::memory_order_relaxed);
+      };
+
+      FMeasurement ShardedTime = MeasureThreads(Threads, [&](int t) {
+        RunOps(t,
+          [&](uint32_t Key) { uint32_t Value; return Sharded.TryGet(Key, Value); },
+          [&](uint32_t Key) { return Sharded.FindOrAdd(Key, Key); },
+          [&](uint32_t Key) { Sharded.Remove(Key); });
+      });
+      FMeasurement LockedTime = MeasureThreads(Threads, [&](int t) {
+        RunOps(t,
+          [&](uint32_t Key) { std::lock_guard<std::mutex> Lock(LockedMutex); return Locked.Find(Key) != nullptr; },
+          [&](uint32_t Key) {
+            std::lock_guard<std::mutex> Lock(LockedMutex);
+            if (!Locked.Contains(Key)) Locked.Add(Key, Key);
+            return *Locked.Find(Key);
+          },
+          [&](uint32_t Key) {
+            std::lock_guard<std::mutex> Lock(LockedMutex);
+            if (Locked.Contains(Key)) Locked.Remove(Key);
+          });
+      });
+
+      double Ops = static_cast<double>(OpsPerThread) * Threads;
+      std::string Suffix = " reads:" + std::to_string(ReadPercent) + "%/threads:" + std::to_string(Threads);
+      Report("TMap + std::mutex mixed" + Suffix, PerOperation(LockedTime, Ops));
+      Report("TConcurrentMap mixed" + Suffix, PerOperation(ShardedTime, Ops));
+      ReportMetric(("TConcurrentMap speedup" + Suffix).c_str(), LockedTime.RealNs / ShardedTime.RealNs, "x");
+    }
+  }
+}
+
+/**
+ * @brief Coste de crear y destruir 100k objetos compartidos con MakeShared.
+ */
+void BenchMakeShared()
+{
+  using namespace EngineUtilities;
+  struct Particle
+  {
+    float Position[3];
+    float Velocity[3];
+    Particle(float X, float Y, float Z) : Position{ X, Y, Z }, Velocity{ 0.0f, 0.0f, 0.0f } {}
+  };
+  const int Count = 100000;
+  const int Iterations = 10;
+
+  Report("MakeShared<Particle> x100k", Measure(Iterations, [&]() {
+    for (int i = 0; i < Count; ++i)
+    {
+      TSharedPointer<Particle> Object = MakeShared<Particle>(1.0f, 2.0f, 3.0f);
+      GSink += Object.isNull() ? 0 : 1;
+    }
+  }));
+  Report("TSharedPointer<Particle>(new Particle) x100k", Measure(Iterations, [&]() {
+    for (int i = 0; i < Count; ++i)
+    {
+      TSharedPointer<Particle> Object(new Particle(1.0f, 2.0f, 3.0f));
+      GSink += Object.isNull() ? 0 : 1;
+    }
+  }));
+  Report("std::make_shared<Particle> x100k", Measure(Iterations, [&]() {
+    for (int i = 0; i < Count; ++i)
+    {
+      std::shared_ptr<Particle> Object = std::make_shared<Particle>(1.0f, 2.0f, 3.0f);
+      GSink += Object ? 1 : 0;
+    }
+  }));
+}
+
+/**
+ * @brief Objeto con recuento intrusivo para medir TRefPtr.
+ */
+struct FRefCountedValue : public EngineUtilities::TRefCounted
+{
+  int Value = 1;
+};
+
+/**
+ * @brief Coste de copiar (o mover) cada tipo de puntero inteligente en un solo hilo.
+ */
+void BenchSmartPointerCopy()
+{
+  using namespace EngineUtilities;
+  const int Copies = 1000000;
+  const int Iterations = 5;
+
+  TSharedPointer<int, ESPMode::ThreadSafe> AtomicShared = MakeShared<int, ESPMode::ThreadSafe>(1);
+  TSharedPointer<int, ESPMode::NotThreadSafe> PlainShared = MakeShared<int, ESPMode::NotThreadSafe>(1);
+  std::shared_ptr<int> StdShared = std::make_shared<int>(1);
+  TWeakPointer<int, ESPMode::ThreadSafe> Weak(AtomicShared);
+  TRefPtr<FRefCountedValue> Ref = MakeRefCounted<FRefCountedValue>();
+
+  Report("TSharedPointer<ThreadSafe> copy", PerOperation(Measure(Iterations, [&]() { CopyLoop(AtomicShared, Copies); }), Copies));
+  Report("TSharedPointer<NotThreadSafe> copy", PerOperation(Measure(Iterations, [&]() { CopyLoop(PlainShared, Copies); }), Copies));
+  Report("std::shared_ptr copy", PerOperation(Measure(Iterations, [&]() {
+    for (int i = 0; i < Copies; ++i)
+    {
+      std::shared_ptr<int> Copy(StdShared);
+      GSink += Copy ? 1 : 0;
+    }
+  }), Copies));
+  Report("TWeakPointer copy", PerOperation(Measure(Iterations, [&]() {
+    for (int i = 0; i < Copies; ++i)
+    {
+      TWeakPointer<int, ESPMode::ThreadSafe> Copy(Weak);
+      GSink += Copy.isExpired() ? 0 : 1;
+    }
+  }), Copies));
+  Report("TWeakPointer::lock", PerOperation(Measure(Iterations, [&]() {
+    for (int i = 0; i < Copies; ++i)
+    {
+      TSharedPointer<int, ESPMode::ThreadSafe> Locked = Weak.lock();
+      GSink += Locked.isNull() ? 0 : 1;
+    }
+  }), Copies));
+  Report("TRefPtr copy", PerOperation(Measure(Iterations, [&]() {
+    for (int i = 0; i < Copies; ++i)
+    {
+      TRefPtr<FRefCountedValue> Copy(Ref);
+      GSink += Copy.get() != nullptr ? 1 : 0;
+    }
+  }), Copies));
+  TUniquePtr<int> Unique = MakeUnique<int>(1);
+  Report("TUniquePtr move", PerOperation(Measure(Iterations, [&]() {
+    for (int i = 0; i < Copies; ++i)
+    {
+      TUniquePtr<int> Moved(std::move(Unique));
+      GSink += Unique.get() == nullptr ? 1 : 0;
+      Unique = std::move(Moved);
+    }
+  }), Copies));
+}
+
+/**
+ * @brief Temporales de un frame: arena lineal frente a new/delete y al heap de los contenedores.
+ */
+void BenchLinearArena()
+{
+  using namespace EngineUtilities;
+  struct Particle
+  {
+    float Position[3];
+    float Velocity[3];
+    Particle(float X, float Y, float Z) : Position{ X, Y, Z }, Velocity{ 0.0f, 0.0f, 0.0f } {}
+  };
+  using FArenaAllocator = TArenaAllocator<TLinearArena<>>;
+  const int Count = 100000;
+  const int Frames = 20;
+
+  // Un "frame" reserva Count objetos pequeos y los suelta todos al final.
+  std::vector<Particle*> Objects(Count);
+  Report("Frame temporaries new/delete x100k", Measure(Frames, [&]() {
+    for (int i = 0; i < Count; ++i)
+    {
+      Objects[i] = new Particle(float(i), 2.0f, 3.0f);
+    }
+    for (int i = 0; i < Count; ++i)
+    {
+      GSink += static_cast<size_t>(Objects[i]->Position[0]);
+      delete Objects[i];
+    }
+  }));
+  TFrameAllocator<> FrameAllocator(1024 * 1024);
+  Report("Frame temporaries TFrameAllocator x100k", Measure(Frames, [&]() {
+    FrameAllocator.BeginFrame();
+    for (int i = 0; i < Count; ++i)
+    {
+      Objects[i] = FrameAllocator.New<Particle>(float(i), 2.0f, 3.0f);
+    }
+    for (int i = 0; i < Count; ++i)
+    {
+      GSink += static_cast<size_t>(Objects[i]->Position[0]);
+    }
+  }));
+
+  // Arrays temporales que crecen desde vacos: en el arena la ltima reserva crece en su sitio.
+  const int ArrayCount = 1000;
+  const int ArrayLength = 256;
+  Report("Scratch TArray<int> x1000 heap", Measure(Frames, [&]() {
+    for (int a = 0; a < ArrayCount; ++a)
+    {
+      TArray<int> Scratch;
+      for (int i = 0; i < ArrayLength; ++i)
+      {
+        Scratch.Add(i);
+      }
+      GSink += Scratch.Num();
+    }
+  }));
+  TLinearArena<> Arena(1024 * 1024);
+  Report("Scratch TArray<int> x1000 arena", Measure(Frames, [&]() {
+    Arena.Reset();
+    for (int a = 0; a < ArrayCount; ++a)
+    {
+      TArray<int, FArenaAllocator> Scratch{ FArenaAllocator(Arena) };
+      for (int i = 0; i < ArrayLength; ++i)
+      {
+        Scratch.Add(i);
+      }
+      GSink += Scratch.Num();
+    }
+  }));
+
+  Report("MakeShared<Particle> x100k (heap)", Measure(Frames, [&]() {
+    for (int i = 0; i < Count; ++i)
+    {
+      TSharedPointer<Particle> Object = MakeShared<Particle>(1.0f, 2.0f, 3.0f);
+      GSink += Object.isNull() ? 0 : 1;
+    }
+  }));
+  Report("MakeSharedInArena<Particle> x100k", Measure(Frames, [&]() {
+    Arena.Reset();
+    for (int i = 0; i < Count; ++i)
+    {
+      TSharedPointer<Particle> Object = MakeSharedInArena<Particle>(Arena, 1.0f, 2.0f, 3.0f);
+      GSink += Object.isNull() ? 0 : 1;
+    }
+  }));
+}
+
+/**
+ * @brief Objetos de tamao fijo que se crean y destruyen sin parar: TObjectPool frente al heap,
+ *        en un hilo y con varios hilos (con y sin cachs por hilo).
+ */
+void BenchObjectPool()
+{
+  using namespace EngineUtilities;
+  struct Particle
+  {
+    float Position[3];
+    float Velocity[3];
+    Particle(float X, float Y, float Z) : Position{ X, Y, Z }, Velocity{ 0.0f, 0.0f, 0.0f } {}
+  };
+  const int Count = 100000;
+  const int Live = 64;
+  const int Iterations = 10;
+
+  // Ventana deslizante de Live objetos vivos: cada paso destruye el ms antiguo y crea uno.
+  Report("MakeUnique<Particle> churn x100k", Measure(Iterations, [&]() {
+    TUniquePtr<Particle> Window[Live];
+    for (int i = 0; i < Count; ++i)
+    {
+      Window[i % Live] = MakeUnique<Particle>(float(i), 2.0f, 3.0f);
+      GSink += static_cast<size_t>(Window[i % Live]->Position[0]);
+    }
+  }));
+  TObjectPool<Particle> Pool;
+  Report("MakeUniqueFromPool<Particle> churn x100k", Measure(Iterations, [&]() {
+    TPoolUniquePtr<Particle> Window[Live];
+    for (int i = 0; i < Count; ++i)
+    {
+      Window[i % Live] = MakeUniqueFromPool(Pool, float(i), 2.0f, 3.0f);
+      GSink += static_cast<size_t>(Window[i % Live]->Position[0]);
+    }
+  }));
+  Report("MakeShared<Particle> churn x100k", Measure(Iterations, [&]() {
+    TSharedPointer<Particle> Window[Live];
+    for (int i = 0; i < Count; ++i)
+    {
+      Window[i % Live] = MakeShared<Particle>(float(i), 2.0f, 3.0f);
+      GSink += static_cast<size_t>(Window[i % Live]->Position[0]);
+    }
+  }));
+  TSharedObjectPool<Particle> SharedPool;
+  Report("MakeSharedFromPool<Particle> churn x100k", Measure(Iterations, [&]() {
+    TSharedPointer<Particle> Window[Live];
+    for (int i = 0; i < Count; ++i)
+    {
+      Window[i % Live] = MakeSharedFromPool(SharedPool, float(i), 2.0f, 3.0f);
+      GSink += static_cast<size_t>(Window[i % Live]->Position[0]);
+    }
+  }));
+
+  TObjectPool<Particle> GlobalPool(256, false);
+  for (int Threads = 1; Threads <= 8; Threads *= 2)
+  {
+    std::string Suffix = "/threads:" + std::to_string(Threads);
+    double PerObject = static_cast<double>(Count) * Threads;
+    Report("Particle new/delete churn" + Suffix, PerOperation(MeasureThreads(Threads, [&](int) {
+      Particle* Window[Live] = {};
+      for (int i = 0; i < Count; ++i)
+      {
+        delete Window[i % Live];
+        Window[i % Live] = new Particle(float(i), 2.0f, 3.0f);
+      }
+      for (Particle* Object : Window)
+      {
+        delete Object;
+      }
+    }), PerObject));
+    Report("TObjectPool churn" + Suffix, PerOperation(MeasureThreads(Threads, [&](int) {
+      Particle* Window[Live] = {};
+      for (int i = 0; i < Count; ++i)
+      {
+        Pool.Delete(Window[i % Live]);
+        Window[i % Live] = Pool.New(float(i), 2.0f, 3.0f);
+      }
+      for (Particle* Object : Window)
+      {
+        Pool.Delete(Object);
+      }
+    }), PerObject));
+    Report("TObjectPool churn global list only" + Suffix, PerOperation(MeasureThreads(Threads, [&](int) {
+      Particle* Window[Live] = {};
+      for (int i = 0; i < Count; ++i)
+      {
+        GlobalPool.Delete(Window[i % Live]);
+        Window[i % Live] = GlobalPool.New(float(i), 2.0f, 3.0f);
+      }
+      for (Particle* Object : Window)
+      {
+        GlobalPool.Delete(Object);
+      }
+    }), PerObject));
+  }
+}
+
+/**
+ * @brief Recorrido y acceso a componentes: THandlePool (denso + handles) frente a punteros
+ *        compartidos repartidos por el heap y TWeakPointer::lock.
+ */
+void BenchHandlePool()
+{
+  using namespace EngineUtilities;
+  struct Component
+  {
+    float Position[3];
+    float Velocity[3];
+    Component(float X) : Position{ X, 0.0f, 0.0f }, Velocity{ 1.0f, 2.0f, 3.0f } {}
+  };
+  const int Count = 100000;
+  const int Iterations = 20;
+
+  // Componentes creados con basura intercalada, como tras muchos frames de altas y bajas.
+  THandlePool<Component> Pool;
+  TArray<THandle<Component>> Handles;
+  TArray<TSharedPointer<Component>> Shared;
+  TArray<TWeakPointer<Component>> Weak;
+  std::vector<std::unique_ptr<char[]>> Noise;
+  for (int i = 0; i < Count; ++i)
+  {
+    Handles.Add(Pool.Add(Component(float(i))));
+    Shared.Add(MakeShared<Component>(float(i)));
+    Weak.Add(TWeakPointer<Component>(Shared[i]));
+    Noise.emplace_back(new char[16 + (i * 37) % 200]);
+  }
+
+  const float DeltaTime = 0.016f;
+  auto Integrate = [DeltaTime](Component& Object) {
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+      Object.Position[Axis] += Object.Velocity[Axis] * DeltaTime;
+    }
+  };
+  Report("Update x100k THandlePool::ForEach", Measure(Iterations, [&]() {
+    Pool.ForEach(Integrate);
+    GSink += static_cast<size_t>(Pool[0].Position[0]);
+  }));
+  Report("Update x100k TArray<TSharedPointer>", Measure(Iterations, [&]() {
+    for (int i = 0; i < Count; ++i)
+    {
+      Integrate(*Shared[i]);
+    }
+    GSink += static_cast<size_t>(Shared[0]->Position[0]);
+  }));
+
+  Report("Resolve x100k THandlePool::Get", Measure(Iterations, [&]() {
+    for (int i = 0; i < Count; ++i)
+    {
+      Component* Object = Pool.Get(Handles[i]);
+      GSink += Object != nullptr ? 1 : 0;
+    }
+  }));
+  Report("Resolve x100k TWeakPointer::lock", Measure(Iterations, [&]() {
+    for (int i = 0; i < Count; ++i)
+    {
+      TSharedPointer<Component> Object = Weak[i].lock();
+      GSink += Object.isNull() ? 0 : 1;
+    }
+  }));
+
+  Report("Remove+Add x100k THandlePool", Measure(Iterations, [&]() {
+    for (int i = 0; i < Count; ++i)
+    {
+      Pool.Remove(Handles[i]);
+      Handles[i] = Pool.Add(Component(float(i)));
+    }
+  }));
+}
+
+/**
+ * @brief Distancia en ULPs entre dos floats (con signo).
+ */
+uint32_t UlpDistance(float A, float B)
+{
+  if (A == B)
+  {
+    return 0;
+  }
+  // Convierte signo-magnitud a un orden lineal para que -0 y +0 queden juntos.
+  int64_t BitsA = static_cast<int32_t>(EngineUtilities::floatBits(A));
+  int64_t BitsB = static_cast<int32_t>(EngineUtilities::floatBits(B));
+  if (BitsA < 0) BitsA = static_cast<int64_t>(INT32_MIN) - BitsA;
+  if (BitsB < 0) BitsB = static_cast<int64_t>(INT32_MIN) - BitsB;
+  return static_cast<uint32_t>(BitsA > BitsB ? BitsA - BitsB : BitsB - BitsA);
+}
+
+/**
+ * @brief Precisin de sqrt/rsqrt sobre todo el rango de floats positivos finitos y
+ *        coste frente a std::sqrt y a la normalizacin con divisin.
+ */
+void BenchSqrt()
+{
+  // Recorre los patrones de bits de 0 a FLT_MAX (incluye denormales) con un paso primo.
+  uint32_t MaxSqrtUlp = 0;
+  double MaxRsqrtError = 0.0;
+  for (uint32_t Bits = 0; Bits < 0x7F800000u; Bits += 61)
+  {
+    float Value = EngineUtilities::floatFromBits(Bits);
+    uint32_t Ulp = UlpDistance(EngineUtilities::sqrt(Value), std::sqrt(Value));
+    MaxSqrtUlp = Ulp > MaxSqrtUlp ? Ulp : MaxSqrtUlp;
+    if (Bits != 0)
+    {
+      double Exact = 1.0 / std::sqrt(static_cast<double>(Value));
+      double Error = std::fabs(EngineUtilities::rsqrt(Value) - Exact) / Exact;
+      MaxRsqrtError = Error > MaxRsqrtError ? Error : MaxRsqrtError;
+    }
+  }
+  ReportMetric("sqrt max error vs std::sqrt", MaxSqrtUlp, "ulp");
+  ReportMetric("rsqrt max relative error", MaxRsqrtError, "relative");
+
+  const int Count = 4096;
+  const int Iterations = 2000;
+  std::vector<float> Values(Count);
+  for (int i = 0; i < Count; ++i) Values[i] = 0.001f + static_cast<float>(i) * 37.5f;
+
+  Report("EngineUtilities::sqrt x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += EngineUtilities::sqrt(Values[i]);
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("std::sqrt x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += std::sqrt(Values[i]);
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("EngineUtilities::rsqrt x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += EngineUtilities::rsqrt(Values[i]);
+    GSink = GSink + static_cast<size_t>(Sum * 1000.0f);
+  }));
+  Report("1 / std::sqrt x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += 1.0f / std::sqrt(Values[i]);
+    GSink = GSink + static_cast<size_t>(Sum * 1000.0f);
+  }));
+  Report("Vector3::normalize x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i)
+    {
+      EngineUtilities::Vector3 V(Values[i], 1.0f, Values[Count - 1 - i]);
+      Sum += V.normalize().x;
+    }
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+}
+
+/**
+ * @brief Error mximo en ULPs de sin/cos/sincos frente a la libm y coste frente a std::sin.
+ */
+void BenchSinCos()
+{
+  // Recorre los patrones de bits de 0 al lmite de reduccin, con los dos signos.
+  const uint32_t LimitBits = EngineUtilities::floatBits(EngineUtilities::TRIG_REDUCTION_LIMIT);
+  uint32_t MaxSinUlp = 0;
+  uint32_t MaxCosUlp = 0;
+  size_t SincosMismatches = 0;
+  for (uint32_t Bits = 0; Bits < LimitBits; Bits += 1009)
+  {
+    for (uint32_t Sign = 0; Sign < 2; ++Sign)
+    {
+      float Angle = EngineUtilities::floatFromBits(Bits | (Sign << 31));
+      float Sin = EngineUtilities::sin(Angle);
+      float Cos = EngineUtilities::cos(Angle);
+      uint32_t SinUlp = UlpDistance(Sin, std::sin(Angle));
+      uint32_t CosUlp = UlpDistance(Cos, std::cos(Angle));
+      MaxSinUlp = SinUlp > MaxSinUlp ? SinUlp : MaxSinUlp;
+      MaxCosUlp = CosUlp > MaxCosUlp ? CosUlp : MaxCosUlp;
+
+      float FusedSin, FusedCos;
+      EngineUtilities::sincos(Angle, FusedSin, FusedCos);
+      SincosMismatches += (FusedSin != Sin || FusedCos != Cos) ? 1 : 0;
+    }
+  }
+  ReportMetric("sin max error vs std::sin", MaxSinUlp, "ulp");
+  ReportMetric("cos max error vs std::cos", MaxCosUlp, "ulp");
+  ReportMetric("sincos mismatches vs sin/cos", static_cast<double>(SincosMismatches), "values");
+
+  const int Count = 4096;
+  const int Iterations = 2000;
+  std::vector<float> Angles(Count);
+  for (int i = 0; i < Count; ++i) Angles[i] = -100.0f + static_cast<float>(i) * 0.0491f;
+
+  Report("EngineUtilities::sin x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += EngineUtilities::sin(Angles[i]);
+    GSink = GSink + static_cast<size_t>(Sum * 1000.0f);
+  }));
+  Report("std::sin x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += std::sin(Angles[i]);
+    GSink = GSink + static_cast<size_t>(Sum * 1000.0f);
+  }));
+  Report("EngineUtilities::sincos x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i)
+    {
+      float Sin, Cos;
+      EngineUtilities::sincos(Angles[i], Sin, Cos);
+      Sum += Sin + Cos;
+    }
+    GSink = GSink + static_cast<size_t>(Sum * 1000.0f);
+  }));
+  Report("std::sin + std::cos x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += std::sin(Angles[i]) + std::cos(Angles[i]);
+    GSink = GSink + static_cast<size_t>(Sum * 1000.0f);
+  }));
+}
+
+/**
+ * @brief Error relativo mximo frente a la libm y coste del resto de funciones trascendentes de EngineMath.
+ */
+void BenchTranscendentals()
+{
+  const int Count = 4096;
+  const int Iterations = 500;
+  std::vector<float> Angles(Count), Unit(Count), Positive(Count);
+  for (int i = 0; i < Count; ++i)
+  {
+    Angles[i] = -1.5f + static_cast<float>(i) * (3.0f / Count);
+    Unit[i] = -0.999f + static_cast<float>(i) * (1.998f / Count);
+    Positive[i] = 0.01f + static_cast<float>(i) * 0.005f;
+  }
+
+  // Cada entrada compara una funcin de EngineMath con su equivalente de la libm.
+  struct FCase
+  {
+    const char* Name;
+    const char* StdName;
+    float (*Function)(float);
+    float (*Reference)(float);
+    const std::vector<float>* Inputs;
+  };
+  const FCase Cases[] = {
+    { "EngineUtilities::tan", "std::tan", &EngineUtilities::tan, [](float V) { return std::tan(V); }, &Angles },
+    { "EngineUtilities::asin", "std::asin", &EngineUtilities::asin, [](float V) { return std::asin(V); }, &Unit },
+    { "EngineUtilities::acos", "std::acos", &EngineUtilities::acos, [](float V) { return std::acos(V); }, &Unit },
+    { "EngineUtilities::atan", "std::atan", &EngineUtilities::atan, [](float V) { return std::atan(V); }, &Angles },
+    { "EngineUtilities::exp", "std::exp", &EngineUtilities::exp, [](float V) { return std::exp(V); }, &Angles },
+    { "EngineUtilities::log", "std::log", &EngineUtilities::log, [](float V) { return std::log(V); }, &Positive },
+    { "EngineUtilities::tanh", "std::tanh", &EngineUtilities::tanh, [](float V) { return std::tanh(V); }, &Angles },
+  };
+
+  for (const FCase& Case : Cases)
+  {
+    const std::vector<float>& Inputs = *Case.Inputs;
+    double MaxError = 0.0;
+    for (int i = 0; i < Count; ++i)
+    {
+      double Exact = Case.Reference(Inputs[i]);
+      double Error = std::fabs(Case.Function(Inputs[i]) - Exact) / (std::fabs(Exact) > 1e-6 ? std::fabs(Exact) : 1e-6);
+      MaxError = Error > MaxError ? Error : MaxError;
+    }
+    ReportMetric((std::string(Case.Name) + " max relative error").c_str(), MaxError, "relative");
+
+    Report(std::string(Case.Name) + " x4096", Measure(Iterations, [&]() {
+      float Sum = 0.0f;
+      for (int i = 0; i < Count; ++i) Sum += Case.Function(Inputs[i]);
+      GSink = GSink + static_cast<size_t>(Sum * 1000.0f);
+    }));
+    Report(std::string(Case.StdName) + " x4096", Measure(Iterations, [&]() {
+      float Sum = 0.0f;
+      for (int i = 0; i < Count; ++i) Sum += Case.Reference(Inputs[i]);
+      GSink = GSink + static_cast<size_t>(Sum * 1000.0f);
+    }));
+  }
+}
+
+/**
+ * @brief Operaciones bsicas de Vector2, Vector3 y Vector4 sobre 4096 elementos.
+ */
+void BenchVectorOps()
+{
+  using namespace EngineUtilities;
+  const int Count = 4096;
+  const int Iterations = 2000;
+  std::vector<Vector2> A2(Count), B2(Count);
+  std::vector<Vector3> A3(Count), B3(Count);
+  std::vector<Vector4> A4(Count), B4(Count);
+  for (int i = 0; i < Count; ++i)
+  {
+    float X = static_cast<float>(i % 17) - 8.0f;
+    float Y = static_cast<float>(i % 5) + 1.0f;
+    float Z = static_cast<float>(i % 11) * 0.5f;
+    A2[i] = Vector2(X, Y);
+    B2[i] = Vector2(Z, X);
+    A3[i] = Vector3(X, Y, Z);
+    B3[i] = Vector3(Z, X, Y);
+    A4[i] = Vector4(X, Y, Z, 1.0f);
+    B4[i] = Vector4(Z, X, Y, 0.0f);
+  }
+
+  Report("Vector2 a + b * 0.5 x4096", Measure(Iterations, [&]() {
+    Vector2 Sum;
+    for (int i = 0; i < Count; ++i) Sum = Sum + (A2[i] + B2[i] * 0.5f);
+    GSink = GSink + static_cast<size_t>(Sum.x);
+  }));
+  Report("Vector2::normalize x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += A2[i].normalize().x;
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("Vector3 a + b * 0.5 x4096", Measure(Iterations, [&]() {
+    Vector3 Sum;
+    for (int i = 0; i < Count; ++i) Sum = Sum + (A3[i] + B3[i] * 0.5f);
+    GSink = GSink + static_cast<size_t>(Sum.x);
+  }));
+  Report("Vector3::magnitude x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += A3[i].magnitude();
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("Vector4 a + b * 0.5 x4096", Measure(Iterations, [&]() {
+    Vector4 Sum;
+    for (int i = 0; i < Count; ++i) Sum = Sum + (A4[i] + B4[i] * 0.5f);
+    GSink = GSink + static_cast<size_t>(Sum.x);
+  }));
+  Report("Vector4::dot x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += A4[i].dot(B4[i]);
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("Vector4::normalize x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += A4[i].normalize().x;
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+}
+
+/**
+ * @brief Producto, normalizacin, rotacin de vectores y construccin desde eje y ngulo de Quaternion.
+ */
+void BenchQuaternion()
+{
+  using namespace EngineUtilities;
+  const int Count = 4096;
+  const int Iterations = 1000;
+  std::vector<Quaternion> Rotations(Count);
+  std::vector<Vector3> Points(Count);
+  for (int i = 0; i < Count; ++i)
+  {
+    Rotations[i] = Quaternion::fromAxisAngle(Vector3(0.0f, 1.0f, 0.0f), static_cast<float>(i) * 0.001f);
+    Points[i] = Vector3(static_cast<float>(i % 17), 1.0f, static_cast<float>(i % 11));
+  }
+
+  Report("Quaternion::operator* x4096", Measure(Iterations, [&]() {
+    Quaternion Product;
+    for (int i = 0; i < Count; ++i) Product = Product * Rotations[i];
+    GSink = GSink + static_cast<size_t>(Product.w * 100.0f);
+  }));
+  Report("Quaternion::normalize x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += (Rotations[i] * 2.0f).normalize().w;
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("Quaternion::rotate x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += Rotations[i].rotate(Points[i]).x;
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("Quaternion::fromAxisAngle x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += Quaternion::fromAxisAngle(Vector3(1.0f, 0.0f, 0.0f), static_cast<float>(i) * 0.01f).x;
+    GSink = GSink + static_cast<size_t>(Sum * 100.0f);
+  }));
+}
+
+/**
+ * @brief Producto 4x4 escalar equivalente al operator* original (64 multiplicaciones y sumas).
+ */
+EngineUtilities::Matrix4x4 ScalarMultiply(const EngineUtilities::Matrix4x4& A, const EngineUtilities::Matrix4x4& B)
+{
+  EngineUtilities::Matrix4x4 R;
+  for (int i = 0; i < 4; ++i)
+  {
+    for (int j = 0; j < 4; ++j)
+    {
+      R.m[i][j] = A.m[i][0] * B.m[0][j] + A.m[i][1] * B.m[1][j] + A.m[i][2] * B.m[2][j] + A.m[i][3] * B.m[3][j];
+    }
+  }
+  return R;
+}
+
+/**
+ * @brief Producto de lotes de matrices 4x4: escalar, operator* (SSE) y MultiplyMany (SSE y AVX2).
+ */
+void BenchMatrixMultiply()
+{
+  const size_t Count = 4096;
+  const int Iterations = 200;
+  std::vector<EngineUtilities::Matrix4x4> A(Count), B(Count), Out(Count);
+  for (size_t i = 0; i < Count; ++i)
+  {
+    for (int r = 0; r < 4; ++r)
+    {
+      for (int c = 0; c < 4; ++c)
+      {
+        A[i].m[r][c] = static_cast<float>((i + r * 4 + c) % 7) * 0.25f;
+        B[i].m[r][c] = static_cast<float>((i * 3 + r + c) % 5) * 0.5f;
+      }
+    }
+  }
+
+  auto Consume = [&]() { GSink = GSink + static_cast<size_t>(Out[Count / 2].m[1][2]); };
+
+  Report("Matrix4x4 scalar multiply x4096", Measure(Iterations, [&]() {
+    for (size_t i = 0; i < Count; ++i) Out[i] = ScalarMultiply(A[i], B[i]);
+    Consume();
+  }));
+  Report("Matrix4x4::operator* x4096", Measure(Iterations, [&]() {
+    for (size_t i = 0; i < Count; ++i) Out[i] = A[i] * B[i];
+    Consume();
+  }));
+  Report("multiplyManyMatrix4x4Generic x4096", Measure(Iterations, [&]() {
+    EngineUtilities::multiplyManyMatrix4x4Generic(&A[0].m[0][0], &B[0].m[0][0], &Out[0].m[0][0], Count);
+    Consume();
+  }));
+#if ENGINEUTILITIES_MATRIX_AVX2
+  if (EngineUtilities::cpuFeatures().avx2 && EngineUtilities::cpuFeatures().fma)
+  {
+    Report("multiplyManyMatrix4x4AVX2 x4096", Measure(Iterations, [&]() {
+      EngineUtilities::multiplyManyMatrix4x4AVX2(&A[0].m[0][0], &B[0].m[0][0], &Out[0].m[0][0], Count);
+      Consume();
+    }));
+  }
+#endif
+  Report("Matrix4x4::MultiplyMany x4096", Measure(Iterations, [&]() {
+    EngineUtilities::Matrix4x4::MultiplyMany(A.data(), B.data(), Out.data(), Count);
+    Consume();
+  }));
+}
+
+/**
+ * @brief Coste de la inversa general (SIMD) frente a InverseAffine e InverseOrthonormal.
+ */
+void BenchMatrixInverse()
+{
+  const size_t Count = 4096;
+  const int Iterations = 200;
+  std::vector<EngineUtilities::Matrix4x4> Transforms(Count), Out(Count);
+  for (size_t i = 0; i < Count; ++i)
+  {
+    float Angle = static_cast<float>(i) * 0.01f;
+    Transforms[i] = EngineUtilities::Matrix4x4::rotationX(Angle) * EngineUtilities::Matrix4x4::rotationY(Angle * 0.5f);
+    Transforms[i].m[0][3] = static_cast<float>(i);
+    Transforms[i].m[1][3] = 2.0f;
+    Transforms[i].m[2][3] = -1.0f;
+  }
+
+  auto Consume = [&]() { GSink = GSink + static_cast<size_t>(Out[Count / 2].m[0][3]); };
+
+  Report("Matrix4x4::inverse x4096", Measure(Iterations, [&]() {
+    for (size_t i = 0; i < Count; ++i) Out[i] = Transforms[i].inverse();
+    Consume();
+  }));
+  Report("Matrix4x4::InverseAffine x4096", Measure(Iterations, [&]() {
+    for (size_t i = 0; i < Count; ++i) Out[i] = Transforms[i].InverseAffine();
+    Consume();
+  }));
+  Report("Matrix4x4::InverseOrthonormal x4096", Measure(Iterations, [&]() {
+    for (size_t i = 0; i < Count; ++i) Out[i] = Transforms[i].InverseOrthonormal();
+    Consume();
+  }));
+}
+
+/**
+ * @brief Producto e inversa de Matrix2x2 y Matrix3x3.
+ */
+void BenchSmallMatrix()
+{
+  using namespace EngineUtilities;
+  const int Count = 4096;
+  const int Iterations = 500;
+  std::vector<Matrix2x2> A2(Count);
+  std::vector<Matrix3x3> A3(Count);
+  for (int i = 0; i < Count; ++i)
+  {
+    float V = static_cast<float>(i % 13) * 0.25f;
+    A2[i] = Matrix2x2(2.0f + V, 1.0f, -1.0f, 3.0f - V);
+    A3[i] = Matrix3x3(2.0f + V, 1.0f, 0.0f, -1.0f, 3.0f, V, 0.5f, 0.0f, 4.0f - V);
+  }
+
+  Report("Matrix2x2::operator* x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += (A2[i] * A2[Count - 1 - i]).m[1][0];
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("Matrix2x2::inverse x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += A2[i].inverse().determinant();
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("Matrix3x3::operator* x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += (A3[i] * A3[Count - 1 - i]).m[2][1];
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+  Report("Matrix3x3::inverse x4096", Measure(Iterations, [&]() {
+    float Sum = 0.0f;
+    for (int i = 0; i < Count; ++i) Sum += A3[i].inverse().determinant();
+    GSink = GSink + static_cast<size_t>(Sum);
+  }));
+}
+
+/**
+ * @brief Operaciones en bloque sobre 64k vectores: TArray<Vector3> (AoS) frente a TVector3Stream (SoA).
+ */
+void BenchVector3Stream()
+{
+  const size_t Count = 65536;
+  const int Iterations = 100;
+  EngineUtilities::TArray<EngineUtilities::Vector3> Vectors;
+  for (size_t i = 0; i < Count; ++i)
+  {
+    Vectors.Emplace(static_cast<float>(i % 17) - 8.0f, static_cast<float>(i % 5) + 1.0f, static_cast<float>(i % 11) * 0.5f);
+  }
+  EngineUtilities::TVector3Stream Stream(Vectors);
+  EngineUtilities::TVector3Stream Out;
+  EngineUtilities::TArray<EngineUtilities::Vector3> AoSOut(Vectors);
+  EngineUtilities::Matrix4x4 Transform = EngineUtilities::Matrix4x4::rotationY(0.7f);
+  Transform.m[0][3] = 10.0f;
+
+  std::cout << "TVector3Stream kernels: " << EngineUtilities::selectVector3StreamKernels().name << std::endl;
+  Report("Vector3::normalize AoS x64k", Measure(Iterations, [&]() {
+    for (size_t i = 0; i < Count; ++i) AoSOut[i] = Vectors[i].normalize();
+    GSink = GSink + static_cast<size_t>(AoSOut[Count / 2].y * 100.0f);
+  }));
+  Report("TVector3Stream::Normalize x64k", Measure(Iterations, [&]() {
+    EngineUtilities::TVector3Stream::Normalize(Stream, Out);
+    GSink = GSink + static_cast<size_t>(Out.GetY()[Count / 2] * 100.0f);
+  }));
+  Report("Matrix4x4 * point AoS x64k", Measure(Iterations, [&]() {
+    for (size_t i = 0; i < Count; ++i)
+    {
+      const EngineUtilities::Vector3& V = Vectors[i];
+      AoSOut[i] = EngineUtilities::Vector3(
+        Transform.m[0][0] * V.x + Transform.m[0][1] * V.y + Transform.m[0][2] * V.z + Transform.m[0][3],
+        Transform.m[1][0] * V.x + Transform.m[1][1] * V.y + Transform.m[1][2] * V.z + Transform.m[1][3],
+        Transform.m[2][0] * V.x + Transform.m[2][1] * V.y + Transform.m[2][2] * V.z + Transform.m[2][3]);
+    }
+    GSink = GSink + static_cast<size_t>(AoSOut[Count / 2].x);
+  }));
+  Report("TVector3Stream::Transform x64k", Measure(Iterations, [&]() {
+    EngineUtilities::TVector3Stream::Transform(Transform, Stream, Out);
+    GSink = GSink + static_cast<size_t>(Out.GetX()[Count / 2]);
+  }));
+  std::vector<float> Lengths(Count);
+  Report("TVector3Stream::Length x64k", Measure(Iterations, [&]() {
+    EngineUtilities::TVector3Stream::Length(Stream, Lengths.data());
+    GSink = GSink + static_cast<size_t>(Lengths[Count / 2]);
+  }));
+}
+
+/**
+ * @brief Escalado de ParallelFor y ParallelReduce de 1 a N hilos normalizando 1M de Vector3.
+ *
+ * Cada medicin usa su propio FJobSystem con Threads - 1 trabajadores, ya que el hilo que
+ * espera tambin ejecuta trabajos.
+ */
+void BenchParallelFor()
+{
+  using namespace EngineUtilities;
+  const size_t Count = 1 << 20;
+  const int Iterations = 20;
+  TArray<Vector3> Vectors;
+  for (size_t i = 0; i < Count; ++i)
+  {
+    Vectors.Emplace(static_cast<float>(i % 17) - 8.0f, static_cast<float>(i % 5) + 1.0f, static_cast<float>(i % 11) * 0.5f);
+  }
+  TArray<Vector3> Work(Vectors);
+
+  size_t MaxThreads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+  double SerialNs = 0.0;
+  // 1, 2, 4, ... y por ltimo MaxThreads.
+  for (size_t Threads = 1; ; Threads = Threads * 2 < MaxThreads ? Threads * 2 : MaxThreads)
+  {
+    FJobSystem System(Threads - 1);
+    FMeasurement NormalizeTime = Measure(Iterations, [&]() {
+      ParallelFor(Work, [](Vector3& V) { V = (V * 3.0f).normalize(); }, 1024, System);
+      GSink = GSink + static_cast<size_t>(Work[Count / 2].y * 100.0f);
+    });
+    FMeasurement ReduceTime = Measure(Iterations, [&]() {
+      float Total = ParallelReduce(Vectors, 0.0f,
+        [](float Partial, const Vector3& V) { return Partial + V.magnitude(); },
+        [](float Left, float Right) { return Left + Right; }, 1024, System);
+      GSink = GSink + static_cast<size_t>(Total);
+    });
+    if (Threads == 1)
+    {
+      SerialNs = NormalizeTime.RealNs;
+    }
+    std::string Suffix = "/threads:" + std::to_string(Threads);
+    Report("ParallelFor normalize x1M" + Suffix, NormalizeTime);
+    ReportMetric(("ParallelFor normalize x1M speedup" + Suffix).c_str(), SerialNs / NormalizeTime.RealNs, "x");
+    Report("ParallelReduce length x1M" + Suffix, ReduceTime);
+    if (Threads == MaxThreads)
+    {
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Ordenacin de claves de dibujado de 64 bits: std::sort frente a Sort, RadixSort y
+ *        sus variantes paralelas. Cada iteracin copia primero las claves desordenadas.
+ */
+void BenchSort()
+{
+  using namespace EngineUtilities;
+  const int Iterations = 10;
+  size_t MaxThreads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+  FJobSystem System(MaxThreads - 1);
+  std::string ThreadSuffix = "/threads:" + std::to_string(MaxThreads);
+
+  for (size_t Count : { size_t(200000), size_t(1000000) })
+  {
+    TArray<uint64_t> Keys;
+    Keys.Reserve(Count);
+    uint64_t State = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < Count; ++i)
+    {
+      // xorshift64*: claves repartidas por los 64 bits, como las de dibujado.
+      State ^= State >> 12;
+      State ^= State << 25;
+      State ^= State >> 27;
+      Keys.Add(State * 0x2545F4914F6CDD1Dull);
+    }
+    TArray<uint64_t> Work(Keys);
+    std::string Suffix = " x" + std::to_string(Count / 1000) + "k";
+    auto Reset = [&]() {
+      std::copy(Keys.begin(), Keys.end(), Work.begin());
+    };
+
+    Report("copy keys" + Suffix, Measure(Iterations, [&]() {
+      Reset();
+      GSink = GSink + static_cast<size_t>(Work[Count / 2]);
+    }));
+    // Cada variante se mide y despus, fuera del bucle medido, se comprueba que orden las claves.
+    auto Run = [&](const std::string& Name, auto SortKeys) {
+      Report(Name, Measure(Iterations, [&]() {
+        Reset();
+        SortKeys();
+        GSink = GSink + static_cast<size_t>(Work[Count / 2]);
+      }));
+      if (!std::is_sorted(Work.begin(), Work.end()))
+      {
+        std::cerr << Name << " left the keys unsorted" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    };
+    Run("std::sort uint64" + Suffix, [&]() { std::sort(Work.begin(), Work.end()); });
+    Run("Sort uint64" + Suffix, [&]() { Sort(Work); });
+    Run("RadixSort uint64" + Suffix, [&]() { RadixSort(Work); });
+    Run("ParallelSort uint64" + Suffix + ThreadSuffix, [&]() { ParallelSort(Work, TLess<uint64_t>(), System); });
+    Run("ParallelRadixSort uint64" + Suffix + ThreadSuffix, [&]() { ParallelRadixSort(Work, TIdentityKey<uint64_t>(), System); });
+  }
+}
+
+/**
+ * @brief Escapa una cadena para incluirla en JSON.
+ */
+std::string JsonEscape(const std::string& Text)
+{
+  std::string Escaped;
+  for (char C : Text)
+  {
+    if (C == '"' || C == '\\')
+    {
+      Escaped += '\\';
+      Escaped += C;
+    }
+    else if (static_cast<unsigned char>(C) < 0x20)
+    {
+      char Code[8];
+      std::snprintf(Code, sizeof(Code), "\\u%04x", static_cast<unsigned>(C));
+      Escaped += Code;
+    }
+    else
+    {
+      Escaped += C;
+    }
+  }
+  return Escaped;
+}
+
+/**
+ * @brief Escribe GResults en el formato JSON de Google Benchmark para poder seguir regresiones
+ *        con sus herramientas (compare.py). Las mtricas que no son tiempos van en "metrics".
+ *
+ * @return false si no se pudo abrir el fichero.
+ */
+bool WriteJson(const std::string& Path, const char* Executable)
+{
+  std::ofstream Out(Path);
+  if (!Out)
+  {
+    return false;
+  }
+  char Date[32];
+  std::time_t Now = std::time(nullptr);
+  std::strftime(Date, sizeof(Date), "%Y-%m-%dT%H:%M:%S", std::localtime(&Now));
+  const EngineUtilities::CPUFeatures& Features = EngineUtilities::cpuFeatures();
+  std::string FeatureList = std::string(Features.sse41 ? " sse41" : "") + (Features.avx ? " avx" : "") +
+    (Features.avx2 ? " avx2" : "") + (Features.fma ? " fma" : "") + (Features.avx512f ? " avx512f" : "");
+
+  Out.precision(10);
+  Out << "{\n  \"context\": {\n";
+  Out << "    \"date\": \"" << Date << "\",\n";
+  Out << "    \"executable\": \"" << JsonEscape(Executable) << "\",\n";
+  Out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+  Out << "    \"cpu_features\": \"" << (FeatureList.empty() ? "" : FeatureList.substr(1)) << "\",\n";
+#ifdef NDEBUG
+  Out << "    \"library_build_type\": \"release\"\n";
+#else
+  Out << "    \"library_build_type\": \"debug\"\n";
+#endif
+  Out << "  },\n  \"benchmarks\": [";
+  bool bFirst = true;
+  for (const FBenchmarkResult& Result : GResults)
+  {
+    if (Result.bIsMetric)
+    {
+      continue;
+    }
+    Out << (bFirst ? "\n" : ",\n");
+    bFirst = false;
+    Out << "    {\"name\": \"" << JsonEscape(Result.Name) << "\", \"run_name\": \"" << JsonEscape(Result.Name)
+      << "\", \"run_type\": \"iteration\", \"iterations\": " << Result.Measurement.Iterations
+      << ", \"real_time\": " << Result.Measurement.RealNs << ", \"cpu_time\": " << Result.Measurement.CpuNs
+      << ", \"time_unit\": \"ns\"}";
+  }
+  Out << "\n  ],\n  \"metrics\": [";
+  bFirst = true;
+  for (const FBenchmarkResult& Result : GResults)
+  {
+    if (!Result.bIsMetric)
+    {
+      continue;
+    }
+    Out << (bFirst ? "\n" : ",\n");
+    bFirst = false;
+    Out << "    {\"name\": \"" << JsonEscape(Result.Name) << "\", \"value\": " << Result.Value
+      << ", \"unit\": \"" << JsonEscape(Result.Unit) << "\"}";
+  }
+  Out << "\n  ]\n}\n";
+  return static_cast<bool>(Out);
+}
+
+/**
+ * @brief Seccin del benchmark que se puede seleccionar con --benchmark_filter.
+ */
+struct FBenchmarkSection
+{
+  const char* Name;
+  void (*Run)();
+};
+
+/**
+ * @brief Ejecuta las secciones seleccionadas.
+ *
+ * --benchmark_filter=<regex> elige las secciones por nombre, --benchmark_out=<fichero> escribe
+ * los resultados en JSON y --benchmark_list muestra las secciones disponibles.
+ */
+int main(int argc, char** argv)
+{
+  const FBenchmarkSection Sections[] = {
+    { "ArrayGrowth", BenchArrayGrowth },
+    { "ArrayRemoveAt", BenchArrayRemoveAt },
+    { "ArrayAccess", BenchArrayAccess },
+    { "InlineArray", BenchInlineArray },
+    { "MapLookup", BenchMapLookup },
+    { "SortedMap", BenchSortedMap },
+    { "SharedPointerContention", BenchSharedPointerContention },
+    { "ConcurrentMap", BenchConcurrentMap },
+    { "MakeShared", BenchMakeShared },
+    { "SmartPointerCopy", BenchSmartPointerCopy },
+    { "LinearArena", BenchLinearArena },
+    { "ObjectPool", BenchObjectPool },
+    { "HandlePool", BenchHandlePool },
+    { "Sqrt", BenchSqrt },
+    { "SinCos", BenchSinCos },
+    { "Transcendentals", BenchTranscendentals },
+    { "VectorOps", BenchVectorOps },
+    { "Quaternion", BenchQuaternion },
+    { "MatrixMultiply", BenchMatrixMultiply },
+    { "MatrixInverse", BenchMatrixInverse },
+    { "SmallMatrix", BenchSmallMatrix },
+    { "Vector3Stream", BenchVector3Stream },
+    { "ParallelFor", BenchParallelFor },
+    { "Sort", BenchSort },
+  };
+
+  std::string Filter = ".*";
+  std::string OutPath;
+  bool bList = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string Argument = argv[i];
+    if (Argument.compare(0, 19, "--benchmark_filter=") == 0)
+    {
+      Filter = Argument.substr(19);
+    }
+    else if (Argument.compare(0, 16, "--benchmark_out=") == 0)
+    {
+      OutPath = Argument.substr(16);
+    }
+    else if (Argument == "--benchmark_list")
+    {
+      bList = true;
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [--benchmark_filter=<regex>] [--benchmark_out=<file.json>] [--benchmark_list]" << std::endl;
+      return 1;
+    }
+  }
+
+  std::regex Pattern;
+  try
+  {
+    Pattern = std::regex(Filter);
+  }
+  catch (const std::regex_error&)
+  {
+    std::cerr << "Invalid --benchmark_filter: " << Filter << std::endl;
+    return 1;
+  }
+
+  for (const FBenchmarkSection& Section : Sections)
+  {
+    if (!std::regex_search(Section.Name, Pattern))
+    {
+      continue;
+    }
+    if (bList)
+    {
+      std::cout << Section.Name << std::endl;
+      continue;
+    }
+    std::cout << "== " << Section.Name << " ==" << std::endl;
+    Section.Run();
+  }
+
+  if (!OutPath.empty() && !WriteJson(OutPath, argv[0]))
+  {
+    std::cerr << "Could not write " << OutPath << std::endl;
+    return 1;
+  }
+  return 0;
+}
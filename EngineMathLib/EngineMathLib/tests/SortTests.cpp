@@ -0,0 +1,202 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Structures/Sort.h"
+#include "Structures/TArray.h"
+#include "Threading/ParallelSort.h"
+
+namespace
+{
+  int Failures = 0;
+
+  void Expect(bool bCondition, const std::string& Message)
+  {
+    if (!bCondition)
+    {
+      std::cerr << "FAILED: " << Message << std::endl;
+      ++Failures;
+    }
+  }
+
+  // Tamaos alrededor del umbral de MinParallelCount (16384) y uno grande que no es potencia de dos.
+  const size_t Sizes[] = { 0, 1, 63, 64, 1000, 16383, 16384, 16385, 1000003 };
+
+  template<typename T>
+  EngineUtilities::TArray<T> ToArray(const std::vector<T>& Values)
+  {
+    EngineUtilities::TArray<T> Array;
+    Array.Reserve(Values.size());
+    for (const T& Value : Values)
+    {
+      Array.Add(Value);
+    }
+    return Array;
+  }
+
+  template<typename T>
+  bool SameAs(const EngineUtilities::TArray<T>& Array, const std::vector<T>& Expected)
+  {
+    return Array.Num() == Expected.size() && std::equal(Array.begin(), Array.end(), Expected.begin());
+  }
+
+  /**
+   * @brief Ordena Values con Sort y ParallelSort (y con RadixSort y ParallelRadixSort si
+   *        bRadix) y compara cada resultado con std::sort.
+   */
+  template<typename T, bool bRadix>
+  void CheckAllSorts(const std::string& Name, const std::vector<T>& Values, EngineUtilities::FJobSystem& System)
+  {
+    std::vector<T> Expected(Values);
+    std::sort(Expected.begin(), Expected.end());
+    const std::string Suffix = " " + Name + " x" + std::to_string(Values.size());
+
+    EngineUtilities::TArray<T> Work = ToArray(Values);
+    EngineUtilities::Sort(Work);
+    Expect(SameAs(Work, Expected), "Sort" + Suffix);
+
+    Work = ToArray(Values);
+    EngineUtilities::ParallelSort(Work, EngineUtilities::TLess<T>(), System);
+    Expect(SameAs(Work, Expected), "ParallelSort" + Suffix);
+
+    if constexpr (bRadix)
+    {
+      Work = ToArray(Values);
+      EngineUtilities::RadixSort(Work);
+      Expect(SameAs(Work, Expected), "RadixSort" + Suffix);
+
+      Work = ToArray(Values);
+      EngineUtilities::ParallelRadixSort(Work, EngineUtilities::TIdentityKey<T>(), System);
+      Expect(SameAs(Work, Expected), "ParallelRadixSort" + Suffix);
+    }
+  }
+
+  struct FKeyedItem
+  {
+    int32_t Key;
+    uint32_t Index;
+
+    bool operator==(const FKeyedItem& Other) const
+    {
+      return Key == Other.Key && Index == Other.Index;
+    }
+  };
+
+  struct FItemKey
+  {
+    int32_t operator()(const FKeyedItem& Item) const
+    {
+      return Item.Key;
+    }
+  };
+
+  /**
+   * @brief RadixSort y ParallelRadixSort son estables: comparar con std::stable_sort por clave.
+   */
+  void CheckRadixStability(size_t Count, EngineUtilities::FJobSystem& System)
+  {
+    std::mt19937 Random(static_cast<unsigned>(Count));
+    std::uniform_int_distribution<int32_t> KeyDistribution(-8, 7);
+    std::vector<FKeyedItem> Values(Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+      Values[i] = FKeyedItem{ KeyDistribution(Random), static_cast<uint32_t>(i) };
+    }
+    std::vector<FKeyedItem> Expected(Values);
+    std::stable_sort(Expected.begin(), Expected.end(), [](const FKeyedItem& A, const FKeyedItem& B) { return A.Key < B.Key; });
+    const std::string Suffix = " keyed items x" + std::to_string(Count);
+
+    EngineUtilities::TArray<FKeyedItem> Work = ToArray(Values);
+    EngineUtilities::RadixSort(Work, FItemKey());
+    Expect(SameAs(Work, Expected), "RadixSort is not stable for" + Suffix);
+
+    Work = ToArray(Values);
+    EngineUtilities::ParallelRadixSort(Work, FItemKey(), System);
+    Expect(SameAs(Work, Expected), "ParallelRadixSort is not stable for" + Suffix);
+  }
+}
+
+int main()
+{
+  // Tres trabajadores explcitos: las rutas paralelas se ejecutan aunque la mquina tenga un solo ncleo.
+  EngineUtilities::FJobSystem System(3);
+  std::mt19937_64 Random(1234);
+
+  for (size_t Count : Sizes)
+  {
+    std::vector<uint64_t> Unsigned(Count);
+    std::vector<int32_t> Signed(Count);
+    std::vector<int32_t> Duplicates(Count);
+    std::vector<float> Floats(Count);
+    std::uniform_int_distribution<int32_t> SignedDistribution(INT32_MIN, INT32_MAX);
+    std::uniform_int_distribution<int32_t> DuplicateDistribution(-4, 3);
+    std::uniform_real_distribution<float> FloatDistribution(-1.0e6f, 1.0e6f);
+    for (size_t i = 0; i < Count; ++i)
+    {
+      Unsigned[i] = Random();
+      Signed[i] = SignedDistribution(Random);
+      Duplicates[i] = DuplicateDistribution(Random);
+      Floats[i] = FloatDistribution(Random);
+    }
+    CheckAllSorts<uint64_t, true>("uint64", Unsigned, System);
+    CheckAllSorts<int32_t, true>("int32", Signed, System);
+    CheckAllSorts<int32_t, true>("duplicate int32", Duplicates, System);
+    CheckAllSorts<float, true>("float", Floats, System);
+    CheckRadixStability(Count, System);
+
+    // std::string no es trivialmente reubicable: cubre las mezclas que mueven con constructores.
+    if (Count <= 100000)
+    {
+      std::vector<std::string> Strings(Count);
+      std::uniform_int_distribution<int> LetterDistribution('a', 'd');
+      for (std::string& Text : Strings)
+      {
+        // Ms de 15 caracteres para salir del bfer pequeo de std::string.
+        for (int Letter = 0; Letter < 20; ++Letter)
+        {
+          Text.push_back(static_cast<char>(LetterDistribution(Random)));
+        }
+      }
+      CheckAllSorts<std::string, false>("string", Strings, System);
+    }
+  }
+
+  if (Failures != 0)
+  {
+    std::cerr << Failures << " check(s) failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "All sort checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
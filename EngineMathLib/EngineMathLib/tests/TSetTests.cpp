@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#include <cstdlib>
+#include <iostream>
+#include "Structures/TSet.h"
+
+namespace
+{
+  int Failures = 0;
+
+  void Expect(bool bCondition, const char* Message)
+  {
+    if (!bCondition)
+    {
+      std::cerr << "FAILED: " << Message << std::endl;
+      ++Failures;
+    }
+  }
+
+  EngineUtilities::TSet<int> MakeRange(int First, int Last)
+  {
+    EngineUtilities::TSet<int> Set;
+    for (int i = First; i < Last; ++i)
+    {
+      Set.Add(i);
+    }
+    return Set;
+  }
+
+  void UnionOfIdenticalSetsKeepsCapacity()
+  {
+    EngineUtilities::TSet<int> A = MakeRange(0, 1000);
+    const EngineUtilities::TSet<int> B = MakeRange(0, 1000);
+    const size_t Capacity = A.GetCapacity();
+
+    A.Union(B);
+
+    Expect(A.Num() == 1000, "Union of identical sets changed Num()");
+    Expect(A.GetCapacity() == Capacity, "Union of identical sets grew the table");
+  }
+
+  void UnionWithSubsetKeepsCapacity()
+  {
+    EngineUtilities::TSet<int> A = MakeRange(0, 1000);
+    const EngineUtilities::TSet<int> B = MakeRange(250, 750);
+    const size_t Capacity = A.GetCapacity();
+
+    A.Union(B);
+
+    Expect(A.Num() == 1000, "Union with a subset changed Num()");
+    Expect(A.GetCapacity() == Capacity, "Union with a subset grew the table");
+  }
+
+  void UnionWithSelfKeepsCapacity()
+  {
+    EngineUtilities::TSet<int> A = MakeRange(0, 1000);
+    const size_t Capacity = A.GetCapacity();
+
+    A.Union(A);
+
+    Expect(A.Num() == 1000, "Union with itself changed Num()");
+    Expect(A.GetCapacity() == Capacity, "Union with itself grew the table");
+  }
+
+  void UnionAddsMissingElements()
+  {
+    EngineUtilities::TSet<int> A = MakeRange(0, 1000);
+    const EngineUtilities::TSet<int> B = MakeRange(500, 1500);
+
+    A.Union(B);
+
+    Expect(A.Num() == 1500, "Union of overlapping sets has the wrong Num()");
+    Expect(A.Contains(0) && A.Contains(999) && A.Contains(1499), "Union lost elements");
+  }
+}
+
+int main()
+{
+  UnionOfIdenticalSetsKeepsCapacity();
+  UnionWithSubsetKeepsCapacity();
+  UnionWithSelfKeepsCapacity();
+  UnionAddsMissingElements();
+
+  if (Failures != 0)
+  {
+    std::cerr << Failures << " check(s) failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "All TSet checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}
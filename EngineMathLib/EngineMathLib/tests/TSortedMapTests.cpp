@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Roberto Charreton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * In addition, any project or software that uses this library or class must include
+ * the following acknowledgment in the credits:
+ *
+ * "This project uses software developed by Roberto Charreton and Attribute Overload."
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include "Structures/TSortedMap.h"
+
+namespace
+{
+  int Failures = 0;
+
+  void Expect(bool bCondition, const char* Message)
+  {
+    if (!bCondition)
+    {
+      std::cerr << "FAILED: " << Message << std::endl;
+      ++Failures;
+    }
+  }
+
+  template<EngineUtilities::ESortedMapLayout Layout>
+  bool SameContents(const EngineUtilities::TSortedMap<int, int, Layout>& A, const EngineUtilities::TSortedMap<int, int, Layout>& B)
+  {
+    if (A.Num() != B.Num())
+    {
+      return false;
+    }
+    for (const auto& Pair : A)
+    {
+      const int* Value = B.Find(Pair.Key);
+      if (Value == nullptr || *Value != Pair.Value)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template<EngineUtilities::ESortedMapLayout Layout>
+  void BuildFromKeepsLastDuplicate()
+  {
+    EngineUtilities::TArray<EngineUtilities::TPair<int, int>> Pairs;
+    Pairs.Emplace(1, 10);
+    Pairs.Emplace(1, 20);
+    EngineUtilities::TSortedMap<int, int, Layout> Map;
+    Map.BuildFrom(std::move(Pairs));
+
+    Expect(Map.Num() == 1, "BuildFrom kept more than one pair per key");
+    Expect(Map.Find(1) != nullptr && *Map.Find(1) == 20, "BuildFrom did not keep the last duplicate");
+  }
+
+  template<EngineUtilities::ESortedMapLayout Layout>
+  void BuildFromMatchesRepeatedAdd()
+  {
+    std::mt19937 Random(42);
+    std::uniform_int_distribution<int> KeyDistribution(0, 999);
+    EngineUtilities::TArray<EngineUtilities::TPair<int, int>> Pairs;
+    EngineUtilities::TSortedMap<int, int, Layout> Added;
+    for (int i = 0; i < 100000; ++i)
+    {
+      int Key = KeyDistribution(Random);
+      Pairs.Emplace(Key, i);
+      Added.Add(Key, i);
+    }
+    EngineUtilities::TSortedMap<int, int, Layout> Built;
+    Built.BuildFrom(std::move(Pairs));
+
+    Expect(SameContents(Built, Added), "BuildFrom and repeated Add disagree");
+  }
+}
+
+int main()
+{
+  BuildFromKeepsLastDuplicate<EngineUtilities::ESortedMapLayout::Sorted>();
+  BuildFromKeepsLastDuplicate<EngineUtilities::ESortedMapLayout::Eytzinger>();
+  BuildFromMatchesRepeatedAdd<EngineUtilities::ESortedMapLayout::Sorted>();
+  BuildFromMatchesRepeatedAdd<EngineUtilities::ESortedMapLayout::Eytzinger>();
+
+  if (Failures != 0)
+  {
+    std::cerr << Failures << " check(s) failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "All TSortedMap checks passed" << std::endl;
+  return EXIT_SUCCESS;
+}